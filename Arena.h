@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// 简单的块式内存池：按块申请，块内顺序分配，只能整体释放。
+// 适合大量生命周期一致的小对象（如解码出的字符串），避免逐个 new/delete。
+class Arena
+{
+public:
+    explicit Arena(std::size_t block_size = 64 * 1024) : m_block_size(block_size) {}
+
+    Arena(const Arena&) = delete;
+    Arena &operator=(const Arena&) = delete;
+    Arena(Arena&&) = default;
+    Arena &operator=(Arena&&) = default;
+
+    char *Allocate(std::size_t size, std::size_t align = alignof(std::max_align_t))
+    {
+        std::size_t pos = (m_used + align - 1) & ~(align - 1);
+        if (m_current == nullptr || pos + size > m_current_size)
+        {
+            this->NextBlock(size + align);
+            pos = (m_used + align - 1) & ~(align - 1);
+        }
+        m_used = pos + size;
+        return m_current + pos;
+    }
+
+    // 拷贝一份字符串，末尾补 '\0'
+    std::string_view Store(std::string_view s)
+    {
+        char *p = this->Allocate(s.size() + 1, 1);
+        memcpy(p, s.data(), s.size());
+        p[s.size()] = '\0';
+        return std::string_view(p, s.size());
+    }
+
+    // 释放所有分配，保留已申请的块供之后复用
+    void Reset()
+    {
+        m_next_block = 0;
+        m_current = nullptr;
+        m_current_size = 0;
+        m_used = 0;
+    }
+
+    // 已申请的总字节数
+    std::size_t GetCapacity() const
+    {
+        std::size_t capacity = 0;
+        for (const Block &block : m_blocks) capacity += block.size;
+        return capacity;
+    }
+
+private:
+    struct Block
+    {
+        std::unique_ptr<char[]> data;
+        std::size_t size;
+    };
+
+    void NextBlock(std::size_t min_size)
+    {
+        // 优先复用 Reset 之前申请过的块
+        while (m_next_block < m_blocks.size() && m_blocks[m_next_block].size < min_size)
+        {
+            m_next_block++;
+        }
+        if (m_next_block == m_blocks.size())
+        {
+            std::size_t size = min_size > m_block_size ? min_size : m_block_size;
+            m_blocks.push_back(Block { std::unique_ptr<char[]>(new char[size]), size });
+        }
+
+        Block &block = m_blocks[m_next_block++];
+        m_current = block.data.get();
+        m_current_size = block.size;
+        m_used = 0;
+    }
+
+private:
+    std::size_t m_block_size;
+    std::vector<Block> m_blocks;
+    std::size_t m_next_block = 0;
+    char *m_current = nullptr;
+    std::size_t m_current_size = 0;
+    std::size_t m_used = 0;
+};
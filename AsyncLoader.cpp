@@ -0,0 +1,627 @@
+#include "AsyncLoader.h"
+#include "ELFReader.h"
+#include "ThreadPool.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+// 读请求的执行者：收下请求，等待完成
+class IoEngine
+{
+public:
+    virtual ~IoEngine() {}
+
+    virtual const char *GetName() const = 0;
+
+    // 同时在途的读请求上限
+    virtual unsigned GetDepth() const = 0;
+
+    // iov 由调用方提供，在请求完成前保持有效
+    virtual void Submit(void *tag, int fd, char *buf, std::size_t len, uint64_t offset, struct iovec *iov) = 0;
+
+    // 提交暂存的请求并等待至少一个完成，完成的（tag，读到的字节数或 -errno）追加到 done。
+    // 返回 false 表示引擎已不可用：所有在途请求都已以错误完成追加到 done，之后不能再向它提交
+    virtual bool Wait(std::vector<std::pair<void*, long>> &done) = 0;
+};
+
+namespace
+{
+    // 不依赖 liburing，直接用系统调用与共享内存环形队列
+    class UringEngine : public IoEngine
+    {
+    public:
+        ~UringEngine() override
+        {
+            if (m_sqes != nullptr) munmap(m_sqes, m_sqes_size);
+            if (m_cq_ring != nullptr && m_cq_ring != m_sq_ring) munmap(m_cq_ring, m_cq_ring_size);
+            if (m_sq_ring != nullptr) munmap(m_sq_ring, m_sq_ring_size);
+            if (m_fd >= 0) close(m_fd);
+        }
+
+        bool Init(unsigned entries)
+        {
+            struct io_uring_params params;
+            memset(&params, 0, sizeof(params));
+            m_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+            if (m_fd < 0)
+            {
+                return false;
+            }
+
+            m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+            m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+            const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single_mmap)
+            {
+                m_sq_ring_size = m_cq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size);
+            }
+
+            void *sq_ring = mmap(nullptr, m_sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+            if (sq_ring == MAP_FAILED)
+            {
+                return false;
+            }
+            m_sq_ring = static_cast<char*>(sq_ring);
+
+            if (single_mmap)
+            {
+                m_cq_ring = m_sq_ring;
+            }
+            else
+            {
+                void *cq_ring = mmap(nullptr, m_cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+                if (cq_ring == MAP_FAILED)
+                {
+                    return false;
+                }
+                m_cq_ring = static_cast<char*>(cq_ring);
+            }
+
+            m_sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+            void *sqes = mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+            if (sqes == MAP_FAILED)
+            {
+                return false;
+            }
+            m_sqes = static_cast<struct io_uring_sqe*>(sqes);
+
+            m_sq_tail = reinterpret_cast<unsigned*>(m_sq_ring + params.sq_off.tail);
+            m_sq_mask = *reinterpret_cast<unsigned*>(m_sq_ring + params.sq_off.ring_mask);
+            m_sq_array = reinterpret_cast<unsigned*>(m_sq_ring + params.sq_off.array);
+            m_cq_head = reinterpret_cast<unsigned*>(m_cq_ring + params.cq_off.head);
+            m_cq_tail = reinterpret_cast<unsigned*>(m_cq_ring + params.cq_off.tail);
+            m_cq_mask = *reinterpret_cast<unsigned*>(m_cq_ring + params.cq_off.ring_mask);
+            m_cqes = reinterpret_cast<struct io_uring_cqe*>(m_cq_ring + params.cq_off.cqes);
+            m_depth = params.sq_entries; // 完成队列至少是提交队列的两倍，在途请求不超过它就不会溢出
+            return true;
+        }
+
+        const char *GetName() const override { return "io_uring"; }
+        unsigned GetDepth() const override { return m_depth; }
+
+        void Submit(void *tag, int fd, char *buf, std::size_t len, uint64_t offset, struct iovec *iov) override
+        {
+            // READV 自 5.1 起可用，比 READ（5.6）兼容的内核更多
+            iov->iov_base = buf;
+            iov->iov_len = len;
+
+            unsigned tail = *m_sq_tail;
+            unsigned slot = tail & m_sq_mask;
+            struct io_uring_sqe *sqe = &m_sqes[slot];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = IORING_OP_READV;
+            sqe->fd = fd;
+            sqe->addr = reinterpret_cast<uint64_t>(iov);
+            sqe->len = 1;
+            sqe->off = offset;
+            sqe->user_data = reinterpret_cast<uint64_t>(tag);
+            m_sq_array[slot] = slot;
+            __atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+            m_to_submit++;
+            m_inflight.insert(tag);
+        }
+
+        bool Wait(std::vector<std::pair<void*, long>> &done) override
+        {
+            for (;;)
+            {
+                int ret = static_cast<int>(syscall(__NR_io_uring_enter, m_fd, m_to_submit, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+                if (ret >= 0)
+                {
+                    m_to_submit -= std::min<unsigned>(ret, m_to_submit);
+                }
+                else if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+                {
+                    // 环已不可用，收下已有的完成，其余在途请求都以该错误结束，由调用方改用其他引擎
+                    const long error = -errno;
+                    this->Reap(done);
+                    for (void *tag : m_inflight)
+                    {
+                        done.emplace_back(tag, error);
+                    }
+                    m_inflight.clear();
+                    return false;
+                }
+
+                if (this->Reap(done) > 0)
+                {
+                    return true;
+                }
+            }
+        }
+
+    private:
+        std::size_t Reap(std::vector<std::pair<void*, long>> &done)
+        {
+            std::size_t count = 0;
+            unsigned head = *m_cq_head;
+            unsigned tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+            for (; head != tail; head++, count++)
+            {
+                const struct io_uring_cqe &cqe = m_cqes[head & m_cq_mask];
+                done.emplace_back(reinterpret_cast<void*>(cqe.user_data), cqe.res);
+                m_inflight.erase(reinterpret_cast<void*>(cqe.user_data));
+            }
+            __atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+            return count;
+        }
+
+    private:
+        int m_fd = -1;
+        unsigned m_depth = 0;
+        unsigned m_to_submit = 0;
+        std::unordered_set<void*> m_inflight; // 已提交未完成的请求，环出错时据此逐个报错
+
+        char *m_sq_ring = nullptr;
+        char *m_cq_ring = nullptr;
+        std::size_t m_sq_ring_size = 0;
+        std::size_t m_cq_ring_size = 0;
+        struct io_uring_sqe *m_sqes = nullptr;
+        std::size_t m_sqes_size = 0;
+
+        unsigned *m_sq_tail = nullptr;
+        unsigned m_sq_mask = 0;
+        unsigned *m_sq_array = nullptr;
+        unsigned *m_cq_head = nullptr;
+        unsigned *m_cq_tail = nullptr;
+        unsigned m_cq_mask = 0;
+        struct io_uring_cqe *m_cqes = nullptr;
+    };
+
+    // 每个读请求交给线程池里的一个线程做 pread
+    class PreadEngine : public IoEngine
+    {
+    public:
+        explicit PreadEngine(int thread_num) : m_pool(thread_num) {}
+
+        const char *GetName() const override { return "pread"; }
+        unsigned GetDepth() const override { return static_cast<unsigned>(m_pool.GetThreadNum()) * 4; }
+
+        void Submit(void *tag, int fd, char *buf, std::size_t len, uint64_t offset, struct iovec*) override
+        {
+            m_pool.Submit([this, tag, fd, buf, len, offset](int)
+            {
+                ssize_t n = 0;
+                do
+                {
+                    n = pread(fd, buf, len, offset);
+                } while (n < 0 && errno == EINTR);
+                long result = n < 0 ? -errno : n;
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_done.emplace_back(tag, result);
+                m_cv.notify_one();
+            });
+        }
+
+        bool Wait(std::vector<std::pair<void*, long>> &done) override
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return !m_done.empty(); });
+            done.insert(done.end(), m_done.begin(), m_done.end());
+            m_done.clear();
+            return true;
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::vector<std::pair<void*, long>> m_done;
+        ThreadPool m_pool; // 最先析构，线程退出后才销毁上面的成员
+    };
+
+    const int PREAD_THREAD_NUM = 16;
+
+    // 间隔小于此值的两个段合并成一次读
+    const uint64_t MERGE_GAP = 4096;
+}
+
+struct AsyncLoader::Job
+{
+    enum Stage
+    {
+        STAGE_HEADER,           // ELF 头
+        STAGE_SECTION_TABLE,    // 段表与程序头表
+        STAGE_TABLES,           // 各表所在的段
+        STAGE_LINE_INFO,        // DWARF 行号相关的段
+    };
+
+    std::size_t index = 0;
+    std::string path;
+    int fd = -1;
+    char *image = nullptr;      // 与文件等大的匿名映射
+    std::size_t size = 0;
+    Stage stage = STAGE_HEADER;
+    std::size_t pending = 0;    // 本阶段未完成的读
+    std::vector<std::pair<uint64_t, uint64_t>> read_ranges; // STAGE_TABLES 读过的区间，已排序、不重叠
+    bool failed = false;
+};
+
+struct AsyncLoader::ReadOp
+{
+    Job *job = nullptr;
+    uint64_t offset = 0;
+    std::size_t len = 0;
+    struct iovec iov;
+};
+
+AsyncLoader::AsyncLoader(const Callback &on_loaded, bool read_line_info, unsigned queue_depth) :
+    m_on_loaded(on_loaded), m_read_line_info(read_line_info)
+{
+    const char *env = getenv("ELFREADER_IO");
+    if (env == nullptr || strcmp(env, "pread") != 0)
+    {
+        std::unique_ptr<UringEngine> engine(new UringEngine);
+        if (engine->Init(queue_depth))
+        {
+            m_engine = std::move(engine);
+        }
+    }
+    if (!m_engine)
+    {
+        m_engine.reset(new PreadEngine(PREAD_THREAD_NUM));
+    }
+
+    m_thread = std::thread(&AsyncLoader::IoLoop, this);
+}
+
+AsyncLoader::~AsyncLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+void AsyncLoader::Submit(std::size_t index, const std::string &path)
+{
+    std::unique_ptr<Job> job(new Job);
+    job->index = index;
+    job->path = path;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requests.push_back(std::move(job));
+    }
+    m_cv.notify_all();
+}
+
+const char *AsyncLoader::GetEngineName() const
+{
+    return m_engine->GetName();
+}
+
+void AsyncLoader::IoLoop()
+{
+    std::vector<std::pair<void*, long>> done;
+    for (;;)
+    {
+        std::deque<std::unique_ptr<Job>> requests;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            // 没有在途或待提交的读时才阻塞等待新文件；有时只取走已到的文件，马上去提交、等读完成
+            m_cv.wait(lock, [this] { return m_stop || !m_requests.empty() || m_inflight_op_num > 0 || !m_waiting_ops.empty(); });
+            if (m_stop && m_requests.empty() && m_inflight_op_num == 0 && m_waiting_ops.empty())
+            {
+                return;
+            }
+            requests.swap(m_requests);
+        }
+
+        for (std::unique_ptr<Job> &job : requests)
+        {
+            this->StartJob(job.release());
+        }
+
+        // 新文件的头部读取与其他文件后续阶段的读取一起提交
+        while (!m_waiting_ops.empty() && m_inflight_op_num < m_engine->GetDepth())
+        {
+            ReadOp *op = m_waiting_ops.front();
+            m_waiting_ops.pop_front();
+            m_engine->Submit(op, op->job->fd, op->job->image + op->offset, op->len, op->offset, &op->iov);
+            m_inflight_op_num++;
+        }
+
+        if (m_inflight_op_num == 0)
+        {
+            continue;
+        }
+
+        done.clear();
+        if (!m_engine->Wait(done))
+        {
+            // 在途的读都已以错误结束（对应文件由调用方同步读取），之后的读改用 pread
+            m_engine.reset(new PreadEngine(PREAD_THREAD_NUM));
+        }
+        for (const auto &item : done)
+        {
+            m_inflight_op_num--;
+            this->OnReadDone(static_cast<ReadOp*>(item.first), item.second);
+        }
+    }
+}
+
+void AsyncLoader::StartJob(Job *job)
+{
+    job->fd = open(job->path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (job->fd < 0 || fstat(job->fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size < static_cast<off_t>(sizeof(Elf64_Ehdr)))
+    {
+        this->Finish(job, false);
+        return;
+    }
+
+    // 只有实际读入的页面占用内存
+    job->size = st.st_size;
+    void *image = mmap(nullptr, job->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (image == MAP_FAILED)
+    {
+        this->Finish(job, false);
+        return;
+    }
+    job->image = static_cast<char*>(image);
+
+    this->QueueRead(job, 0, sizeof(Elf64_Ehdr));
+}
+
+void AsyncLoader::QueueRead(Job *job, uint64_t offset, std::size_t len)
+{
+    std::unique_ptr<ReadOp> op;
+    if (m_free_ops.empty())
+    {
+        op.reset(new ReadOp);
+    }
+    else
+    {
+        op = std::move(m_free_ops.back());
+        m_free_ops.pop_back();
+    }
+
+    op->job = job;
+    op->offset = offset;
+    op->len = len;
+    job->pending++;
+    m_waiting_ops.push_back(op.release());
+}
+
+void AsyncLoader::OnReadDone(ReadOp *op, long result)
+{
+    Job *job = op->job;
+
+    if (result == -EINTR || result == -EAGAIN)
+    {
+        m_waiting_ops.push_back(op);
+        return;
+    }
+    if (result > 0 && static_cast<std::size_t>(result) < op->len)
+    {
+        // 读了一部分，接着读剩下的
+        op->offset += result;
+        op->len -= result;
+        m_waiting_ops.push_back(op);
+        return;
+    }
+    if (result < 0 || (result == 0 && op->len > 0))
+    {
+        job->failed = true;
+    }
+
+    m_free_ops.emplace_back(op);
+    if (--job->pending == 0)
+    {
+        this->OnStageDone(job);
+    }
+}
+
+void AsyncLoader::OnStageDone(Job *job)
+{
+    if (job->failed)
+    {
+        this->Finish(job, false);
+        return;
+    }
+
+    switch (job->stage)
+    {
+    case Job::STAGE_HEADER:
+    {
+        // 只处理本机字节序的 ELF64，其余（ELF32、大端、紧凑映像等）交给调用方同步读取，由它解码或输出错误
+        Elf64_Ehdr header;
+        memcpy(&header, job->image, sizeof(header));
+        const uint64_t table_size = static_cast<uint64_t>(header.e_shnum) * sizeof(Elf64_Shdr);
+        if (memcmp(header.e_ident, ELFMAG, SELFMAG) != 0 || header.e_ident[EI_CLASS] != ELFCLASS64 ||
+            header.e_ident[EI_DATA] != ELFDATA2LSB ||
+            (header.e_shnum != 0 && header.e_shentsize != sizeof(Elf64_Shdr)) ||
+            header.e_shoff > job->size || table_size > job->size - header.e_shoff)
+        {
+            this->Finish(job, false);
+            return;
+        }
+
+        // 程序头表与段表同一步读取
+        job->stage = Job::STAGE_SECTION_TABLE;
+        const uint64_t program_table_size = static_cast<uint64_t>(header.e_phnum) * sizeof(Elf64_Phdr);
+        if (header.e_phentsize == sizeof(Elf64_Phdr) && program_table_size != 0 &&
+            header.e_phoff <= job->size && program_table_size <= job->size - header.e_phoff)
+        {
+            this->QueueRead(job, header.e_phoff, program_table_size);
+        }
+        if (table_size != 0)
+        {
+            this->QueueRead(job, header.e_shoff, table_size);
+        }
+        if (job->pending == 0)
+        {
+            this->Finish(job, true);
+        }
+        return;
+    }
+
+    case Job::STAGE_SECTION_TABLE:
+    {
+        Elf64_Ehdr header;
+        memcpy(&header, job->image, sizeof(header));
+
+        // 收集各表所在的段，按偏移排序后把相邻的合并成一次读
+        std::vector<std::pair<uint64_t, uint64_t>> ranges;
+        for (std::size_t i = 0; i < header.e_shnum; i++)
+        {
+            Elf64_Shdr section;
+            memcpy(&section, job->image + header.e_shoff + i * sizeof(Elf64_Shdr), sizeof(section));
+            if (!ELFReader::IsTableSection(section.sh_type) || section.sh_size == 0 ||
+                section.sh_offset > job->size || section.sh_size > job->size - section.sh_offset)
+            {
+                continue;
+            }
+            ranges.emplace_back(section.sh_offset, section.sh_offset + section.sh_size);
+        }
+
+        job->stage = Job::STAGE_TABLES;
+        this->QueueRanges(job, ranges);
+        if (job->pending == 0)
+        {
+            this->OnStageDone(job);
+        }
+        return;
+    }
+
+    case Job::STAGE_TABLES:
+    {
+        Elf64_Ehdr header;
+        memcpy(&header, job->image, sizeof(header));
+        if (!m_read_line_info || header.e_shstrndx >= header.e_shnum)
+        {
+            this->Finish(job, true);
+            return;
+        }
+
+        // .shstrtab 已在上一步读入，按段名找出 DWARF 行号相关的段，跳过已经合并读入的
+        Elf64_Shdr shstrtab;
+        memcpy(&shstrtab, job->image + header.e_shoff + header.e_shstrndx * sizeof(Elf64_Shdr), sizeof(shstrtab));
+        if (shstrtab.sh_offset > job->size || shstrtab.sh_size > job->size - shstrtab.sh_offset)
+        {
+            this->Finish(job, true);
+            return;
+        }
+        std::string_view names(job->image + shstrtab.sh_offset, shstrtab.sh_size);
+
+        std::vector<std::pair<uint64_t, uint64_t>> ranges;
+        for (std::size_t i = 0; i < header.e_shnum; i++)
+        {
+            Elf64_Shdr section;
+            memcpy(&section, job->image + header.e_shoff + i * sizeof(Elf64_Shdr), sizeof(section));
+            if (section.sh_type == SHT_NOBITS || section.sh_size == 0 || section.sh_name >= names.size() ||
+                section.sh_offset > job->size || section.sh_size > job->size - section.sh_offset)
+            {
+                continue;
+            }
+            std::string_view name = names.substr(section.sh_name);
+            name = name.substr(0, name.find('\0'));
+            if (!ELFReader::IsLineInfoSection(name))
+            {
+                continue;
+            }
+
+            const uint64_t begin = section.sh_offset, end = section.sh_offset + section.sh_size;
+            auto it = std::upper_bound(job->read_ranges.begin(), job->read_ranges.end(), std::make_pair(begin, UINT64_MAX));
+            if (it != job->read_ranges.begin() && (it - 1)->second >= end)
+            {
+                continue;
+            }
+            ranges.emplace_back(begin, end);
+        }
+
+        job->stage = Job::STAGE_LINE_INFO;
+        this->QueueRanges(job, ranges);
+        if (job->pending == 0)
+        {
+            this->Finish(job, true);
+        }
+        return;
+    }
+
+    case Job::STAGE_LINE_INFO:
+        this->Finish(job, true);
+        return;
+    }
+}
+
+void AsyncLoader::QueueRanges(Job *job, std::vector<std::pair<uint64_t, uint64_t>> &ranges)
+{
+    std::sort(ranges.begin(), ranges.end());
+
+    job->read_ranges.clear();
+    std::size_t i = 0;
+    while (i < ranges.size())
+    {
+        uint64_t begin = ranges[i].first;
+        uint64_t end = ranges[i].second;
+        for (i++; i < ranges.size() && ranges[i].first <= end + MERGE_GAP; i++)
+        {
+            end = std::max(end, ranges[i].second);
+        }
+        this->QueueRead(job, begin, end - begin);
+        job->read_ranges.emplace_back(begin, end);
+    }
+}
+
+void AsyncLoader::Finish(Job *job, bool ok)
+{
+    if (job->fd >= 0)
+    {
+        close(job->fd);
+    }
+
+    Image image;
+    image.index = job->index;
+    if (job->image != nullptr)
+    {
+        if (ok)
+        {
+            std::size_t size = job->size;
+            image.data = job->image;
+            image.size = size;
+            image.holder = std::shared_ptr<const void>(job->image, [size](const void *p) { munmap(const_cast<void*>(p), size); });
+        }
+        else
+        {
+            munmap(job->image, job->size);
+        }
+    }
+    delete job;
+
+    m_on_loaded(image);
+}
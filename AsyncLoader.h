@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class IoEngine;
+
+// 批量异步读取 ELF 文件中解析需要的部分：文件头 -> 段表与程序头表 -> 各表所在的段（ELFReader::IsTableSection）
+// -> 需要时再读行号查找用到的 DWARF 段（ELFReader::IsLineInfoSection，段名要等 .shstrtab 读入后才知道），
+// 每一步对所有在读的文件一起提交，读完一个文件就回调一次，解析与其他文件的读取重叠进行。
+// 优先使用 io_uring，不可用时（或设置 ELFREADER_IO=pread）退化为 pread 线程池。
+//
+// 读入的数据放在与文件等大的匿名映射中（只有读到的页面占用内存），各段位于原偏移处，
+// 可以直接交给 ELFReader::ReadELFBuffer 解析。
+class AsyncLoader
+{
+public:
+    struct Image
+    {
+        std::size_t index = 0;              // Submit 时给的编号
+        const char *data = nullptr;         // 为空表示没有读成（不是 ELF64、读失败等），调用方应退回同步读取
+        std::size_t size = 0;
+        std::shared_ptr<const void> holder; // 持有 data
+    };
+
+    // 在 I/O 线程中调用，应尽快返回（如把解析任务交给线程池）
+    using Callback = std::function<void(Image &image)>;
+
+    // read_line_info 为 true 时也读入 LineIndex 用到的 DWARF 段（如 -A 输出源码行时）
+    explicit AsyncLoader(const Callback &on_loaded, bool read_line_info = false, unsigned queue_depth = 128);
+    ~AsyncLoader(); // 等待已提交的文件全部读完
+
+    AsyncLoader(const AsyncLoader&) = delete;
+    AsyncLoader &operator=(const AsyncLoader&) = delete;
+
+    // 提交一个文件，不阻塞，可在任意线程调用
+    void Submit(std::size_t index, const std::string &path);
+
+    const char *GetEngineName() const;
+
+private:
+    struct Job;
+    struct ReadOp;
+
+    void IoLoop();
+    void StartJob(Job *job);
+    void QueueRead(Job *job, uint64_t offset, std::size_t len);
+    void QueueRanges(Job *job, std::vector<std::pair<uint64_t, uint64_t>> &ranges); // 排序、合并相邻的区间后提交
+    void OnReadDone(ReadOp *op, long result);
+    void OnStageDone(Job *job);
+    void Finish(Job *job, bool ok);
+
+private:
+    Callback m_on_loaded;
+    bool m_read_line_info;
+    std::unique_ptr<IoEngine> m_engine;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::unique_ptr<Job>> m_requests;   // 已提交、尚未开始的文件
+    bool m_stop = false;
+
+    // 以下只在 I/O 线程中访问
+    std::deque<ReadOp*> m_waiting_ops;              // 引擎队列已满时暂存
+    std::vector<std::unique_ptr<ReadOp>> m_free_ops;
+    std::size_t m_inflight_op_num = 0;
+
+    std::thread m_thread;
+};
@@ -0,0 +1,229 @@
+#include "BatchSymbolizer.h"
+#include "Demangler.h"
+#include "FdWriter.h"
+#include "LineIndex.h"
+#include "NumberFormat.h"
+
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+
+#include <unistd.h>
+
+namespace
+{
+    const std::size_t READ_BUFFER_SIZE = 1 << 20;
+
+    // 不是地址的行
+    const uint32_t NOT_ADDRESS = UINT32_MAX;
+}
+
+BatchSymbolizer::BatchSymbolizer(const SymbolIndex &index, FdWriter &out, std::size_t chunk_size) :
+    m_index(index), m_out(out), m_chunk_size(chunk_size > 0 ? chunk_size : 1)
+{
+    m_unique_ids.reserve(m_chunk_size);
+    m_sorted.reserve(m_chunk_size);
+    m_unique_addrs.reserve(m_chunk_size);
+    m_matches.resize(m_chunk_size);
+    m_text_ends.reserve(m_chunk_size);
+}
+
+bool BatchSymbolizer::Run(int fd)
+{
+    std::vector<char> buffer(READ_BUFFER_SIZE);
+    bool ok = true;
+
+    for (;;)
+    {
+        ssize_t n = read(fd, buffer.data(), buffer.size());
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            ok = n == 0;
+            break;
+        }
+
+        const char *p = buffer.data();
+        const char *end = p + n;
+        while (p < end)
+        {
+            const char *newline = static_cast<const char*>(memchr(p, '\n', end - p));
+            if (newline == nullptr)
+            {
+                m_pending.append(p, end);
+                break;
+            }
+
+            if (m_pending.empty())
+            {
+                this->AddLine(p, newline);
+            }
+            else
+            {
+                m_pending.append(p, newline);
+                this->AddLine(m_pending.data(), m_pending.data() + m_pending.size());
+                m_pending.clear();
+            }
+            p = newline + 1;
+        }
+    }
+
+    if (!m_pending.empty())
+    {
+        this->AddLine(m_pending.data(), m_pending.data() + m_pending.size());
+        m_pending.clear();
+    }
+    this->FlushChunk();
+    return ok;
+}
+
+void BatchSymbolizer::AddLine(const char *begin, const char *end)
+{
+    uint64_t addr = 0;
+    if (ParseAddress(begin, end, addr))
+    {
+        m_sorted.emplace_back(addr, static_cast<uint32_t>(m_unique_ids.size()));
+        m_unique_ids.push_back(0); // 去重后填入
+    }
+    else
+    {
+        m_unique_ids.push_back(NOT_ADDRESS);
+        m_raw_lines.append(begin, end);
+        m_raw_lines += '\n';
+    }
+
+    if (m_unique_ids.size() >= m_chunk_size)
+    {
+        this->FlushChunk();
+    }
+}
+
+void BatchSymbolizer::FlushChunk()
+{
+    if (m_unique_ids.empty())
+    {
+        return;
+    }
+
+    // 排序去重，每个不同的地址记下它的下标
+    std::sort(m_sorted.begin(), m_sorted.end());
+    m_unique_addrs.clear();
+    for (const auto &item : m_sorted)
+    {
+        if (m_unique_addrs.empty() || m_unique_addrs.back() != item.first)
+        {
+            m_unique_addrs.push_back(item.first);
+        }
+        m_unique_ids[item.second] = static_cast<uint32_t>(m_unique_addrs.size() - 1);
+    }
+
+    // 与符号区间归并一次
+    m_index.LookupSorted(m_unique_addrs.data(), m_unique_addrs.size(), m_matches.data());
+
+    // 每个不同的地址格式化一次
+    m_text.clear();
+    m_text_ends.clear();
+    char buffer[NUMBER_MAX_LEN];
+    for (std::size_t i = 0; i < m_unique_addrs.size(); i++)
+    {
+        m_text.append(buffer, NumberFormat::FormatHex(buffer, m_unique_addrs[i]));
+        const SymbolIndex::Match &match = m_matches[i];
+        if (match.found())
+        {
+            std::string_view name = match.name;
+            if (m_demangler != nullptr)
+            {
+                name = m_demangler->Demangle(name);
+            }
+            m_text += ' ';
+            m_text.append(name.data(), name.size());
+            m_text += '+';
+            m_text.append(buffer, NumberFormat::FormatHex(buffer, match.offset));
+        }
+        else
+        {
+            m_text.append(" ??");
+        }
+        if (m_line_index != nullptr)
+        {
+            // 地址升序查找，解码过的编译单元之后直接命中
+            LineIndex::Match line = m_line_index->LookupAddress(m_unique_addrs[i]);
+            if (line.found())
+            {
+                m_text += ' ';
+                m_text.append(line.file);
+                m_text += ':';
+                m_text.append(buffer, NumberFormat::FormatUInt(buffer, line.line));
+            }
+            else
+            {
+                m_text.append(" ??");
+            }
+        }
+        m_text += '\n';
+        m_text_ends.push_back(static_cast<uint32_t>(m_text.size()));
+    }
+
+    // 按输入顺序写出
+    std::size_t raw_pos = 0;
+    for (uint32_t id : m_unique_ids)
+    {
+        if (id == NOT_ADDRESS)
+        {
+            std::size_t raw_end = m_raw_lines.find('\n', raw_pos) + 1;
+            m_out.Write(m_raw_lines.data() + raw_pos, raw_end - raw_pos);
+            raw_pos = raw_end;
+        }
+        else
+        {
+            uint32_t begin = id == 0 ? 0 : m_text_ends[id - 1];
+            m_out.Write(m_text.data() + begin, m_text_ends[id] - begin);
+        }
+    }
+    m_out.Flush();
+
+    m_address_num += m_sorted.size();
+    m_unique_num += m_unique_addrs.size();
+    m_chunk_num++;
+
+    m_unique_ids.clear();
+    m_raw_lines.clear();
+    m_sorted.clear();
+}
+
+bool BatchSymbolizer::ParseAddress(const char *begin, const char *end, uint64_t &addr)
+{
+    while (begin < end && (*begin == ' ' || *begin == '\t'))
+    {
+        begin++;
+    }
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r'))
+    {
+        end--;
+    }
+    if (end - begin >= 2 && begin[0] == '0' && (begin[1] == 'x' || begin[1] == 'X'))
+    {
+        begin += 2;
+    }
+    if (begin == end || end - begin > 16)
+    {
+        return false;
+    }
+
+    uint64_t value = 0;
+    for (const char *p = begin; p < end; p++)
+    {
+        char c = *p;
+        unsigned digit;
+        if (c >= '0' && c <= '9') digit = c - '0';
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else return false;
+        value = (value << 4) | digit;
+    }
+    addr = value;
+    return true;
+}
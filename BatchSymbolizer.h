@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "SymbolIndex.h"
+
+class Demangler;
+class FdWriter;
+class LineIndex;
+
+// 大批量地址的符号化（addr2sym）：每行一个十六进制地址（可带 0x），按块处理：
+// 块内排序去重，用 SymbolIndex::LookupSorted 与符号区间归并一次，每个不同的地址只格式化一次，
+// 再按输入顺序写出 "0xaddr symbol+0xoffset"（找不到时为 "0xaddr ??"），不是地址的行原样输出。
+// 各缓冲在块之间复用，持续输入时不再分配内存；每块处理完即写出，可接在管道中间使用
+class BatchSymbolizer
+{
+public:
+    static const std::size_t DEFAULT_CHUNK_SIZE = 1 << 16;
+
+    BatchSymbolizer(const SymbolIndex &index, FdWriter &out, std::size_t chunk_size = DEFAULT_CHUNK_SIZE);
+
+    BatchSymbolizer(const BatchSymbolizer&) = delete;
+    BatchSymbolizer &operator=(const BatchSymbolizer&) = delete;
+
+    // 不为空时输出反修饰后的名字
+    void SetDemangler(Demangler *demangler) { m_demangler = demangler; }
+
+    // 不为空时每行再加上 " file:line"（没有行号信息时为 " ??"）
+    void SetLineIndex(LineIndex *line_index) { m_line_index = line_index; }
+
+    // 从 fd 读到结束，读失败时返回 false（已读到的部分仍会输出）
+    bool Run(int fd);
+
+    uint64_t GetAddressNum() const { return m_address_num; }
+    uint64_t GetUniqueNum() const { return m_unique_num; } // 各块内去重后的地址数之和
+    uint64_t GetChunkNum() const { return m_chunk_num; }
+
+private:
+    void AddLine(const char *begin, const char *end);
+    void FlushChunk();
+
+    static bool ParseAddress(const char *begin, const char *end, uint64_t &addr);
+
+private:
+    const SymbolIndex &m_index;
+    FdWriter &m_out;
+    std::size_t m_chunk_size;
+    Demangler *m_demangler = nullptr;
+    LineIndex *m_line_index = nullptr;
+
+    // 本块各行去重后的地址下标，按输入顺序；不是地址的行为 UINT32_MAX
+    std::vector<uint32_t> m_unique_ids;
+    std::string m_raw_lines;                            // 不是地址的行，依次存放，各以 '\n' 结尾
+
+    std::vector<std::pair<uint64_t, uint32_t>> m_sorted; // (地址, 输入位置)
+    std::vector<uint64_t> m_unique_addrs;
+    std::vector<SymbolIndex::Match> m_matches;
+    std::string m_text;                                 // 各不同地址格式化后的整行
+    std::vector<uint32_t> m_text_ends;                  // 第 i 行在 m_text 中的结尾
+
+    std::string m_pending;                              // 上一次读到的不完整行
+
+    uint64_t m_address_num = 0;
+    uint64_t m_unique_num = 0;
+    uint64_t m_chunk_num = 0;
+};
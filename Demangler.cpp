@@ -0,0 +1,134 @@
+#include "Demangler.h"
+
+#include <cstdlib>
+#include <cxxabi.h>
+
+#include "ThreadPool.h"
+
+// 符号数不少于该值时才并行解码
+static const std::size_t PARALLEL_MIN_SYMBOLS = 16384;
+
+Demangler::~Demangler()
+{
+    free(m_buffer);
+}
+
+std::string_view Demangler::DemangleInto(const char *name, Arena &arena, char *&buffer, std::size_t &buffer_size)
+{
+    int status = 0;
+    char *result = abi::__cxa_demangle(name, buffer, &buffer_size, &status);
+    if (status != 0 || result == nullptr)
+    {
+        return std::string_view(name);
+    }
+
+    // __cxa_demangle 可能 realloc 了缓冲
+    buffer = result;
+    return arena.Store(std::string_view(result));
+}
+
+std::string_view Demangler::Demangle(std::string_view name)
+{
+    if (!IsMangled(name.data()))
+    {
+        return name;
+    }
+
+    auto it = m_by_addr.find(name.data());
+    if (it != m_by_addr.end())
+    {
+        return it->second;
+    }
+
+    std::string_view result;
+    auto name_it = m_by_name.find(name);
+    if (name_it != m_by_name.end())
+    {
+        result = name_it->second;
+    }
+    else
+    {
+        result = DemangleInto(name.data(), m_arena, m_buffer, m_buffer_size);
+        m_by_name.emplace(name, result);
+    }
+
+    m_by_addr.emplace(name.data(), result);
+    return result;
+}
+
+void Demangler::Prepare(const ELFReader &reader, const TableView<ELFReader::Symbol> &symbols, bool is_dyn)
+{
+    if (m_thread_num <= 1 || symbols.size() < PARALLEL_MIN_SYMBOLS)
+    {
+        return; // 表不大时按需解码即可
+    }
+
+    // 收集尚未解码的修饰名
+    std::vector<const char*> names;
+    for (const ELFReader::Symbol &symbol : symbols)
+    {
+        std::string_view name = is_dyn ? symbol.get_dynsym_name(reader) : symbol.get_sym_name(reader);
+        if (!IsMangled(name.data()) || m_by_addr.find(name.data()) != m_by_addr.end())
+        {
+            continue;
+        }
+
+        // 其他表里已解码过的同名符号直接复用
+        auto name_it = m_by_name.find(name);
+        if (name_it != m_by_name.end())
+        {
+            m_by_addr.emplace(name.data(), name_it->second);
+        }
+        else
+        {
+            names.push_back(name.data());
+        }
+    }
+    if (names.size() < PARALLEL_MIN_SYMBOLS / 4)
+    {
+        return;
+    }
+
+    // 各线程解码连续的一段，写入自己的内存池，最后在本线程合并进缓存
+    ThreadPool pool(m_thread_num);
+    const int thread_num = pool.GetThreadNum();
+    if (m_worker_arenas.size() < static_cast<std::size_t>(thread_num))
+    {
+        m_worker_arenas.resize(thread_num);
+    }
+
+    std::vector<std::string_view> results(names.size());
+    const std::size_t chunk = (names.size() + thread_num - 1) / thread_num;
+    for (int t = 0; t < thread_num; t++)
+    {
+        pool.Submit([this, &names, &results, chunk, t](int)
+        {
+            Arena &arena = m_worker_arenas[t];
+            char *buffer = nullptr;
+            std::size_t buffer_size = 0;
+            for (std::size_t i = t * chunk; i < names.size() && i < (t + 1) * chunk; i++)
+            {
+                results[i] = DemangleInto(names[i], arena, buffer, buffer_size);
+            }
+            free(buffer);
+        });
+    }
+    pool.Wait();
+
+    for (std::size_t i = 0; i < names.size(); i++)
+    {
+        m_by_addr.emplace(names[i], results[i]);
+        m_by_name.emplace(std::string_view(names[i]), results[i]);
+    }
+}
+
+void Demangler::Clear()
+{
+    m_by_addr.clear();
+    m_by_name.clear();
+    m_arena.Reset();
+    for (Arena &arena : m_worker_arenas)
+    {
+        arena.Reset();
+    }
+}
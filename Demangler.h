@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Arena.h"
+#include "ELFReader.h"
+
+// C++ 符号名反修饰（demangle），结果缓存在内存池里。
+// 以名字在字符串表中的地址为键（即 字符串表 + 偏移），同一个名字被多次引用（如多条重定位）只解码一次；
+// 不同字符串表里内容相同的名字（如同一个符号同时在 .symtab 和 .dynsym 中）也共用一份结果。
+// 键指向 reader 的映像，换文件前须调用 Clear()。
+class Demangler
+{
+public:
+    // thread_num > 1 时大表在 Prepare 中并行解码
+    explicit Demangler(int thread_num = 1) : m_thread_num(thread_num) {}
+
+    Demangler(const Demangler&) = delete;
+    Demangler &operator=(const Demangler&) = delete;
+
+    ~Demangler();
+
+    // 预先解码一张符号表的全部名字，符号数较多时分给多个线程
+    void Prepare(const ELFReader &reader, const TableView<ELFReader::Symbol> &symbols, bool is_dyn);
+
+    // name 须以 '\0' 结尾（字符串表上的名字都是），不是修饰名时原样返回
+    std::string_view Demangle(std::string_view name);
+
+    // 清空缓存，保留内存池容量
+    void Clear();
+
+    std::size_t GetCacheSize() const { return m_by_addr.size(); }
+
+private:
+    // 解码一个名字，结果放入 arena；buffer 为 __cxa_demangle 复用的缓冲
+    static std::string_view DemangleInto(const char *name, Arena &arena, char *&buffer, std::size_t &buffer_size);
+
+    static bool IsMangled(const char *name) { return name[0] == '_' && name[1] == 'Z'; }
+
+private:
+    int m_thread_num;
+    Arena m_arena;
+    std::vector<Arena> m_worker_arenas; // 并行解码时各线程各自的内存池
+    std::unordered_map<const char*, std::string_view> m_by_addr;
+    std::unordered_map<std::string_view, std::string_view> m_by_name;
+
+    char *m_buffer = nullptr;
+    std::size_t m_buffer_size = 0;
+};
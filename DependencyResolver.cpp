@@ -0,0 +1,791 @@
+#include "DependencyResolver.h"
+#include "ELFReader.h"
+#include "NumberFormat.h"
+
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <unordered_set>
+
+#include <fcntl.h>
+#include <glob.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    // 各架构 ld.so 的默认目录为 Debian 系的多架构目录 /lib/<triplet>、/usr/lib/<triplet>，
+    // 加上 glibc 的 SYSTEM_DIRS /<lib>、/usr/<lib>、/lib、/usr/lib
+    struct Arch
+    {
+        unsigned char elf_class;
+        uint16_t machine;
+        const char *triplet;
+        const char *lib;
+        const char *platform;
+    };
+
+    const Arch ARCHES[] = {
+        { ELFCLASS64, EM_X86_64, "x86_64-linux-gnu", "lib64", "x86_64" },
+        { ELFCLASS32, EM_386, "i386-linux-gnu", "lib", "i686" },
+        { ELFCLASS64, EM_AARCH64, "aarch64-linux-gnu", "lib64", "aarch64" },
+    };
+
+    void SplitPath(const std::string &value, const char *separators, std::vector<std::string> &dirs)
+    {
+        std::size_t begin = 0;
+        for (;;)
+        {
+            std::size_t end = value.find_first_of(separators, begin);
+            dirs.push_back(value.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+            if (end == std::string::npos)
+            {
+                break;
+            }
+            begin = end + 1;
+        }
+    }
+
+    // 把 $NAME 与 ${NAME} 换成 value
+    void ReplaceToken(std::string &s, const char *name, const std::string &value)
+    {
+        std::string plain = std::string("$") + name;
+        std::string braced = std::string("${") + name + "}";
+        for (int braces = 1; braces >= 0; braces--)
+        {
+            const std::string &token = braces ? braced : plain;
+            std::size_t pos = 0;
+            while ((pos = s.find(token, pos)) != std::string::npos)
+            {
+                // $ORIGINAL 之类不是 $ORIGIN
+                std::size_t end = pos + token.size();
+                if (!braces && end < s.size() && (isalnum(static_cast<unsigned char>(s[end])) || s[end] == '_'))
+                {
+                    pos = end;
+                    continue;
+                }
+                s.replace(pos, token.size(), value);
+                pos += value.size();
+            }
+        }
+    }
+
+    std::string DirName(const std::string &path)
+    {
+        std::size_t pos = path.rfind('/');
+        if (pos == std::string::npos)
+        {
+            return ".";
+        }
+        return pos == 0 ? "/" : path.substr(0, pos);
+    }
+
+    void AppendQuoted(std::string &out, const std::string &s, bool json)
+    {
+        out += '"';
+        for (char c : s)
+        {
+            unsigned char uc = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\')
+            {
+                out += '\\';
+                out += c;
+            }
+            else if (uc < 0x20)
+            {
+                static const char hex[] = "0123456789abcdef";
+                if (json)
+                {
+                    out.append("\\u00");
+                    out += hex[uc >> 4];
+                    out += hex[uc & 0xf];
+                }
+                else
+                {
+                    out += ' ';
+                }
+            }
+            else
+            {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+
+    void AppendNumber(std::string &out, uint64_t value)
+    {
+        char buffer[NUMBER_MAX_LEN];
+        out.append(buffer, NumberFormat::FormatUInt(buffer, value));
+    }
+}
+
+DependencyResolver::DependencyResolver(int thread_num) : m_pool(thread_num)
+{
+    const char *library_path = getenv("LD_LIBRARY_PATH");
+    if (library_path != nullptr && library_path[0] != '\0')
+    {
+        SplitPath(library_path, ":;", m_library_path);
+    }
+
+    this->LoadSystemDirs();
+}
+
+void DependencyResolver::LoadSystemDirs()
+{
+    // ld.so.cache 由 ldconfig 按 /etc/ld.so.conf 中的目录生成，这里直接按这些目录的顺序查找
+    std::vector<std::string> confs = { "/etc/ld.so.conf" };
+    std::set<std::string> seen_confs;
+    std::vector<std::string> dirs;
+    for (std::size_t i = 0; i < confs.size(); i++)
+    {
+        if (!seen_confs.insert(confs[i]).second)
+        {
+            continue;
+        }
+
+        std::ifstream ifs(confs[i]);
+        std::string line;
+        while (std::getline(ifs, line))
+        {
+            line = line.substr(0, line.find('#'));
+            std::size_t begin = line.find_first_not_of(" \t\r");
+            if (begin == std::string::npos)
+            {
+                continue;
+            }
+            std::size_t end = line.find_last_not_of(" \t\r");
+            line = line.substr(begin, end - begin + 1);
+
+            if (line.compare(0, 8, "include ") == 0 || line.compare(0, 8, "include\t") == 0)
+            {
+                std::string pattern = line.substr(line.find_first_not_of(" \t", 8));
+                if (pattern[0] != '/')
+                {
+                    pattern = DirName(confs[i]) + "/" + pattern;
+                }
+                glob_t result;
+                if (glob(pattern.c_str(), 0, nullptr, &result) == 0)
+                {
+                    for (std::size_t k = 0; k < result.gl_pathc; k++)
+                    {
+                        confs.push_back(result.gl_pathv[k]);
+                    }
+                }
+                globfree(&result);
+            }
+            else if (line.compare(0, 6, "hwcap ") != 0)
+            {
+                dirs.push_back(line);
+            }
+        }
+    }
+
+    // ld.so.conf 中的目录各架构共用，其中其他架构的库在查找时被跳过
+    auto add_arch = [this, &dirs](unsigned char elf_class, uint16_t machine, const std::vector<std::string> &defaults,
+        const std::string &lib_name, const std::string &platform)
+    {
+        ArchDirs arch { elf_class, machine, {}, lib_name, platform };
+        std::unordered_set<std::string> seen;
+        std::vector<std::string> all = dirs;
+        all.insert(all.end(), defaults.begin(), defaults.end());
+        for (std::string &dir : all)
+        {
+            while (dir.size() > 1 && dir.back() == '/')
+            {
+                dir.pop_back();
+            }
+            if (seen.insert(dir).second)
+            {
+                arch.system_dirs.push_back(dir);
+            }
+        }
+        m_arch_dirs.push_back(std::move(arch));
+    };
+
+    for (const Arch &arch : ARCHES)
+    {
+        std::string multiarch = std::string("lib/") + arch.triplet;
+        std::vector<std::string> defaults = {
+            "/" + multiarch, "/usr/" + multiarch, std::string("/") + arch.lib, std::string("/usr/") + arch.lib, "/lib", "/usr/lib",
+        };
+
+        // $LIB 取 ld.so 在本机上使用的库目录名
+        struct stat st;
+        bool has_multiarch = stat(defaults[0].c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+        add_arch(arch.elf_class, arch.machine, defaults, has_multiarch ? multiarch : arch.lib, arch.platform);
+    }
+    add_arch(0, 0, { "/lib", "/usr/lib" }, "lib", "");
+}
+
+const DependencyResolver::ArchDirs &DependencyResolver::GetArchDirs(const Library *library) const
+{
+    for (std::size_t i = 0; i + 1 < m_arch_dirs.size(); i++)
+    {
+        if (m_arch_dirs[i].elf_class == library->elf_class && m_arch_dirs[i].machine == library->machine)
+        {
+            return m_arch_dirs[i];
+        }
+    }
+    return m_arch_dirs.back();
+}
+
+void DependencyResolver::Resolve(const std::vector<std::string> &paths)
+{
+    m_roots.clear();
+    m_roots.resize(paths.size());
+
+    // 第一步：从各根对象出发并行展开依赖图
+    for (std::size_t i = 0; i < paths.size(); i++)
+    {
+        m_roots[i].path = paths[i];
+        m_pool.Submit([this, i](int)
+        {
+            const Library *library = this->Probe(m_roots[i].path);
+            if (library != nullptr)
+            {
+                this->Expand(library, std::vector<std::string>());
+            }
+        });
+    }
+    m_pool.Wait();
+
+    // 第二步：各根对象按广度优先排出装载顺序，查找结果都已算好
+    for (std::size_t i = 0; i < m_roots.size(); i++)
+    {
+        m_pool.Submit([this, i](int) { this->Order(m_roots[i]); });
+    }
+    m_pool.Wait();
+}
+
+const DependencyResolver::Library *DependencyResolver::Probe(const std::string &path)
+{
+    PathEntry *entry = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::unique_ptr<PathEntry> &item = m_paths[path];
+        if (!item)
+        {
+            item.reset(new PathEntry);
+        }
+        entry = item.get();
+    }
+
+    std::call_once(entry->once, [this, &path, entry]
+    {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return;
+        }
+
+        // 类别与架构在 Search 中与请求它的对象比较，这里接受所有 ELF 文件
+        struct stat st;
+        ELFReader::TriageInfo info;
+        bool ok = fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && ELFReader::Triage(fd, info);
+        close(fd);
+        if (!ok)
+        {
+            return;
+        }
+
+        LibraryEntry *library = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::unique_ptr<LibraryEntry> &item = m_libraries[std::make_pair(static_cast<uint64_t>(st.st_dev),
+                static_cast<uint64_t>(st.st_ino))];
+            if (!item)
+            {
+                item.reset(new LibraryEntry);
+            }
+            library = item.get();
+        }
+
+        std::call_once(library->once, [&path, library] { library->ok = ParseLibrary(path, library->library); });
+        if (library->ok)
+        {
+            entry->library = &library->library;
+        }
+    });
+    return entry->library;
+}
+
+bool DependencyResolver::ParseLibrary(const std::string &path, Library &library)
+{
+    ELFReader reader;
+    if (!reader.ReadELFFile(path.c_str()))
+    {
+        return false;
+    }
+
+    char real_path[PATH_MAX];
+    library.path = realpath(path.c_str(), real_path) != nullptr ? real_path : path;
+    library.type = reader.GetHeader().e_type;
+    library.elf_class = reader.GetHeader().e_ident[EI_CLASS];
+    library.data = reader.GetHeader().e_ident[EI_DATA];
+    library.machine = reader.GetHeader().e_machine;
+
+    const StrTable &strs = reader.GetDynamicStrs();
+    for (const ELFReader::Dynamic &item : reader.GetDynamics())
+    {
+        const Elf64_Dyn &dyn = item.dyn;
+        if (dyn.d_tag == DT_NULL)
+        {
+            break;
+        }
+        if (dyn.d_tag != DT_NEEDED && dyn.d_tag != DT_SONAME && dyn.d_tag != DT_RPATH && dyn.d_tag != DT_RUNPATH)
+        {
+            continue;
+        }
+        if (dyn.d_un.d_val >= strs.size())
+        {
+            std::cerr << "DependencyResolver::ParseLibrary failed: bad string offset in " << path << std::endl;
+            return false;
+        }
+
+        std::string value(strs.view(dyn.d_un.d_val));
+        switch (dyn.d_tag)
+        {
+            case DT_NEEDED:
+                library.needed.push_back(value);
+                break;
+
+            case DT_SONAME:
+                library.soname = value;
+                break;
+
+            case DT_RPATH:
+                SplitPath(value, ":", library.rpath);
+                break;
+
+            case DT_RUNPATH:
+                SplitPath(value, ":", library.runpath);
+                library.has_runpath = true;
+                break;
+        }
+    }
+    return true;
+}
+
+DependencyResolver::Resolution &DependencyResolver::GetResolution(const Library *library,
+    const std::vector<std::string> &inherited, bool *created)
+{
+    std::string key(reinterpret_cast<const char*>(&library), sizeof(library));
+    for (const std::string &dir : inherited)
+    {
+        key += '\0';
+        key += dir;
+    }
+
+    Resolution *resolution = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::unique_ptr<Resolution> &item = m_resolutions[key];
+        if (created != nullptr)
+        {
+            *created = !item;
+        }
+        if (!item)
+        {
+            item.reset(new Resolution);
+        }
+        resolution = item.get();
+    }
+
+    std::call_once(resolution->once, [this, library, &inherited, resolution]
+    {
+        resolution->targets.reserve(library->needed.size());
+        for (const std::string &name : library->needed)
+        {
+            resolution->targets.push_back(this->Search(name, library, inherited));
+        }
+    });
+    return *resolution;
+}
+
+const DependencyResolver::Library *DependencyResolver::Search(const std::string &name, const Library *library,
+    const std::vector<std::string> &inherited)
+{
+    // 只有 ET_DYN 能被动态装载；ld.so 静默跳过类别、字节序或架构不同的文件，继续在后面的目录中找
+    auto accept = [library](const Library *found)
+    {
+        return found != nullptr && found->type == ET_DYN && found->elf_class == library->elf_class &&
+            found->data == library->data && found->machine == library->machine;
+    };
+
+    // 带 '/' 的名字直接当作路径
+    if (name.find('/') != std::string::npos)
+    {
+        std::vector<std::string> paths = this->ExpandPath({ name }, library);
+        const Library *found = this->Probe(paths[0]);
+        return accept(found) ? found : nullptr;
+    }
+
+    std::vector<std::string> dirs;
+    if (!library->has_runpath)
+    {
+        dirs = this->ExpandPath(library->rpath, library);
+        dirs.insert(dirs.end(), inherited.begin(), inherited.end());
+    }
+    std::vector<std::string> library_path = this->ExpandPath(m_library_path, library);
+    dirs.insert(dirs.end(), library_path.begin(), library_path.end());
+    std::vector<std::string> runpath = this->ExpandPath(library->runpath, library);
+    dirs.insert(dirs.end(), runpath.begin(), runpath.end());
+    const std::vector<std::string> &system_dirs = this->GetArchDirs(library).system_dirs;
+    dirs.insert(dirs.end(), system_dirs.begin(), system_dirs.end());
+
+    std::string path;
+    for (const std::string &dir : dirs)
+    {
+        path = dir;
+        if (path.back() != '/')
+        {
+            path += '/';
+        }
+        path += name;
+
+        const Library *found = this->Probe(path);
+        if (accept(found))
+        {
+            return found;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<std::string> DependencyResolver::ExpandPath(const std::vector<std::string> &dirs, const Library *library) const
+{
+    std::vector<std::string> result;
+    result.reserve(dirs.size());
+    for (const std::string &dir : dirs)
+    {
+        // 空的一项表示当前目录
+        std::string expanded = dir.empty() ? "." : dir;
+        if (expanded.find('$') != std::string::npos)
+        {
+            ReplaceToken(expanded, "ORIGIN", DirName(library->path));
+            const ArchDirs &arch = this->GetArchDirs(library);
+            ReplaceToken(expanded, "LIB", arch.lib_name);
+            ReplaceToken(expanded, "PLATFORM", arch.platform);
+        }
+        result.push_back(std::move(expanded));
+    }
+    return result;
+}
+
+std::vector<std::string> DependencyResolver::Inherit(const Library *library, const std::vector<std::string> &inherited) const
+{
+    if (library->has_runpath || library->rpath.empty())
+    {
+        return inherited;
+    }
+
+    // 去掉重复的目录，互相依赖的库链不会无限变长，查找顺序也不变
+    std::vector<std::string> result;
+    for (std::string &dir : this->ExpandPath(library->rpath, library))
+    {
+        if (std::find(result.begin(), result.end(), dir) == result.end())
+        {
+            result.push_back(std::move(dir));
+        }
+    }
+    for (const std::string &dir : inherited)
+    {
+        if (std::find(result.begin(), result.end(), dir) == result.end())
+        {
+            result.push_back(dir);
+        }
+    }
+    return result;
+}
+
+void DependencyResolver::Expand(const Library *library, std::vector<std::string> inherited)
+{
+    bool created = false;
+    Resolution &resolution = this->GetResolution(library, inherited, &created);
+    if (!created)
+    {
+        return;
+    }
+
+    std::vector<std::string> child_inherited = this->Inherit(library, inherited);
+    for (const Library *target : resolution.targets)
+    {
+        if (target != nullptr)
+        {
+            m_pool.Submit([this, target, child_inherited](int) { this->Expand(target, child_inherited); });
+        }
+    }
+}
+
+void DependencyResolver::Order(Root &root)
+{
+    const Library *library = this->Probe(root.path);
+    if (library == nullptr)
+    {
+        return;
+    }
+    root.ok = true;
+
+    // ld.so 先按名字（请求时的名字、路径、SONAME）找已装载的对象，再按文件本身去重
+    std::unordered_map<std::string_view, std::size_t> names;
+    std::unordered_map<const Library*, std::size_t> positions;
+    std::vector<std::vector<std::string>> inherited;
+
+    auto load = [&](const Library *target, std::string_view name, std::size_t depth, std::vector<std::string> from)
+    {
+        std::size_t pos = root.load_order.size();
+        root.load_order.push_back(target);
+        root.names.push_back(name);
+        root.depths.push_back(depth);
+        inherited.push_back(std::move(from));
+        positions.emplace(target, pos);
+        names.emplace(target->path, pos);
+        if (!target->soname.empty())
+        {
+            names.emplace(target->soname, pos);
+        }
+        return pos;
+    };
+    load(library, root.path, 0, std::vector<std::string>());
+
+    for (std::size_t i = 0; i < root.load_order.size(); i++)
+    {
+        const Library *current = root.load_order[i];
+        const Resolution &resolution = this->GetResolution(current, inherited[i], nullptr);
+        for (std::size_t k = 0; k < current->needed.size(); k++)
+        {
+            const std::string &name = current->needed[k];
+            auto name_it = names.find(name);
+            if (name_it != names.end())
+            {
+                root.edges.emplace_back(i, name_it->second);
+                continue;
+            }
+
+            const Library *target = resolution.targets[k];
+            if (target == nullptr)
+            {
+                root.missing.push_back(Missing { i, name });
+                continue;
+            }
+
+            auto pos_it = positions.find(target);
+            std::size_t pos = pos_it != positions.end() ? pos_it->second :
+                load(target, name, root.depths[i] + 1, this->Inherit(current, inherited[i]));
+            names.emplace(name, pos);
+            root.edges.emplace_back(i, pos);
+        }
+    }
+}
+
+std::size_t DependencyResolver::GetLibraryNum() const
+{
+    std::unordered_set<const Library*> libraries;
+    for (const Root &root : m_roots)
+    {
+        for (std::size_t i = 1; i < root.load_order.size(); i++)
+        {
+            libraries.insert(root.load_order[i]);
+        }
+    }
+    return libraries.size();
+}
+
+void DependencyResolver::FormatText(std::string &out) const
+{
+    for (const Root &root : m_roots)
+    {
+        out += root.path;
+        if (!root.ok)
+        {
+            out += ": not an ELF object\n";
+            continue;
+        }
+
+        std::size_t depth = *std::max_element(root.depths.begin(), root.depths.end());
+        out += ": ";
+        AppendNumber(out, root.load_order.size() - 1);
+        out += " libraries, depth ";
+        AppendNumber(out, depth);
+        if (!root.missing.empty())
+        {
+            out += ", ";
+            AppendNumber(out, root.missing.size());
+            out += " not found";
+        }
+        out += '\n';
+
+        for (std::size_t i = 1; i < root.load_order.size(); i++)
+        {
+            out += '\t';
+            out.append(root.names[i].data(), root.names[i].size());
+            out += " => ";
+            out += root.load_order[i]->path;
+            out += '\n';
+        }
+        for (const Missing &missing : root.missing)
+        {
+            out += '\t';
+            out += missing.name;
+            out += " => not found (needed by ";
+            out.append(root.names[missing.needed_by].data(), root.names[missing.needed_by].size());
+            out += ")\n";
+        }
+    }
+}
+
+void DependencyResolver::FormatDot(std::string &out) const
+{
+    // 所有根对象合成一张图，同一个库只有一个节点
+    std::unordered_map<const Library*, std::size_t> ids;
+    std::unordered_map<std::string, std::size_t> missing_ids;
+    std::set<std::pair<std::size_t, std::size_t>> edges;
+    std::set<std::pair<std::size_t, std::size_t>> missing_edges;
+
+    out += "digraph dependencies {\n\tnode [shape=box];\n";
+    for (const Root &root : m_roots)
+    {
+        if (!root.ok)
+        {
+            continue;
+        }
+
+        std::vector<std::size_t> root_ids;
+        for (std::size_t i = 0; i < root.load_order.size(); i++)
+        {
+            auto it = ids.emplace(root.load_order[i], ids.size());
+            if (it.second || i == 0)
+            {
+                out += "\tn";
+                AppendNumber(out, it.first->second);
+                out += " [label=";
+                AppendQuoted(out, root.load_order[i]->path, false);
+                out += i == 0 ? ", style=bold];\n" : "];\n";
+            }
+            root_ids.push_back(it.first->second);
+        }
+        for (const auto &edge : root.edges)
+        {
+            edges.emplace(root_ids[edge.first], root_ids[edge.second]);
+        }
+        for (const Missing &missing : root.missing)
+        {
+            auto it = missing_ids.emplace(missing.name, missing_ids.size());
+            if (it.second)
+            {
+                out += "\tm";
+                AppendNumber(out, it.first->second);
+                out += " [label=";
+                AppendQuoted(out, missing.name + " (not found)", false);
+                out += ", color=red, style=dashed];\n";
+            }
+            missing_edges.emplace(root_ids[missing.needed_by], it.first->second);
+        }
+    }
+
+    for (const auto &edge : edges)
+    {
+        out += "\tn";
+        AppendNumber(out, edge.first);
+        out += " -> n";
+        AppendNumber(out, edge.second);
+        out += ";\n";
+    }
+    for (const auto &edge : missing_edges)
+    {
+        out += "\tn";
+        AppendNumber(out, edge.first);
+        out += " -> m";
+        AppendNumber(out, edge.second);
+        out += " [color=red];\n";
+    }
+    out += "}\n";
+}
+
+void DependencyResolver::FormatJson(std::string &out) const
+{
+    // libraries 为所有出现过的库（含根对象），roots 中的下标都指向它
+    std::unordered_map<const Library*, std::size_t> ids;
+    std::vector<const Library*> libraries;
+    std::set<std::pair<std::size_t, std::size_t>> edges;
+    std::string roots;
+
+    for (const Root &root : m_roots)
+    {
+        roots += roots.empty() ? "\n" : ",\n";
+        roots += "{\"path\":";
+        AppendQuoted(roots, root.path, true);
+        if (!root.ok)
+        {
+            roots += ",\"error\":\"not an ELF object\"}";
+            continue;
+        }
+
+        std::vector<std::size_t> root_ids;
+        for (const Library *library : root.load_order)
+        {
+            auto it = ids.emplace(library, libraries.size());
+            if (it.second)
+            {
+                libraries.push_back(library);
+            }
+            root_ids.push_back(it.first->second);
+        }
+        for (const auto &edge : root.edges)
+        {
+            edges.emplace(root_ids[edge.first], root_ids[edge.second]);
+        }
+
+        roots += ",\"library_num\":";
+        AppendNumber(roots, root.load_order.size() - 1);
+        roots += ",\"depth\":";
+        AppendNumber(roots, *std::max_element(root.depths.begin(), root.depths.end()));
+        roots += ",\"load_order\":[";
+        for (std::size_t i = 0; i < root_ids.size(); i++)
+        {
+            if (i > 0) roots += ',';
+            AppendNumber(roots, root_ids[i]);
+        }
+        roots += "],\"missing\":[";
+        for (std::size_t i = 0; i < root.missing.size(); i++)
+        {
+            if (i > 0) roots += ',';
+            roots += "{\"name\":";
+            AppendQuoted(roots, root.missing[i].name, true);
+            roots += ",\"needed_by\":";
+            AppendNumber(roots, root_ids[root.missing[i].needed_by]);
+            roots += '}';
+        }
+        roots += "]}";
+    }
+
+    out += "{\"libraries\":[";
+    for (std::size_t i = 0; i < libraries.size(); i++)
+    {
+        out += i > 0 ? ",\n" : "\n";
+        out += "{\"path\":";
+        AppendQuoted(out, libraries[i]->path, true);
+        out += ",\"soname\":";
+        AppendQuoted(out, libraries[i]->soname, true);
+        out += '}';
+    }
+    out += "],\n\"roots\":[";
+    out += roots;
+    out += "],\n\"edges\":[";
+    bool first = true;
+    for (const auto &edge : edges)
+    {
+        out += first ? "\n[" : ",\n[";
+        first = false;
+        AppendNumber(out, edge.first);
+        out += ',';
+        AppendNumber(out, edge.second);
+        out += ']';
+    }
+    out += "]}\n";
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ThreadPool.h"
+
+// 按 ld.so 的规则解析共享库的完整传递依赖：每个 DT_NEEDED 依次在 DT_RPATH（对象没有 DT_RUNPATH 时，
+// 连同装载链上各祖先的 DT_RPATH）、LD_LIBRARY_PATH、DT_RUNPATH、/etc/ld.so.conf 中的目录和默认目录中查找，
+// 支持 $ORIGIN/$LIB/$PLATFORM；装载顺序按广度优先，已装载的库按名字或 SONAME 复用，与 ld.so 一致。
+// 与 ld.so 一样只接受类别、字节序、架构都与根对象相同的库，默认目录与 $LIB、$PLATFORM 也按根对象的架构选取。
+//
+// 分两步：先在线程池上并行展开依赖图，每个库的每个 DT_NEEDED 只查找一次，子库作为新任务提交，
+// 不同分支并行解析；再逐个根对象按广度优先排出装载顺序，只查已算好的结果。
+// 文件按路径、库按 设备号 + inode 记忆，被许多根对象共用的库只读取一次
+class DependencyResolver
+{
+public:
+    struct Library
+    {
+        std::string path;                   // realpath
+        std::string soname;
+        std::vector<std::string> needed;
+        std::vector<std::string> rpath;     // 未展开 $ORIGIN 的各目录
+        std::vector<std::string> runpath;
+        bool has_runpath = false;
+        uint16_t type = 0;                  // ET_EXEC / ET_DYN
+        unsigned char elf_class = 0;
+        unsigned char data = 0;
+        uint16_t machine = 0;
+    };
+
+    struct Missing
+    {
+        std::size_t needed_by;              // 在 load_order 中的位置
+        std::string name;
+    };
+
+    struct Root
+    {
+        std::string path;                   // 命令行给出的路径
+        bool ok = false;                    // 根对象不是可读的 ELF 文件时为 false
+        std::vector<const Library*> load_order; // 第一个为根对象本身
+        std::vector<std::string_view> names;    // 与 load_order 对应，第一次请求它时用的名字
+        std::vector<std::size_t> depths;    // 与 load_order 对应，根对象为 0
+        std::vector<std::pair<std::size_t, std::size_t>> edges; // load_order 中的位置，按 DT_NEEDED 的顺序
+        std::vector<Missing> missing;
+    };
+
+    explicit DependencyResolver(int thread_num);
+
+    DependencyResolver(const DependencyResolver&) = delete;
+    DependencyResolver &operator=(const DependencyResolver&) = delete;
+
+    void Resolve(const std::vector<std::string> &paths);
+
+    // 与输入顺序一致
+    const std::vector<Root> &GetRoots() const { return m_roots; }
+
+    // 每个根对象一段：装载顺序中的每个库一行 "  name => path"，找不到时为 "  name => not found"
+    void FormatText(std::string &out) const;
+    void FormatDot(std::string &out) const;
+    void FormatJson(std::string &out) const;
+
+    std::size_t GetLibraryNum() const;                                  // 出现在装载顺序中的不同库（不含根对象）
+    std::size_t GetParsedFileNum() const { return m_libraries.size(); } // 读取过的 ELF 文件，含查找时试过的
+    std::size_t GetProbedPathNum() const { return m_paths.size(); }
+
+private:
+    struct PathEntry
+    {
+        std::once_flag once;
+        const Library *library = nullptr;   // 不存在或不是可读的 ELF 文件时为空
+    };
+
+    // 一种架构的 ld.so 的默认目录（含 ld.so.conf 中的目录）与 $LIB、$PLATFORM
+    struct ArchDirs
+    {
+        unsigned char elf_class;
+        uint16_t machine;
+        std::vector<std::string> system_dirs;
+        std::string lib_name;
+        std::string platform;
+    };
+
+    struct LibraryEntry
+    {
+        std::once_flag once;
+        bool ok = false;
+        Library library;
+    };
+
+    // 一个库在某个继承下来的 RPATH 列表下，各 DT_NEEDED 找到的库（找不到为空）
+    struct Resolution
+    {
+        std::once_flag once;
+        std::vector<const Library*> targets;
+    };
+
+    const Library *Probe(const std::string &path);
+    static bool ParseLibrary(const std::string &path, Library &library);
+
+    // created 不为空时，返回本次调用是否新建了该结果
+    Resolution &GetResolution(const Library *library, const std::vector<std::string> &inherited, bool *created);
+    const Library *Search(const std::string &name, const Library *library, const std::vector<std::string> &inherited);
+
+    // 子库继承的 RPATH 列表：library 自己的 DT_RPATH（有 DT_RUNPATH 时不用）接在 inherited 前面，去掉重复
+    std::vector<std::string> Inherit(const Library *library, const std::vector<std::string> &inherited) const;
+    std::vector<std::string> ExpandPath(const std::vector<std::string> &dirs, const Library *library) const;
+
+    void Expand(const Library *library, std::vector<std::string> inherited);
+    void Order(Root &root);
+
+    void LoadSystemDirs();
+    const ArchDirs &GetArchDirs(const Library *library) const;
+
+private:
+    ThreadPool m_pool;
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, std::unique_ptr<PathEntry>> m_paths;
+    std::map<std::pair<uint64_t, uint64_t>, std::unique_ptr<LibraryEntry>> m_libraries;   // key: 设备号, inode
+    std::unordered_map<std::string, std::unique_ptr<Resolution>> m_resolutions;           // key: 库 + 继承的 RPATH
+
+    std::vector<std::string> m_library_path;    // LD_LIBRARY_PATH
+    std::vector<ArchDirs> m_arch_dirs;          // 最后一项用于不认识的架构
+
+    std::vector<Root> m_roots;
+};
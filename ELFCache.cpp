@@ -0,0 +1,203 @@
+#include "ELFCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace
+{
+    // 条目格式的版本，写入条目名；格式变化（如紧凑映像新增保留的段）时递增，旧条目不再命中
+    const char ENTRY_VERSION[] = "4";
+
+    // 段表的 FNV-1a 散列，区分 build-id 相同而内容不同的文件（如 strip 前后）
+    uint64_t HashSectionTable(const ELFReader &reader)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](uint64_t value)
+        {
+            for (int i = 0; i < 8; i++)
+            {
+                hash ^= (value >> (i * 8)) & 0xff;
+                hash *= 1099511628211ull;
+            }
+        };
+
+        for (const ELFReader::Section &section : reader.GetSections())
+        {
+            const Elf64_Shdr &header = section.section_header;
+            mix(header.sh_name);
+            mix(header.sh_type);
+            mix(header.sh_offset);
+            mix(header.sh_size);
+        }
+        return hash;
+    }
+}
+
+ELFCache::ELFCache(const std::string &dir) :
+    m_dir(dir), m_hit_num(0), m_miss_num(0)
+{
+    if (!m_dir.empty() && m_dir.back() != '/')
+    {
+        m_dir += '/';
+    }
+
+    // 目录已存在时 mkdir 失败，忽略
+    mkdir(m_dir.c_str(), 0755);
+}
+
+bool ELFCache::Open(const char *path, ELFReader &reader, SymbolIndex *index)
+{
+    struct stat st;
+    if (stat(path, &st) != 0)
+    {
+        perror("ELFCache::Open stat");
+        return false;
+    }
+
+    char stat_name[128] {};
+    snprintf(stat_name, sizeof(stat_name), "st%s-%lx-%lx-%lx-%lx.%09lx", ENTRY_VERSION,
+        static_cast<unsigned long>(st.st_dev), static_cast<unsigned long>(st.st_ino), static_cast<unsigned long>(st.st_size),
+        static_cast<unsigned long>(st.st_mtim.tv_sec), static_cast<unsigned long>(st.st_mtim.tv_nsec));
+
+    // 热路径：一次 stat 即可定位条目
+    if (this->OpenEntry(m_dir + stat_name, reader, index))
+    {
+        m_hit_num++;
+        return true;
+    }
+
+    if (!reader.ReadELFFile(path))
+    {
+        return false;
+    }
+
+    std::string build_id = reader.GetBuildId();
+    std::string entry_name = stat_name;
+    if (!build_id.empty())
+    {
+        char layout[32] {};
+        snprintf(layout, sizeof(layout), "-%016lx", static_cast<unsigned long>(HashSectionTable(reader)));
+        entry_name = std::string("bid") + ENTRY_VERSION + "-" + build_id + layout;
+    }
+
+    if (!build_id.empty())
+    {
+        // 同一构建的其他副本可能已经写过缓存
+        if (this->OpenEntry(m_dir + entry_name, reader, index))
+        {
+            this->LinkEntry(stat_name, entry_name);
+            m_hit_num++;
+            return true;
+        }
+    }
+
+    m_miss_num++;
+
+    SymbolIndex built_index(reader);
+    std::string extra;
+    built_index.Serialize(extra);
+
+    std::string data;
+    reader.WriteCompactImage(data, extra);
+
+    if (this->WriteEntry(entry_name, data) && !build_id.empty())
+    {
+        this->LinkEntry(stat_name, entry_name);
+    }
+
+    if (index != nullptr)
+    {
+        *index = std::move(built_index);
+    }
+    return true;
+}
+
+bool ELFCache::OpenEntry(const std::string &entry_path, ELFReader &reader, SymbolIndex *index)
+{
+    // 不存在是常态，先探测一下，避免 ReadELFFile 打印错误
+    if (access(entry_path.c_str(), R_OK) != 0)
+    {
+        return false;
+    }
+
+    ELFReader cached_reader;
+    if (!cached_reader.ReadELFFile(entry_path.c_str()))
+    {
+        return false;
+    }
+
+    size_t extra_size = 0;
+    const char *extra = cached_reader.GetCompactExtra(extra_size);
+    if (extra == nullptr)
+    {
+        return false; // 不是缓存条目
+    }
+
+    reader = cached_reader;
+    if (index != nullptr && !index->Attach(reader, extra, extra_size))
+    {
+        index->Build(reader); // 附加数据损坏时现建
+    }
+    return true;
+}
+
+bool ELFCache::WriteEntry(const std::string &entry_name, const std::string &data)
+{
+    std::string tmp_path = m_dir + ".tmp-" + entry_name + "-XXXXXX";
+    int fd = mkstemp(&tmp_path[0]);
+    if (fd < 0)
+    {
+        perror("ELFCache::WriteEntry mkstemp");
+        return false;
+    }
+
+    size_t written = 0;
+    while (written < data.size())
+    {
+        ssize_t n = write(fd, data.data() + written, data.size() - written);
+        if (n < 0)
+        {
+            if (errno == EINTR) continue;
+            break;
+        }
+        written += n;
+    }
+    fchmod(fd, 0644);
+    close(fd);
+
+    // rename 是原子的，并发写同一条目时后写者覆盖，内容相同
+    if (written != data.size() || rename(tmp_path.c_str(), (m_dir + entry_name).c_str()) != 0)
+    {
+        perror("ELFCache::WriteEntry");
+        unlink(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ELFCache::LinkEntry(const std::string &link_name, const std::string &entry_name)
+{
+    // 同样先建临时链接再 rename，避免与其他进程冲突
+    static std::atomic<unsigned long> s_link_seq(0);
+
+    char tmp_name[64] {};
+    snprintf(tmp_name, sizeof(tmp_name), ".tmp-link-%ld-%lu", static_cast<long>(getpid()), s_link_seq++);
+    std::string tmp_path = m_dir + tmp_name;
+
+    if (symlink(entry_name.c_str(), tmp_path.c_str()) != 0)
+    {
+        return false;
+    }
+    if (rename(tmp_path.c_str(), (m_dir + link_name).c_str()) != 0)
+    {
+        unlink(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include "ELFReader.h"
+#include "SymbolIndex.h"
+
+// 解析结果的磁盘缓存。每个条目是一个紧凑映像（见 ELFReader::WriteCompactImage），
+// 附加数据里存放序列化的 SymbolIndex，命中时 mmap 后直接使用，不再解析原文件。
+//
+// 条目名：
+// - bid-<build-id>-<段表散列>              有 GNU build-id 时
+// - st-<dev>-<inode>-<size>-<mtime>        没有 build-id 时
+// strip 前后的文件 build-id 相同而段表、.symtab 不同，因此 bid 条目名中还带上段表的散列，各自一个条目。
+// 有 build-id 的文件另建一个 st-... 符号链接指向 bid-... 条目，再次打开同一文件时只需一次 stat
+//
+// 条目先写入临时文件再 rename 到最终名字，多个进程同时读写同一缓存目录是安全的：
+// 读者要么看不到条目，要么看到完整的条目
+class ELFCache
+{
+public:
+    explicit ELFCache(const std::string &dir);
+
+    // 打开 path 对应的 ELF 文件：命中缓存时读取缓存，否则解析原文件并写入缓存。
+    // index 不为空时一并取得地址索引（未命中时现建）
+    bool Open(const char *path, ELFReader &reader, SymbolIndex *index);
+
+    long GetHitNum() const { return m_hit_num; }
+    long GetMissNum() const { return m_miss_num; }
+
+private:
+    bool OpenEntry(const std::string &entry_path, ELFReader &reader, SymbolIndex *index);
+    bool WriteEntry(const std::string &entry_name, const std::string &data);
+    bool LinkEntry(const std::string &link_name, const std::string &entry_name);
+
+private:
+    std::string m_dir;
+    std::atomic<long> m_hit_num;
+    std::atomic<long> m_miss_num;
+};
@@ -0,0 +1,238 @@
+#include "ELFCrawler.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+ELFCrawler::ELFCrawler(int thread_num) :
+    m_thread_num(thread_num < 1 ? 1 : thread_num),
+    m_pending_dirs(0), m_queued_dirs(0), m_scanned_file_num(0), m_scanned_dir_num(0),
+    m_failed_root_num(0)
+{
+    for (int i = 0; i < m_thread_num; i++)
+    {
+        m_queues.emplace_back(new WorkQueue);
+    }
+    m_thread_entries.resize(m_thread_num);
+}
+
+int ELFCrawler::Crawl(const std::vector<std::string> &roots)
+{
+    m_entries.clear();
+    m_root_dirs.clear();
+    m_failed_root_num = 0;
+
+    // 根目录轮流分给各线程，根为文件时直接判断；根用 stat，符号链接（如 merged-usr 下的 /lib）跟随
+    int next_worker = 0;
+    for (const std::string &root : roots)
+    {
+        struct stat st;
+        if (stat(root.c_str(), &st) != 0)
+        {
+            std::cerr << "ELFCrawler::Crawl: can not stat " << root << ": " << strerror(errno) << std::endl;
+            m_failed_root_num++;
+            continue;
+        }
+
+        if (S_ISDIR(st.st_mode))
+        {
+            if (m_root_dirs.insert(root).second)
+            {
+                this->PushDir(next_worker, root);
+                next_worker = (next_worker + 1) % m_thread_num;
+            }
+        }
+        else if (S_ISREG(st.st_mode))
+        {
+            this->TriageFile(0, AT_FDCWD, std::string(), root.c_str(), true);
+        }
+    }
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < m_thread_num; i++)
+    {
+        threads.emplace_back(&ELFCrawler::WorkerLoop, this, i);
+    }
+    for (std::thread &t : threads)
+    {
+        t.join();
+    }
+
+    for (std::vector<Entry> &entries : m_thread_entries)
+    {
+        m_entries.insert(m_entries.end(), std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()));
+        entries.clear();
+    }
+    std::sort(m_entries.begin(), m_entries.end(), [](const Entry &a, const Entry &b) { return a.path < b.path; });
+    return m_failed_root_num;
+}
+
+void ELFCrawler::WorkerLoop(int worker_id)
+{
+    std::string dir;
+    while (m_pending_dirs.load() > 0)
+    {
+        if (!this->PopDir(worker_id, dir))
+        {
+            // 暂时没有可偷的目录，但别的线程可能正在扫描并产生新目录，等到有目录入队或全部扫描完
+            std::unique_lock<std::mutex> lock(m_idle_mutex);
+            m_idle_cv.wait(lock, [this] { return m_queued_dirs.load() > 0 || m_pending_dirs.load() == 0; });
+            continue;
+        }
+
+        this->ScanDir(worker_id, dir);
+        if (--m_pending_dirs == 0)
+        {
+            std::lock_guard<std::mutex> lock(m_idle_mutex);
+            m_idle_cv.notify_all();
+        }
+    }
+}
+
+bool ELFCrawler::PopDir(int worker_id, std::string &dir)
+{
+    // 先取自己的队尾（刚发现的子目录，局部性更好）
+    {
+        WorkQueue &own = *m_queues[worker_id];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.dirs.empty())
+        {
+            dir = std::move(own.dirs.back());
+            own.dirs.pop_back();
+            m_queued_dirs--;
+            return true;
+        }
+    }
+
+    // 再从其他线程的队首偷（靠近树根，往往带着更大的子树）
+    for (int i = 1; i < m_thread_num; i++)
+    {
+        WorkQueue &victim = *m_queues[(worker_id + i) % m_thread_num];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.dirs.empty())
+        {
+            dir = std::move(victim.dirs.front());
+            victim.dirs.pop_front();
+            m_queued_dirs--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ELFCrawler::PushDir(int worker_id, std::string dir)
+{
+    m_pending_dirs++;
+
+    {
+        WorkQueue &own = *m_queues[worker_id];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.dirs.push_back(std::move(dir));
+    }
+
+    // 在 m_idle_mutex 下改计数，等待中的线程不会错过唤醒
+    {
+        std::lock_guard<std::mutex> lock(m_idle_mutex);
+        m_queued_dirs++;
+    }
+    m_idle_cv.notify_one();
+}
+
+void ELFCrawler::ScanDir(int worker_id, const std::string &dir)
+{
+    // 根目录本身可以是符号链接，遍历中的目录不跟随
+    bool is_root = m_root_dirs.count(dir) != 0;
+    int dir_fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC | (is_root ? 0 : O_NOFOLLOW));
+    if (dir_fd < 0)
+    {
+        // 子目录无权限等，跳过；根目录打不开则报错
+        if (is_root)
+        {
+            std::cerr << "ELFCrawler::Crawl: can not open " << dir << ": " << strerror(errno) << std::endl;
+            m_failed_root_num++;
+        }
+        return;
+    }
+
+    DIR *dp = fdopendir(dir_fd);
+    if (dp == nullptr)
+    {
+        close(dir_fd);
+        return;
+    }
+
+    m_scanned_dir_num++;
+
+    std::string prefix = dir;
+    if (prefix.empty() || prefix.back() != '/')
+    {
+        prefix += '/';
+    }
+
+    struct dirent *ent = nullptr;
+    while ((ent = readdir(dp)) != nullptr)
+    {
+        const char *name = ent->d_name;
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+        {
+            continue;
+        }
+
+        unsigned char d_type = ent->d_type;
+        if (d_type == DT_UNKNOWN)
+        {
+            // 部分文件系统不提供 d_type
+            struct stat st;
+            if (fstatat(dir_fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+            {
+                continue;
+            }
+            d_type = S_ISDIR(st.st_mode) ? DT_DIR : (S_ISREG(st.st_mode) ? DT_REG : DT_LNK);
+        }
+
+        if (d_type == DT_DIR)
+        {
+            this->PushDir(worker_id, prefix + name);
+        }
+        else if (d_type == DT_REG)
+        {
+            this->TriageFile(worker_id, dir_fd, prefix, name);
+        }
+    }
+
+    closedir(dp);
+}
+
+void ELFCrawler::TriageFile(int worker_id, int dir_fd, const std::string &prefix, const char *name, bool follow)
+{
+    m_scanned_file_num++;
+
+    int fd = openat(dir_fd, name, O_RDONLY | O_CLOEXEC | (follow ? 0 : O_NOFOLLOW) | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0)
+    {
+        // 只有根才跟随符号链接，此时打不开要报错
+        if (follow)
+        {
+            std::cerr << "ELFCrawler::Crawl: can not open " << prefix << name << ": " << strerror(errno) << std::endl;
+            m_failed_root_num++;
+        }
+        return;
+    }
+
+    Entry entry;
+    if (ELFReader::Triage(fd, entry.info))
+    {
+        entry.path = prefix + name; // 只为 ELF 文件拼路径
+        m_thread_entries[worker_id].push_back(std::move(entry));
+    }
+
+    close(fd);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "ELFReader.h"
+
+// 递归遍历目录树，找出所有 ELF 文件并根据文件头分类。
+// 每个工作线程有自己的目录队列，自己从队尾取，空闲时从其他线程的队首偷取（work stealing），
+// 都偷不到时在条件变量上等待新目录入队
+class ELFCrawler
+{
+public:
+    struct Entry
+    {
+        std::string path;
+        ELFReader::TriageInfo info;
+    };
+
+    explicit ELFCrawler(int thread_num);
+
+    // roots 可以是目录或文件；与 find -H 一样，作为根给出的符号链接跟随，遍历中遇到的不跟随。
+    // 无法访问的根在 stderr 上报错，返回出错的根的个数
+    int Crawl(const std::vector<std::string> &roots);
+
+    // 按路径排序的所有 ELF 文件
+    const std::vector<Entry> &GetEntries() const { return m_entries; }
+
+    long GetScannedFileNum() const { return m_scanned_file_num; }
+    long GetScannedDirNum() const { return m_scanned_dir_num; }
+
+private:
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<std::string> dirs;
+    };
+
+    void WorkerLoop(int worker_id);
+    bool PopDir(int worker_id, std::string &dir);
+    void PushDir(int worker_id, std::string dir);
+    void ScanDir(int worker_id, const std::string &dir);
+    void TriageFile(int worker_id, int dir_fd, const std::string &prefix, const char *name, bool follow = false);
+
+private:
+    int m_thread_num;
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    std::vector<std::vector<Entry>> m_thread_entries;   // 每个线程各自收集，结束后合并
+    std::atomic<long> m_pending_dirs;                   // 已入队但未扫描完的目录数，为 0 时结束
+    std::atomic<long> m_queued_dirs;                    // 还在队列中、未被取走的目录数
+    std::mutex m_idle_mutex;                            // 保护空闲线程的等待条件，配合 m_idle_cv
+    std::condition_variable m_idle_cv;
+    std::atomic<long> m_scanned_file_num;
+    std::atomic<long> m_scanned_dir_num;
+    std::unordered_set<std::string> m_root_dirs;        // 作为根的目录，打开时跟随符号链接，遍历期间只读
+    std::atomic<int> m_failed_root_num;
+    std::vector<Entry> m_entries;
+};
@@ -0,0 +1,417 @@
+#include "ELFDiff.h"
+#include "ELFReader.h"
+#include "Demangler.h"
+#include "NumberFormat.h"
+#include "formattedtable.hpp"
+
+#include <algorithm>
+#include <map>
+
+namespace
+{
+    bool IsStringTag(int64_t tag)
+    {
+        return tag == DT_NEEDED || tag == DT_SONAME || tag == DT_RPATH || tag == DT_RUNPATH;
+    }
+
+    // 带符号的差值，增长带 '+'
+    std::string FormatDelta(int64_t delta)
+    {
+        char buffer[NUMBER_MAX_LEN + 1];
+        char *p = buffer;
+        if (delta > 0)
+        {
+            *p++ = '+';
+        }
+        return std::string(buffer, NumberFormat::FormatInt(p, delta));
+    }
+
+    // 按计数归并两边的 map，只保留有变化的
+    template <typename Key, typename GetName>
+    void MergeCounts(const std::map<Key, uint64_t> &old_counts, const std::map<Key, uint64_t> &new_counts,
+        GetName get_name, std::vector<ELFDiff::CountChange> &changes)
+    {
+        auto old_it = old_counts.begin();
+        auto new_it = new_counts.begin();
+        while (old_it != old_counts.end() || new_it != new_counts.end())
+        {
+            ELFDiff::CountChange change;
+            if (new_it == new_counts.end() || (old_it != old_counts.end() && old_it->first < new_it->first))
+            {
+                change = { get_name(old_it->first), old_it->second, 0 };
+                ++old_it;
+            }
+            else if (old_it == old_counts.end() || new_it->first < old_it->first)
+            {
+                change = { get_name(new_it->first), 0, new_it->second };
+                ++new_it;
+            }
+            else
+            {
+                change = { get_name(old_it->first), old_it->second, new_it->second };
+                ++old_it;
+                ++new_it;
+            }
+            if (change.old_num != change.new_num)
+            {
+                changes.push_back(std::move(change));
+            }
+        }
+    }
+
+    template <typename T>
+    void SortByDelta(std::vector<T> &changes)
+    {
+        std::stable_sort(changes.begin(), changes.end(), [](const T &a, const T &b) { return a.delta() > b.delta(); });
+    }
+}
+
+ELFDiff::ELFDiff(const ELFReader &old_reader, const ELFReader &new_reader) : m_old(old_reader), m_new(new_reader)
+{
+    this->CompareSections();
+    this->CompareSymbols();
+    this->CompareRelocations();
+    this->CompareDynamics();
+    this->MakeSummary();
+
+    SortByDelta(m_section_changes);
+    SortByDelta(m_symbol_changes);
+    SortByDelta(m_relocation_changes);
+    SortByDelta(m_dynamic_changes);
+}
+
+void ELFDiff::MergeSizes(const std::vector<SizeItem> &old_items, const std::vector<SizeItem> &new_items,
+    std::vector<SizeChange> &changes)
+{
+    std::size_t i = 0, j = 0;
+    while (i < old_items.size() || j < new_items.size())
+    {
+        // 同名的一段在两边依次配对，多出来的算增加或删除
+        int cmp = 0;
+        if (i == old_items.size()) cmp = 1;
+        else if (j == new_items.size()) cmp = -1;
+        else cmp = old_items[i].name.compare(new_items[j].name);
+
+        if (cmp < 0)
+        {
+            changes.push_back(SizeChange { old_items[i].table, old_items[i].name, old_items[i].size, 0, true, false });
+            i++;
+        }
+        else if (cmp > 0)
+        {
+            changes.push_back(SizeChange { new_items[j].table, new_items[j].name, 0, new_items[j].size, false, true });
+            j++;
+        }
+        else
+        {
+            if (old_items[i].size != new_items[j].size)
+            {
+                changes.push_back(SizeChange { new_items[j].table, old_items[i].name, old_items[i].size, new_items[j].size, true, true });
+            }
+            i++;
+            j++;
+        }
+    }
+}
+
+void ELFDiff::CompareSections()
+{
+    std::vector<SizeItem> old_items, new_items;
+    for (auto *side : { &old_items, &new_items })
+    {
+        const ELFReader &reader = side == &old_items ? m_old : m_new;
+        for (const ELFReader::Section &section : reader.GetSections())
+        {
+            if (section.section_header.sh_type != SHT_NULL)
+            {
+                side->push_back(SizeItem { section.get_name(reader), section.section_header.sh_size, "" });
+            }
+        }
+        std::sort(side->begin(), side->end());
+    }
+    MergeSizes(old_items, new_items, m_section_changes);
+}
+
+void ELFDiff::CollectSymbols(const ELFReader &reader, std::vector<SizeItem> &items)
+{
+    items.clear();
+    items.reserve(reader.GetSymbols().size() + reader.GetDynSyms().size());
+
+    auto collect = [&items](const TableView<ELFReader::Symbol> &symbols, const StrTable &strs, const char *table,
+        const std::vector<SizeItem> *exclude)
+    {
+        for (const ELFReader::Symbol &symbol : symbols)
+        {
+            int type = symbol.get_sym_type();
+            if (type == STT_SECTION || type == STT_FILE || symbol.sym.st_name == 0)
+            {
+                continue;
+            }
+            std::string_view name = strs.view(symbol.sym.st_name);
+            if (exclude != nullptr && std::binary_search(exclude->begin(), exclude->end(), SizeItem { name, 0, "" },
+                [](const SizeItem &a, const SizeItem &b) { return a.name < b.name; }))
+            {
+                continue;
+            }
+            items.push_back(SizeItem { name, symbol.sym.st_size, table });
+        }
+    };
+
+    // 每个名字只比较一次：优先 .symtab，.dynsym 只补上 .symtab 中没有的（如 strip 过的文件）
+    collect(reader.GetSymbols(), reader.GetSymbolStrs(), ".symtab", nullptr);
+    std::sort(items.begin(), items.end());
+    std::vector<SizeItem> symtab_items(items);
+    collect(reader.GetDynSyms(), reader.GetDynamicStrs(), ".dynsym", &symtab_items);
+    std::sort(items.begin(), items.end());
+}
+
+void ELFDiff::CompareSymbols()
+{
+    std::vector<SizeItem> old_items, new_items;
+    CollectSymbols(m_old, old_items);
+    CollectSymbols(m_new, new_items);
+    MergeSizes(old_items, new_items, m_symbol_changes);
+}
+
+void ELFDiff::CompareRelocations()
+{
+    std::map<int, uint64_t> old_counts, new_counts;
+    for (auto *counts : { &old_counts, &new_counts })
+    {
+        const ELFReader &reader = counts == &old_counts ? m_old : m_new;
+        for (const ELFReader::RelocationTable &table : reader.GetRelocations())
+        {
+            for (const ELFReader::Relocation &relocation : table.relocations)
+            {
+                (*counts)[relocation.get_type()]++;
+            }
+        }
+        // .relr.dyn 的相对重定位不在 GetRelocations() 中
+        uint64_t relr_num = reader.GetRelrRelocationNum();
+        if (relr_num > 0)
+        {
+            (*counts)[ELFReader::RELOCATION_TYPE_RELR] += relr_num;
+        }
+    }
+
+    // 类型编号随架构而定，按新文件的架构取名字
+    const uint16_t machine = m_new.GetHeader().e_machine;
+    MergeCounts(old_counts, new_counts, [machine](int type)
+    {
+        const char *name = ELFReader::GetRelocationTypeName(machine, type);
+        return name != nullptr ? std::string(name) : std::to_string(type);
+    }, m_relocation_changes);
+}
+
+void ELFDiff::CollectValues(const ELFReader &reader, std::vector<ValueItem> &items)
+{
+    const StrTable &strs = reader.GetDynamicStrs();
+    for (const ELFReader::Dynamic &dynamic : reader.GetDynamics())
+    {
+        const Elf64_Dyn &dyn = dynamic.dyn;
+        if (IsStringTag(dyn.d_tag) && dyn.d_un.d_val < strs.size())
+        {
+            items.push_back(ValueItem { dyn.d_tag, strs.view(dyn.d_un.d_val) });
+        }
+    }
+    std::sort(items.begin(), items.end());
+}
+
+void ELFDiff::CompareDynamics()
+{
+    std::map<int64_t, uint64_t> old_counts, new_counts;
+    for (auto *counts : { &old_counts, &new_counts })
+    {
+        const ELFReader &reader = counts == &old_counts ? m_old : m_new;
+        for (const ELFReader::Dynamic &dynamic : reader.GetDynamics())
+        {
+            if (dynamic.dyn.d_tag != DT_NULL)
+            {
+                (*counts)[dynamic.dyn.d_tag]++;
+            }
+        }
+    }
+
+    MergeCounts(old_counts, new_counts, [](int64_t tag)
+    {
+        const char *name = ELFReader::GetDynamicTagName(tag);
+        if (name != nullptr)
+        {
+            return std::string(name);
+        }
+        char buffer[NUMBER_MAX_LEN];
+        return std::string(buffer, NumberFormat::FormatHex(buffer, static_cast<uint64_t>(tag)));
+    }, m_dynamic_changes);
+
+    // 字符串项按 (tag, 值) 归并
+    std::vector<ValueItem> old_items, new_items;
+    CollectValues(m_old, old_items);
+    CollectValues(m_new, new_items);
+    std::size_t i = 0, j = 0;
+    while (i < old_items.size() || j < new_items.size())
+    {
+        if (j == new_items.size() || (i < old_items.size() && old_items[i] < new_items[j]))
+        {
+            m_value_changes.push_back(ValueChange { ELFReader::GetDynamicTagName(old_items[i].tag), old_items[i].value, false });
+            i++;
+        }
+        else if (i == old_items.size() || new_items[j] < old_items[i])
+        {
+            m_value_changes.push_back(ValueChange { ELFReader::GetDynamicTagName(new_items[j].tag), new_items[j].value, true });
+            j++;
+        }
+        else
+        {
+            i++;
+            j++;
+        }
+    }
+}
+
+void ELFDiff::MakeSummary()
+{
+    for (const ELFReader *reader : { &m_old, &m_new })
+    {
+        uint64_t alloc_size = 0, file_size = 0, relocation_num = 0, needed_num = 0;
+        for (const ELFReader::Section &section : reader->GetSections())
+        {
+            const Elf64_Shdr &header = section.section_header;
+            if (header.sh_flags & SHF_ALLOC)
+            {
+                alloc_size += header.sh_size;
+            }
+            if (header.sh_type != SHT_NOBITS)
+            {
+                file_size += header.sh_size;
+            }
+        }
+        for (const ELFReader::RelocationTable &table : reader->GetRelocations())
+        {
+            relocation_num += table.relocations.size();
+        }
+        relocation_num += reader->GetRelrRelocationNum();
+        for (const ELFReader::Dynamic &dynamic : reader->GetDynamics())
+        {
+            needed_num += dynamic.dyn.d_tag == DT_NEEDED;
+        }
+
+        const uint64_t values[] = {
+            alloc_size, file_size, reader->GetSections().size(), reader->GetSymbols().size(),
+            reader->GetDynSyms().size(), relocation_num, needed_num,
+        };
+        static const char *const names[] = {
+            "Allocated bytes", "Section bytes in file", "Sections", ".symtab symbols",
+            ".dynsym symbols", "Relocations", "DT_NEEDED",
+        };
+
+        bool is_old = reader == &m_old;
+        for (std::size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+        {
+            if (is_old)
+            {
+                m_summary.push_back(CountChange { names[i], values[i], 0 });
+            }
+            else
+            {
+                m_summary[i].new_num = values[i];
+            }
+        }
+    }
+}
+
+void ELFDiff::Print(std::ostream &os, std::size_t top) const
+{
+    FormattedTable summary;
+    summary.SetFieldList({ "Metric", "Old", "New", "Delta" });
+    for (const CountChange &change : m_summary)
+    {
+        summary.AddRow(change.name, change.old_num, change.new_num, FormatDelta(change.delta()));
+    }
+    os << "summary:\n" << summary.GetFormattedTable() << "\n";
+
+    // 段与符号：先给出各类的条数与字节数，再列出增长最多的 top 项
+    auto print_sizes = [&os, top, this](const char *title, const std::vector<SizeChange> &changes, bool is_symbol)
+    {
+        uint64_t num[3] = { 0, 0, 0 };  // 增加、删除、大小变化
+        int64_t bytes[3] = { 0, 0, 0 };
+        for (const SizeChange &change : changes)
+        {
+            int kind = !change.in_old ? 0 : (!change.in_new ? 1 : 2);
+            num[kind]++;
+            bytes[kind] += change.delta();
+        }
+        os << title << ": " << num[0] << " added (" << FormatDelta(bytes[0]) << " bytes), " << num[1] << " removed ("
+            << FormatDelta(bytes[1]) << " bytes), " << num[2] << " resized (" << FormatDelta(bytes[2]) << " bytes)\n";
+        if (changes.empty())
+        {
+            os << "\n";
+            return;
+        }
+
+        FormattedTable ftable;
+        if (is_symbol)
+        {
+            ftable.SetFieldList({ "Table", "Symbol", "Old Size", "New Size", "Delta", "Change" });
+        }
+        else
+        {
+            ftable.SetFieldList({ "Section", "Old Size", "New Size", "Delta", "Change" });
+        }
+        std::size_t row_num = std::min(top, changes.size());
+        for (std::size_t i = 0; i < row_num; i++)
+        {
+            const SizeChange &change = changes[i];
+            const char *kind = !change.in_old ? "added" : (!change.in_new ? "removed" : "resized");
+            ftable.BeginRow();
+            if (is_symbol)
+            {
+                ftable.AddCell(change.table);
+                ftable.AddCell(m_demangler != nullptr ? m_demangler->Demangle(change.name) : change.name);
+            }
+            else
+            {
+                ftable.AddCell(change.name);
+            }
+            ftable.AddCell(change.old_size);
+            ftable.AddCell(change.new_size);
+            ftable.AddCell(FormatDelta(change.delta()));
+            ftable.AddCell(kind);
+        }
+        os << ftable.GetFormattedTable() << "\n";
+        if (row_num < changes.size())
+        {
+            os << "(" << changes.size() - row_num << " more)\n";
+        }
+        os << "\n";
+    };
+    print_sizes("sections", m_section_changes, false);
+    print_sizes("symbols", m_symbol_changes, true);
+
+    auto print_counts = [&os](const char *title, const char *field, const std::vector<CountChange> &changes)
+    {
+        if (changes.empty())
+        {
+            return;
+        }
+        FormattedTable ftable;
+        ftable.SetFieldList({ field, "Old", "New", "Delta" });
+        for (const CountChange &change : changes)
+        {
+            ftable.AddRow(change.name, change.old_num, change.new_num, FormatDelta(change.delta()));
+        }
+        os << title << ":\n" << ftable.GetFormattedTable() << "\n";
+    };
+    print_counts("relocations by type", "Type", m_relocation_changes);
+    print_counts("dynamic entries by tag", "Tag", m_dynamic_changes);
+
+    if (!m_value_changes.empty())
+    {
+        FormattedTable ftable;
+        ftable.SetFieldList({ "Tag", "Value", "Change" });
+        for (const ValueChange &change : m_value_changes)
+        {
+            ftable.AddRow(change.tag, change.value, change.added ? "added" : "removed");
+        }
+        os << "dynamic values:\n" << ftable.GetFormattedTable() << "\n";
+    }
+}
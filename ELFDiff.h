@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class ELFReader;
+class Demangler;
+
+// 两个 ELF 文件的结构差异：段按名字比较大小，符号按名字比较（增加、删除、大小变化），每个名字只比较一次，
+// 优先取 .symtab 中的，.symtab 中没有的才取 .dynsym 中的；
+// 重定位按类型比较条数，dynamic 表项按 tag 比较条数，DT_NEEDED 等字符串项按值比较。
+// 每一类都是两边各排序一次再归并一次，百万级符号也只是两次排序加一次线性扫描。
+//
+// 名字直接引用两个 reader 中的字符串表，reader 须在本对象使用期间有效
+class ELFDiff
+{
+public:
+    // 同名的段或符号有多个时（如不同文件中的局部符号），按大小排序后依次配对
+    struct SizeChange
+    {
+        const char *table;      // 段为空，符号为 ".symtab" / ".dynsym"（两边都有时取新文件的）
+        std::string_view name;
+        uint64_t old_size;
+        uint64_t new_size;
+        bool in_old;
+        bool in_new;
+
+        int64_t delta() const { return static_cast<int64_t>(new_size - old_size); }
+    };
+
+    struct CountChange
+    {
+        std::string name;
+        uint64_t old_num;
+        uint64_t new_num;
+
+        int64_t delta() const { return static_cast<int64_t>(new_num - old_num); }
+    };
+
+    // DT_NEEDED、DT_SONAME、DT_RPATH、DT_RUNPATH 中只在一边出现的值
+    struct ValueChange
+    {
+        const char *tag;
+        std::string_view value;
+        bool added;
+    };
+
+    ELFDiff(const ELFReader &old_reader, const ELFReader &new_reader);
+
+    // 以下结果都按 delta 从大到小排列，增长最多的在前，只含有变化的项
+    const std::vector<CountChange> &GetSummary() const { return m_summary; } // 总量，固定顺序，含没有变化的项
+    const std::vector<SizeChange> &GetSectionChanges() const { return m_section_changes; }
+    const std::vector<SizeChange> &GetSymbolChanges() const { return m_symbol_changes; }
+    const std::vector<CountChange> &GetRelocationChanges() const { return m_relocation_changes; }
+    const std::vector<CountChange> &GetDynamicChanges() const { return m_dynamic_changes; }
+    const std::vector<ValueChange> &GetValueChanges() const { return m_value_changes; }
+
+    // 输出排好序的摘要，段与符号各只列增长最多的 top 项
+    void Print(std::ostream &os, std::size_t top) const;
+
+    // 不为空时 Print 输出反修饰后的符号名
+    void SetDemangler(Demangler *demangler) { m_demangler = demangler; }
+
+private:
+    struct SizeItem
+    {
+        std::string_view name;
+        uint64_t size;
+        const char *table;
+
+        bool operator<(const SizeItem &other) const
+        {
+            return name != other.name ? name < other.name : size < other.size;
+        }
+    };
+
+    struct ValueItem
+    {
+        int64_t tag;
+        std::string_view value;
+
+        bool operator<(const ValueItem &other) const
+        {
+            return tag != other.tag ? tag < other.tag : value < other.value;
+        }
+    };
+
+    void CompareSections();
+    void CompareSymbols();
+    void CompareRelocations();
+    void CompareDynamics();
+    void MakeSummary();
+
+    // 两边都已排序，按名字归并，同名的按顺序配对；只在一边的与大小不同的加入 changes
+    static void MergeSizes(const std::vector<SizeItem> &old_items, const std::vector<SizeItem> &new_items,
+        std::vector<SizeChange> &changes);
+
+    // .symtab 的符号加上 .symtab 中没有同名符号的 .dynsym 符号，按名字排序
+    static void CollectSymbols(const ELFReader &reader, std::vector<SizeItem> &items);
+    static void CollectValues(const ELFReader &reader, std::vector<ValueItem> &items);
+
+private:
+    const ELFReader &m_old;
+    const ELFReader &m_new;
+    Demangler *m_demangler = nullptr;
+
+    std::vector<CountChange> m_summary;
+    std::vector<SizeChange> m_section_changes;
+    std::vector<SizeChange> m_symbol_changes;
+    std::vector<CountChange> m_relocation_changes;
+    std::vector<CountChange> m_dynamic_changes;
+    std::vector<ValueChange> m_value_changes;
+};
@@ -1,18 +1,30 @@
 #include "ELFPrinter.h"
 #include "ELFReader.h"
+#include "SymbolIndex.h"
+#include "LineIndex.h"
+#include "SymbolStore.h"
+#include "StartupAnalyzer.h"
+#include "Demangler.h"
+#include "NumberFormat.h"
 #include "formattedtable.hpp"
 
-static std::string DecToHex(long decimal)
+// 有名字时输出名字，否则输出数值（未知的类型、绑定）
+static void AddNameCell(FormattedTable &ftable, const char *name, long number)
 {
-	char buffer[1024] {};
-	snprintf(buffer, sizeof(buffer), "0x%lx", decimal);
-	return buffer;
+    if (name != nullptr)
+    {
+        ftable.AddCell(name);
+    }
+    else
+    {
+        ftable.AddCell(number);
+    }
 }
 
 void ELFPrinter::PrintAll() const
 {
-    std::cout << "ELF class: " << m_elf_reader->GetELFClass() << "\n";
-    std::cout << "ELF type: " << m_elf_reader->GetELFType() << "\n";
+    *m_os << "ELF class: " << m_elf_reader->GetELFClass() << "\n";
+    *m_os << "ELF type: " << m_elf_reader->GetELFType() << "\n";
 
     this->PrintSections();
     this->PrintSymbols();
@@ -22,65 +34,100 @@ void ELFPrinter::PrintAll() const
 
 void ELFPrinter::PrintSections() const
 {
-    std::cout << this->GetSectionsString() << std::endl;
+    this->WriteSections(*m_os);
+    *m_os << std::endl;
 }
 
 void ELFPrinter::PrintSymbols() const
 {
-    std::cout << this->GetSymbolString() << std::endl;
+    this->WriteSymbols(*m_os);
+    *m_os << std::endl;
 }
 
 void ELFPrinter::PrintRelocations() const
 {
-    std::cout << this->GetRelocationString() << std::endl;
+    this->WriteRelocations(*m_os);
+    *m_os << std::endl;
 }
 
 void ELFPrinter::PrintDynamics() const
 {
-    std::cout << this->GetDynamicString() << std::endl;
+    this->WriteDynamics(*m_os);
+    *m_os << std::endl;
+}
+
+void ELFPrinter::PrintAddresses(const std::vector<uint64_t> &addrs) const
+{
+    this->WriteAddresses(*m_os, addrs);
+    *m_os << std::endl;
+}
+
+void ELFPrinter::PrintHashTables() const
+{
+    this->WriteHashTables(*m_os);
+    *m_os << std::endl;
 }
 
-std::string ELFPrinter::GetSectionsString() const
+void ELFPrinter::PrintStartupCost() const
 {
-    std::ostringstream oss;
+    this->WriteStartupCost(*m_os);
+    *m_os << std::endl;
+}
 
-    const std::vector<ELFReader::Section> &sections = m_elf_reader->GetSections();
+void ELFPrinter::WriteSections(std::ostream &os) const
+{
+    const TableView<ELFReader::Section> &sections = m_elf_reader->GetSections();
 
-    oss << "ELF section num: " << sections.size() << "\n";
+    os << "ELF section num: " << sections.size() << "\n";
 	{
-    	oss << "sections:\n";
+    	os << "sections:\n";
 		FormattedTable ftable;
 		ftable.SetFieldList({ "Number", "Type", "Name", "Flags", "Virtual Address", "File Offset", "Section Size", "Entry Size" });
-		for (const ELFReader::Section &section : sections)
+		ftable.Stream(os, [&ftable, &sections, this]()
 		{
-            std::string flags;
-            if (section.section_header.sh_flags & SHF_WRITE) flags += "SHF_WRITE ";
-            if (section.section_header.sh_flags & SHF_ALLOC) flags += "SHF_ALLOC ";
-            if (section.section_header.sh_flags & SHF_EXECINSTR) flags += "SHF_EXECINSTR ";
-
-			ftable.AddRow(section.number, section.section_header.sh_type, section.get_name(*m_elf_reader), flags, DecToHex(section.section_header.sh_addr), section.section_header.sh_offset, section.section_header.sh_size, section.section_header.sh_entsize);
-		}
-		oss << ftable.GetFormattedTable() << "\n";
+			for (const ELFReader::Section &section : sections)
+			{
+                char flags[64];
+                char *p = flags;
+                auto add_flag = [&p](std::string_view flag) { p = std::copy(flag.begin(), flag.end(), p); };
+                if (section.section_header.sh_flags & SHF_WRITE) add_flag("SHF_WRITE ");
+                if (section.section_header.sh_flags & SHF_ALLOC) add_flag("SHF_ALLOC ");
+                if (section.section_header.sh_flags & SHF_EXECINSTR) add_flag("SHF_EXECINSTR ");
+
+				ftable.AddRow(section.get_number(*m_elf_reader), section.section_header.sh_type, section.get_name(*m_elf_reader), std::string_view(flags, p - flags), Hex(section.section_header.sh_addr), section.section_header.sh_offset, section.section_header.sh_size, section.section_header.sh_entsize);
+			}
+		});
+		os << "\n";
 	}
-	oss << "\n";
-
-    return oss.str();
+	os << "\n";
 }
 
-std::string ELFPrinter::GetSymbolString() const
+void ELFPrinter::WriteSymbols(std::ostream &os) const
 {
-    std::ostringstream oss;
+    SymbolStore store;
+    std::vector<uint32_t> indexes;
 
-    auto build = [&oss, this](const std::string &symtable_name, const std::vector<ELFReader::Symbol> &symbols, bool is_dyn)
+    auto build = [&os, &store, &indexes, this](const std::string &symtable_name, const TableView<ELFReader::Symbol> &symbols, bool is_dyn)
     {
-        oss << symtable_name << " num: " << symbols.size() << "\n";
+        os << symtable_name << " num: " << symbols.size();
+        if (m_symbol_filter != nullptr)
+        {
+            // 有筛选条件时先在列式存储上选出符号下标，只输出这些符号
+            store.Build(*m_elf_reader, is_dyn);
+            store.Select(*m_symbol_filter, indexes);
+            os << ", matched: " << indexes.size();
+        }
+        os << "\n";
+        if (m_demangler != nullptr)
+        {
+            m_demangler->Prepare(*m_elf_reader, symbols, is_dyn);
+        }
         {
             FormattedTable ftable;
             ftable.SetFieldList({ "index", "Type", "Bind", "Section", "Name", "Value", "Size" });
-            int index = 0;
-            for (const ELFReader::Symbol &symbol_item : symbols)
+            auto add_row = [&ftable, is_dyn, this](std::size_t index, const ELFReader::Symbol &symbol_item)
             {
-                std::string sym_name;
+                std::string_view sym_name;
                 if (is_dyn)
                 {
                     sym_name = symbol_item.get_dynsym_name(*m_elf_reader);
@@ -89,93 +136,113 @@ std::string ELFPrinter::GetSymbolString() const
                 {
                     sym_name = symbol_item.get_sym_name(*m_elf_reader);
                 }
-                if (sym_name.length() > 30)
+                if (m_demangler != nullptr)
+                {
+                    sym_name = m_demangler->Demangle(sym_name);
+                }
+                else if (sym_name.length() > 30)
                 {
+                    // 只截取视图，不拷贝名字
                     sym_name = sym_name.substr(0, 30);
                 }
 
-                ftable.AddRow(index, symbol_item.get_sym_type_desc(), symbol_item.get_sym_bind_desc(), symbol_item.get_sym_section_desc(*m_elf_reader), sym_name, DecToHex(symbol_item.sym.st_value), symbol_item.sym.st_size);
-                index++;
-            }
-            oss << "symbols:\n" << ftable.GetFormattedTable() << "\n";
+                ftable.BeginRow();
+                ftable.AddCell(index);
+                AddNameCell(ftable, symbol_item.get_sym_type_name(), symbol_item.get_sym_type());
+                AddNameCell(ftable, symbol_item.get_sym_bind_name(), symbol_item.get_sym_bind());
+                ftable.AddCell(symbol_item.get_sym_section_desc(*m_elf_reader));
+                ftable.AddCell(sym_name);
+                ftable.AddCell(Hex(symbol_item.sym.st_value));
+                ftable.AddCell(symbol_item.sym.st_size);
+            };
+
+            os << "symbols:\n";
+            ftable.Stream(os, [&add_row, &symbols, &indexes, this]()
+            {
+                if (m_symbol_filter != nullptr)
+                {
+                    for (uint32_t index : indexes)
+                    {
+                        add_row(index, symbols[index]);
+                    }
+                }
+                else
+                {
+                    for (std::size_t index = 0; index < symbols.size(); index++)
+                    {
+                        add_row(index, symbols[index]);
+                    }
+                }
+            });
+            os << "\n";
         }
-        oss << "\n";
+        os << "\n";
     };
 
     build(".symtab", m_elf_reader->GetSymbols(), false);
     build(".dynsym", m_elf_reader->GetDynSyms(), true);
-
-    return oss.str();
 }
 
-std::string ELFPrinter::GetRelocationString() const
+void ELFPrinter::WriteRelocations(std::ostream &os) const
 {
-    std::ostringstream oss;
-
-    const std::map<std::string, std::vector<ELFReader::Relocation>> &relocations = m_elf_reader->GetRelocations();
-
-    for (const auto &rel_section : relocations)
+    // 每个重定位段的符号已在加载时按 sh_link 关联好，这里逐行直接取；不认识的类型输出数值
+    const uint16_t machine = m_elf_reader->GetHeader().e_machine;
+    for (const ELFReader::RelocationTable &table : m_elf_reader->GetRelocations())
 	{
-		const std::string &section_name = rel_section.first;
-		const auto &relocations = rel_section.second;
+		const auto &relocations = table.relocations;
 
-		oss << section_name << " relocation num: " << relocations.size() << "\n";
+		os << table.get_name(*m_elf_reader) << " relocation num: " << relocations.size() << "\n";
 		{
 			FormattedTable ftable;
 			ftable.SetFieldList({ "Offset", "Type", "Symbol Name", "Type", "Bind", "Section" });
-			for (const ELFReader::Relocation &rel_item : relocations)
+			os << "relocations:\n";
+			ftable.Stream(os, [&ftable, &table, &relocations, machine, this]()
 			{
-                const ELFReader::Symbol *symbol = nullptr;
-                std::string symbol_name;
-
-                if (section_name == ".rela.dyn" || section_name == ".rela.plt")
-                {
-                    symbol_name = rel_item.get_dynsym_name(*m_elf_reader);
-
-                    if (rel_item.symbol_index >= 0 && rel_item.symbol_index < static_cast<int>(m_elf_reader->GetDynSyms().size()))
+				for (std::size_t i = 0; i < relocations.size(); i++)
+				{
+                    const ELFReader::Relocation &rel_item = relocations[i];
+                    const ELFReader::Symbol *symbol = table.symbols[i];
+
+                    ftable.BeginRow();
+                    ftable.AddCell(Hex(rel_item.rel.r_offset));
+                    AddNameCell(ftable, ELFReader::GetRelocationTypeName(machine, rel_item.get_type()), rel_item.get_type());
+                    if (nullptr == symbol)
                     {
-                        symbol = &m_elf_reader->GetDynSyms().at(rel_item.symbol_index);
+                        // 没有符号表（如 sh_link 为 0）或符号下标越界
+                        continue;
                     }
-                }
-                else if (section_name == ".rela.text")
-                {
-                    symbol_name = rel_item.get_symbol_name(*m_elf_reader);
 
-                    if (rel_item.symbol_index >= 0 && rel_item.symbol_index < static_cast<int>(m_elf_reader->GetSymbols().size()))
+                    std::string_view symbol_name = table.get_symbol_name(*m_elf_reader, i);
+                    if (m_demangler != nullptr)
                     {
-                        symbol = &m_elf_reader->GetSymbols().at(rel_item.symbol_index);
+                        symbol_name = m_demangler->Demangle(symbol_name);
                     }
-                }
 
-                if (nullptr != symbol)
-                {
-                    ftable.AddRow(DecToHex(rel_item.rel.r_offset), rel_item.get_type_desc(), symbol_name,
-                        symbol->get_sym_type_desc(), symbol->get_sym_bind_desc(), symbol->get_sym_section_desc(*m_elf_reader));
-                }
-                
-			}
-			oss << "relocations:\n" << ftable.GetFormattedTable() << "\n";
+                    ftable.AddCell(symbol_name);
+                    AddNameCell(ftable, symbol->get_sym_type_name(), symbol->get_sym_type());
+                    AddNameCell(ftable, symbol->get_sym_bind_name(), symbol->get_sym_bind());
+                    ftable.AddCell(symbol->get_sym_section_desc(*m_elf_reader));
+				}
+			});
+			os << "\n";
 		}
 
-		oss << "\n";
+		os << "\n";
 	}
-
-    return oss.str();
 }
 
-std::string ELFPrinter::GetDynamicString() const
+void ELFPrinter::WriteDynamics(std::ostream &os) const
 {
-    std::ostringstream oss;
-
-    const std::vector<ELFReader::Dynamic> &dynamics = m_elf_reader->GetDynamics();
+    const TableView<ELFReader::Dynamic> &dynamics = m_elf_reader->GetDynamics();
 
-    oss << "dynamic num: " << dynamics.size() << "\n";
+    os << "dynamic num: " << dynamics.size() << "\n";
     FormattedTable ftable;
     ftable.SetFieldList({ "Tag", "Value" });
     for (const auto &dynamic_item : dynamics)
 	{
-		std::string tag = "";
-        std::string value = "";
+        // 值按 tag 的含义输出：地址为十六进制，大小为十进制，名字为 .dynstr 中的字符串
+        enum { VALUE_HEX, VALUE_DEC, VALUE_STR } value_type = VALUE_HEX;
+		const char *tag = nullptr;
 
         const Elf64_Dyn &dyn = dynamic_item.dyn;
 
@@ -183,86 +250,305 @@ std::string ELFPrinter::GetDynamicString() const
         {
         case DT_SYMTAB:
             tag = "DT_SYMTAB";
-            value = DecToHex(dyn.d_un.d_ptr);
             break;
 
         case DT_STRTAB:
             tag = "DT_STRTAB";
-            value = DecToHex(dyn.d_un.d_ptr);
             break;
 
         case DT_STRSZ:
             tag = "DT_STRSZ";
-            value = std::to_string(dyn.d_un.d_val);
+            value_type = VALUE_DEC;
             break;
 
         case DT_HASH:
             tag = "DT_HASH";
-            value = DecToHex(dyn.d_un.d_ptr);
+            break;
+
+        case DT_GNU_HASH:
+            tag = "DT_GNU_HASH";
             break;
 
         case DT_SONAME:
             tag = "DT_SONAME";
-            value = &m_elf_reader->GetDynamicStrs().at(dyn.d_un.d_val);
+            value_type = VALUE_STR;
             break;
 
         case DT_RPATH:
             tag = "DT_RPATH";
-            value = &m_elf_reader->GetDynamicStrs().at(dyn.d_un.d_val);
+            value_type = VALUE_STR;
             break;
 
         case DT_INIT:
             tag = "DT_INIT";
-            value = DecToHex(dyn.d_un.d_ptr);
             break;
 
         case DT_FINI:
             tag = "DT_FINI";
-            value = DecToHex(dyn.d_un.d_ptr);
             break;
 
         case DT_NEEDED:
             tag = "DT_NEEDED";
-            value = &m_elf_reader->GetDynamicStrs().at(dyn.d_un.d_val);
+            value_type = VALUE_STR;
             break;
 
         case DT_REL:
             tag = "DT_REL";
-            value = DecToHex(dyn.d_un.d_ptr);
             break;
 
         case DT_RELA:
             tag = "DT_RELA";
-            value = DecToHex(dyn.d_un.d_ptr);
             break;
-        
+
         case DT_RELENT:
             tag = "DT_RELENT";
-            value = std::to_string(dyn.d_un.d_val);
+            value_type = VALUE_DEC;
             break;
 
         case DT_RELAENT:
             tag = "DT_RELAENT";
-            value = std::to_string(dyn.d_un.d_val);
+            value_type = VALUE_DEC;
             break;
 
         case DT_PLTGOT:
             tag = "DT_PLTGOT";
-            value = DecToHex(dyn.d_un.d_ptr);
             break;
 
         default:
-            tag = std::to_string(dyn.d_tag);
-            value = std::to_string(dyn.d_un.d_ptr);
             break;
         }
-		
-        ftable.AddRow(tag, value);
+
+        ftable.BeginRow();
+        if (tag == nullptr)
+        {
+            ftable.AddCell(dyn.d_tag);
+            ftable.AddCell(dyn.d_un.d_ptr);
+            continue;
+        }
+
+        ftable.AddCell(tag);
+        switch (value_type)
+        {
+        case VALUE_HEX:
+            ftable.AddCell(Hex(dyn.d_un.d_ptr));
+            break;
+
+        case VALUE_DEC:
+            ftable.AddCell(dyn.d_un.d_val);
+            break;
+
+        case VALUE_STR:
+            ftable.AddCell(&m_elf_reader->GetDynamicStrs().at(dyn.d_un.d_val));
+            break;
+        }
 	}
 
-    oss << "dynamics:\n" << ftable.GetFormattedTable() << "\n";
+    os << "dynamics:\n" << ftable.GetFormattedTable() << "\n";
+
+    os << "\n";
+}
+
+void ELFPrinter::WriteAddresses(std::ostream &os, const std::vector<uint64_t> &addrs) const
+{
+    SymbolIndex built_index;
+    if (m_symbol_index == nullptr)
+    {
+        built_index.Build(*m_elf_reader);
+    }
+    const SymbolIndex &index = m_symbol_index != nullptr ? *m_symbol_index : built_index;
+
+    // 有 .debug_line 时多输出一列源码位置，只解码查到的编译单元
+    LineIndex line_index(*m_elf_reader);
+    const bool with_source = line_index.HasLineInfo();
+
+    os << "indexed symbol num: " << index.GetSymbolNum() << "\n";
+    FormattedTable ftable;
+    if (with_source)
+    {
+        ftable.SetFieldList({ "Address", "Symbol", "Offset", "Symbol Address", "Symbol Size", "Source" });
+    }
+    else
+    {
+        ftable.SetFieldList({ "Address", "Symbol", "Offset", "Symbol Address", "Symbol Size" });
+    }
+    std::string source;
+    for (uint64_t addr : addrs)
+    {
+        if (with_source)
+        {
+            LineIndex::Match line = line_index.LookupAddress(addr);
+            source = line.found() ? std::string(line.file) + ":" + std::to_string(line.line) : "??";
+        }
+
+        SymbolIndex::Match match = index.LookupAddress(addr);
+        if (match.found())
+        {
+            std::string_view name = match.name;
+            if (m_demangler != nullptr)
+            {
+                name = m_demangler->Demangle(name);
+            }
+            if (with_source)
+            {
+                ftable.AddRow(Hex(addr), name, Hex(match.offset), Hex(match.start), match.size, source);
+            }
+            else
+            {
+                ftable.AddRow(Hex(addr), name, Hex(match.offset), Hex(match.start), match.size);
+            }
+        }
+        else if (with_source)
+        {
+            ftable.AddRow(Hex(addr), "??", "", "", "", source);
+        }
+        else
+        {
+            ftable.AddRow(Hex(addr), "??", "", "", "");
+        }
+    }
+    os << "addresses:\n" << ftable.GetFormattedTable() << "\n";
+
+    os << "\n";
+}
+
+void ELFPrinter::WriteHashTables(std::ostream &os) const
+{
+    const std::vector<ELFReader::HashTableStats> stats_list = m_elf_reader->GetHashTableStats();
+
+    os << "hash table num: " << stats_list.size() << "\n";
+    for (const ELFReader::HashTableStats &stats : stats_list)
+    {
+        uint32_t used_bucket_num = stats.bucket_num - stats.empty_bucket_num;
 
-    oss << "\n";
+        os << stats.kind << ":\n";
+        os << "buckets: " << stats.bucket_num << ", empty: " << stats.empty_bucket_num
+            << ", symbols: " << stats.symbol_num << ", max chain: " << stats.max_chain_len;
+        if (used_bucket_num > 0)
+        {
+            os << ", avg chain (non-empty): " << static_cast<double>(stats.symbol_num) / used_bucket_num;
+        }
+        os << "\n";
 
-    return oss.str();
+        if (stats.bloom_word_num > 0)
+        {
+            // 置位比例越高，布隆过滤器能挡掉的不存在符号越少
+            os << "bloom words: " << stats.bloom_word_num << ", bits set: " << stats.bloom_bits_set
+                << " (" << 100.0 * stats.bloom_bits_set / (stats.bloom_word_num * 64.0) << "%)\n";
+        }
+
+        FormattedTable ftable;
+        ftable.SetFieldList({ "Chain Length", "Buckets", "% of Buckets", "% of Symbols" });
+        for (std::size_t len = 0; len < stats.chain_len_histogram.size(); len++)
+        {
+            uint32_t bucket_num = stats.chain_len_histogram[len];
+            if (bucket_num == 0)
+            {
+                continue;
+            }
+
+            double symbol_pct = stats.symbol_num == 0 ? 0 : 100.0 * len * bucket_num / stats.symbol_num;
+            ftable.AddRow(len, bucket_num, 100.0 * bucket_num / stats.bucket_num, symbol_pct);
+        }
+        os << "chain length distribution:\n" << ftable.GetFormattedTable() << "\n";
+        os << "\n";
+    }
+}
+
+// 按位输出标志名，未知的位合并成十六进制
+static void WriteFlags(std::ostream &os, uint64_t flags, const std::initializer_list<std::pair<uint64_t, const char*>> &names)
+{
+    if (flags == 0)
+    {
+        os << "0";
+        return;
+    }
+
+    const char *sep = "";
+    for (const auto &name : names)
+    {
+        if (flags & name.first)
+        {
+            os << sep << name.second;
+            sep = " ";
+            flags &= ~name.first;
+        }
+    }
+    if (flags != 0)
+    {
+        os << sep << Hex(flags);
+    }
+}
+
+void ELFPrinter::WriteStartupCost(std::ostream &os) const
+{
+    StartupAnalyzer analyzer(*m_elf_reader);
+    if (!analyzer.IsDynamic())
+    {
+        os << "startup cost: not dynamically linked\n";
+        return;
+    }
+
+    os << "startup cost score: " << analyzer.GetScore() << "\n";
+    os << "BIND_NOW: " << (analyzer.IsBindNow() ? "yes" : "no") << ", TEXTREL: " << (analyzer.HasTextRel() ? "yes" : "no")
+        << ", DT_GNU_HASH: " << (analyzer.HasGnuHash() ? "yes" : "no") << "\n";
+    os << "DT_FLAGS: ";
+    WriteFlags(os, analyzer.GetFlags(), { { DF_ORIGIN, "ORIGIN" }, { DF_SYMBOLIC, "SYMBOLIC" }, { DF_TEXTREL, "TEXTREL" },
+        { DF_BIND_NOW, "BIND_NOW" }, { DF_STATIC_TLS, "STATIC_TLS" } });
+    os << ", DT_FLAGS_1: ";
+    WriteFlags(os, analyzer.GetFlags1(), { { DF_1_NOW, "NOW" }, { DF_1_GLOBAL, "GLOBAL" }, { DF_1_NODELETE, "NODELETE" },
+        { DF_1_INITFIRST, "INITFIRST" }, { DF_1_NOOPEN, "NOOPEN" }, { DF_1_ORIGIN, "ORIGIN" }, { DF_1_PIE, "PIE" } });
+    os << "\n";
+    os << "DT_NEEDED: " << analyzer.GetNeededNum() << ", exported symbols: " << analyzer.GetExportedNum()
+        << ", imported symbols: " << analyzer.GetImportedNum() << "\n";
+    os << "constructors: DT_INIT " << analyzer.GetInitNum() << ", DT_INIT_ARRAY " << analyzer.GetInitArrayNum()
+        << ", DT_PREINIT_ARRAY " << analyzer.GetPreinitArrayNum() << "\n";
+
+    os << "dynamic relocation num: " << analyzer.GetRelocationNum() << ", distinct symbols looked up at load time: "
+        << analyzer.GetSymbolLookupNum() << "\n";
+    FormattedTable ftable;
+    ftable.SetFieldList({ "Type", "Kind", "Count" });
+    for (const StartupAnalyzer::TypeCount &item : analyzer.GetTypeCounts())
+    {
+        ftable.BeginRow();
+        AddNameCell(ftable, ELFReader::GetRelocationTypeName(m_elf_reader->GetHeader().e_machine, item.type), item.type);
+        ftable.AddCell(StartupAnalyzer::GetKindName(item.kind));
+        ftable.AddCell(item.num);
+    }
+    os << "dynamic relocations by type:\n" << ftable.GetFormattedTable() << "\n";
+
+    // 指向本文件内定义的符号：链接时加 -Bsymbolic(-functions) 或把符号设为隐藏，就不必在运行时查找
+    const std::vector<StartupAnalyzer::SymbolCount> &targets = analyzer.GetLocalSymbolicTargets();
+    os << "symbolic relocations against symbols defined in this file: " << analyzer.GetLocalSymbolicNum()
+        << " (" << targets.size() << " symbols), could be relative with -Bsymbolic or hidden visibility\n";
+    if (!targets.empty())
+    {
+        const std::size_t TOP_NUM = 10;
+        FormattedTable target_table;
+        target_table.SetFieldList({ "Symbol", "Relocations" });
+        for (std::size_t i = 0; i < targets.size() && i < TOP_NUM; i++)
+        {
+            std::string_view name = targets[i].name;
+            if (m_demangler != nullptr)
+            {
+                name = m_demangler->Demangle(name);
+            }
+            target_table.AddRow(name, targets[i].num);
+        }
+        os << target_table.GetFormattedTable() << "\n";
+        if (targets.size() > TOP_NUM)
+        {
+            os << "(" << targets.size() - TOP_NUM << " more)\n";
+        }
+    }
+    os << "lazy PLT relocations against functions defined in this file: " << analyzer.GetLocalLazyNum()
+        << ", bound on first call, could be direct calls with -Bsymbolic-functions or hidden visibility\n";
+
+    FormattedTable cost_table;
+    cost_table.SetFieldList({ "Item", "Count", "Weight", "Cost" });
+    for (const StartupAnalyzer::CostItem &item : analyzer.GetCostItems())
+    {
+        cost_table.AddRow(item.name, item.num, item.weight, item.cost());
+    }
+    cost_table.AddRow("total", "", "", analyzer.GetScore());
+    os << "estimated cost:\n" << cost_table.GetFormattedTable() << "\n";
 }
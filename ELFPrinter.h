@@ -1,29 +1,58 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <iostream>
 
 class ELFReader;
+class SymbolIndex;
+struct SymbolFilter;
+class Demangler;
 
 class ELFPrinter
 {
 public:
-    ELFPrinter(ELFReader *elf_reader) : m_elf_reader(elf_reader)
+    // os 为输出目标，默认标准输出；批量模式下每个工作线程输出到自己的缓冲里
+    ELFPrinter(ELFReader *elf_reader, std::ostream &os = std::cout) : m_elf_reader(elf_reader), m_os(&os)
     {
 
     }
 
+    void SetOutput(std::ostream &os) { m_os = &os; }
+
+    // 设置现成的地址索引（如来自缓存），不设置时 PrintAddresses 会现建一个
+    void SetSymbolIndex(const SymbolIndex *symbol_index) { m_symbol_index = symbol_index; }
+
+    // 设置符号筛选条件，打印符号表时只输出满足条件的符号，为空时输出全部
+    void SetSymbolFilter(const SymbolFilter *symbol_filter) { m_symbol_filter = symbol_filter; }
+
+    // 设置后符号名与重定位目标输出反修饰后的完整名字（-C），为空时输出原名并截断到 30 个字符
+    void SetDemangler(Demangler *demangler) { m_demangler = demangler; }
+
     void PrintAll() const;
 
     void PrintSections() const;
     void PrintSymbols() const;
     void PrintRelocations() const;
     void PrintDynamics() const;
+    void PrintAddresses(const std::vector<uint64_t> &addrs) const; // 地址 -> 符号+偏移
+    void PrintHashTables() const; // .gnu.hash / .hash 的分布情况
+    void PrintStartupCost() const; // 动态链接的启动开销：重定位分类、标志、构造函数与估计得分
 
 private:
-    std::string GetSectionsString() const;
-    std::string GetSymbolString() const;
-    std::string GetRelocationString() const;
-    std::string GetDynamicString() const;
+    // 各表直接写到 os，大表逐行流式输出，不先拼成整个字符串
+    void WriteSections(std::ostream &os) const;
+    void WriteSymbols(std::ostream &os) const;
+    void WriteRelocations(std::ostream &os) const;
+    void WriteDynamics(std::ostream &os) const;
+    void WriteAddresses(std::ostream &os, const std::vector<uint64_t> &addrs) const;
+    void WriteHashTables(std::ostream &os) const;
+    void WriteStartupCost(std::ostream &os) const;
 
     ELFReader *m_elf_reader;
+    std::ostream *m_os;
+    const SymbolIndex *m_symbol_index = nullptr;
+    const SymbolFilter *m_symbol_filter = nullptr;
+    Demangler *m_demangler = nullptr;
 };
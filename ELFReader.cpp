@@ -1,332 +1,1891 @@
 #include "ELFReader.h"
 
 #include <cstring>
-#include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <sstream>
 
-class FilePosRAII
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static_assert(sizeof(ELFReader::Section) == sizeof(Elf64_Shdr), "Section 须与 Elf64_Shdr 内存布局一致");
+static_assert(sizeof(ELFReader::Symbol) == sizeof(Elf64_Sym), "Symbol 须与 Elf64_Sym 内存布局一致");
+static_assert(sizeof(ELFReader::Relocation) == sizeof(Elf64_Rela), "Relocation 须与 Elf64_Rela 内存布局一致");
+static_assert(sizeof(ELFReader::Dynamic) == sizeof(Elf64_Dyn), "Dynamic 须与 Elf64_Dyn 内存布局一致");
+
+// 持有一段 mmap 映射，最后一个引用释放时 munmap
+struct MappedRegion
 {
-public:
-    FilePosRAII(const FilePosRAII&) = delete;
-    FilePosRAII &operator=(const FilePosRAII&) = delete;
-    FilePosRAII(FILE *fp) : m_fp(fp)
+    MappedRegion(const MappedRegion&) = delete;
+    MappedRegion &operator=(const MappedRegion&) = delete;
+    MappedRegion(void *addr, size_t size) : addr(addr), size(size) {}
+    ~MappedRegion()
     {
-        m_old_pos = ftell(fp);
+        this->Unmap();
     }
-    ~FilePosRAII()
+
+    void Unmap()
     {
-        fseek(m_fp, m_old_pos, SEEK_SET);
+        if (addr != nullptr)
+        {
+            munmap(addr, size);
+            addr = nullptr;
+            size = 0;
+        }
     }
 
-private:
-    FILE *m_fp;
-    long m_old_pos;
+    void *addr;
+    size_t size;
 };
 
-bool ELFReader::ReadELFFile(FILE *fp)
+// 映射整个文件到 region（region 非空时复用该对象），返回 false 表示无法映射（如管道、空文件）
+static bool MapFile(int fd, std::shared_ptr<MappedRegion> &region, const char *&image, size_t &file_sz)
 {
-    if (fp == nullptr)
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0)
     {
         return false;
     }
 
-    fseek(fp, 0, SEEK_END);
-    long file_sz = ftell(fp);
-    rewind(fp);
-
-    char header_bytes[5] {};
-
-    if (file_sz < static_cast<long>(sizeof(header_bytes)))
+    void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED)
     {
-        std::cerr << "ELFReader::ReadELFFile failed: file size not correct" << std::endl;
         return false;
     }
 
-    if (fread(&header_bytes, sizeof(header_bytes), 1, fp) != 1)
+    image = static_cast<const char*>(addr);
+    file_sz = st.st_size;
+    if (region)
     {
-        perror("ELFReader::ReadELFFile failed: fread failed");
-        return false;
+        region->addr = addr;
+        region->size = file_sz;
     }
-    
-    // 前四个字节为魔数：0x7F 0x45 0x4c 0x46, 用以识别文件是否为 ELF 文件
-    if (!(header_bytes[0] == 0x7f && 
-        header_bytes[1] == 'E' && 
-        header_bytes[2] == 'L' && 
-        header_bytes[3] == 'F'))
+    else
     {
-        std::cerr << "ELFReader::ReadELFFile failed: This file is not an elf file" << std::endl;
-        return false;
+        region = std::make_shared<MappedRegion>(addr, file_sz);
     }
+    return true;
+}
 
-    // 第五个字节表示 ELF 文件类
-    switch (header_bytes[4])
-    {
-        case 0x01:
-            std::cerr << "ELFReader::ReadELFFile failed: This file is not an elf64 file" << std::endl; // 我们只研究64位程序
-            return false;
-            break;
+// 紧凑映像的头部，其后各块均按 8 字节对齐
+struct CompactHeader
+{
+    char magic[8];
+    uint64_t section_num;
+    uint64_t ehdr_offset;
+    uint64_t shdr_offset;
+    uint64_t data_offsets_offset;
+    uint64_t extra_offset;
+    uint64_t extra_size;
+};
 
-        case 0x02:
-            // ELF64
-            break;
+static const char COMPACT_MAGIC[8] = { 'E', 'L', 'F', 'R', 'C', 'M', 'P', '1' };
+static const uint64_t NO_SECTION_DATA = UINT64_MAX;
 
-        default:
-            std::cerr << "ELFReader::ReadELFFile failed: This file is not an elf64 file 2" << std::endl;
-            return false;
-            break;
-    }
+// 按 8 字节对齐追加数据，返回数据的起始偏移
+static uint64_t AppendAligned(std::string &out, const void *data, size_t size)
+{
+    out.resize((out.size() + 7) & ~static_cast<size_t>(7), '\0');
+    uint64_t offset = out.size();
+    out.append(static_cast<const char*>(data), size);
+    return offset;
+}
 
-    // 64位程序的 ELF Header 定义
-    Elf64_Ehdr header_struct;
+// 各类别的原始记录类型；ELF32 的 r_info 中符号下标与类型的划分不同，解码时换成 ELF64 的划分
+template <unsigned char elf_class>
+struct ElfTypes;
+
+template <>
+struct ElfTypes<ELFCLASS32>
+{
+    typedef Elf32_Ehdr Ehdr;
+    typedef Elf32_Shdr Shdr;
+    typedef Elf32_Phdr Phdr;
+    typedef Elf32_Sym Sym;
+    typedef Elf32_Rela Rela;
+    typedef Elf32_Rel Rel;
+    typedef Elf32_Dyn Dyn;
+
+    static Elf64_Xword RelocationInfo(Elf32_Word info) { return ELF64_R_INFO(ELF32_R_SYM(info), ELF32_R_TYPE(info)); }
+};
+
+template <>
+struct ElfTypes<ELFCLASS64>
+{
+    typedef Elf64_Ehdr Ehdr;
+    typedef Elf64_Shdr Shdr;
+    typedef Elf64_Phdr Phdr;
+    typedef Elf64_Sym Sym;
+    typedef Elf64_Rela Rela;
+    typedef Elf64_Rel Rel;
+    typedef Elf64_Dyn Dyn;
+
+    static Elf64_Xword RelocationInfo(Elf64_Xword info) { return info; }
+};
 
-    if (file_sz < static_cast<long>(sizeof(header_struct)))
+// 取一个字段，swap 在编译期确定，不交换时什么也不做
+template <bool swap, typename T>
+static inline T Load(T value)
+{
+    if constexpr (!swap || sizeof(T) == 1)
     {
-        std::cerr << "ELFReader::ReadELFFile failed: file size not correct 2" << std::endl;
-        return false;
+        return value;
     }
-
-    rewind(fp);
-    if (fread(&header_struct, sizeof(header_struct), 1, fp) != 1)
+    else if constexpr (sizeof(T) == 2)
     {
-        perror("ELFReader::ReadELFFile failed: fread failed 2");
-        return false;
+        return static_cast<T>(__builtin_bswap16(static_cast<uint16_t>(value)));
     }
-
-    if (header_struct.e_machine != EM_X86_64)
+    else if constexpr (sizeof(T) == 4)
     {
-        std::cerr << "ELFReader::ReadELFFile failed: 文件不是 x86_64 架构" << std::endl; // 我们只研究 X86_64 架构的程序
-        return false;
+        return static_cast<T>(__builtin_bswap32(static_cast<uint32_t>(value)));
+    }
+    else
+    {
+        return static_cast<T>(__builtin_bswap64(static_cast<uint64_t>(value)));
     }
+}
 
-    ELFReader tmp_elf_header;
-    tmp_elf_header.m_header = header_struct;
+// 把一种布局的原始记录逐条展开为 Elf64 记录。每个实例只处理一种布局，循环里没有按类别、字节序的分支
+template <unsigned char elf_class, bool swap>
+struct RecordDecoder
+{
+    typedef ElfTypes<elf_class> Types;
 
-    if (fseek(fp, header_struct.e_shoff, SEEK_SET) != 0 )
+    // 原始记录未必对齐，逐条拷出再取字段
+    template <typename Raw>
+    static Raw Fetch(const char *data, size_t i)
     {
-        std::cerr << "ELFReader::ReadELFFile failed: can not read section header table" << std::endl;
-        return false;
+        Raw raw;
+        memcpy(&raw, data + i * sizeof(Raw), sizeof(Raw));
+        return raw;
     }
 
-    for (int i = 0; i < header_struct.e_shnum; i++)
+    static void DecodeHeader(const char *data, Elf64_Ehdr &header)
     {
-        Elf64_Shdr section_struct;
-        if (fread(&section_struct, sizeof(section_struct), 1, fp) != 1)
+        const typename Types::Ehdr raw = Fetch<typename Types::Ehdr>(data, 0);
+        memcpy(header.e_ident, raw.e_ident, sizeof(header.e_ident));
+        header.e_type = Load<swap>(raw.e_type);
+        header.e_machine = Load<swap>(raw.e_machine);
+        header.e_version = Load<swap>(raw.e_version);
+        header.e_entry = Load<swap>(raw.e_entry);
+        header.e_phoff = Load<swap>(raw.e_phoff);
+        header.e_shoff = Load<swap>(raw.e_shoff);
+        header.e_flags = Load<swap>(raw.e_flags);
+        header.e_ehsize = Load<swap>(raw.e_ehsize);
+        header.e_phentsize = Load<swap>(raw.e_phentsize);
+        header.e_phnum = Load<swap>(raw.e_phnum);
+        header.e_shentsize = Load<swap>(raw.e_shentsize);
+        header.e_shnum = Load<swap>(raw.e_shnum);
+        header.e_shstrndx = Load<swap>(raw.e_shstrndx);
+    }
+
+    static void DecodeSections(const char *data, size_t num, void *out)
+    {
+        ELFReader::Section *sections = static_cast<ELFReader::Section*>(out);
+        for (size_t i = 0; i < num; i++)
         {
-            perror("ELFReader::ReadELFFile failed: can not read section header table");
-            return false;
+            const typename Types::Shdr raw = Fetch<typename Types::Shdr>(data, i);
+            Elf64_Shdr &header = sections[i].section_header;
+            header.sh_name = Load<swap>(raw.sh_name);
+            header.sh_type = Load<swap>(raw.sh_type);
+            header.sh_flags = Load<swap>(raw.sh_flags);
+            header.sh_addr = Load<swap>(raw.sh_addr);
+            header.sh_offset = Load<swap>(raw.sh_offset);
+            header.sh_size = Load<swap>(raw.sh_size);
+            header.sh_link = Load<swap>(raw.sh_link);
+            header.sh_info = Load<swap>(raw.sh_info);
+            header.sh_addralign = Load<swap>(raw.sh_addralign);
+            header.sh_entsize = Load<swap>(raw.sh_entsize);
         }
-        
-        Section section;
-        section.section_header = section_struct;
-        section.number = i;
-        tmp_elf_header.m_sections.push_back(section);
     }
 
-    // 读段表字符串表（.shstrtab）
+    static void DecodeProgramHeaders(const char *data, size_t num, void *out)
     {
-        const Section &section = tmp_elf_header.m_sections.at(header_struct.e_shstrndx);
-        if (!ELFReader::ReadStrTable(fp, section.section_header, tmp_elf_header.m_shstrs))
+        Elf64_Phdr *phdrs = static_cast<Elf64_Phdr*>(out);
+        for (size_t i = 0; i < num; i++)
         {
-            std::cerr << "ELFReader::ReadELFFile failed: ReadStrTable .shstrtab failed" << std::endl;
-            return false;
+            const typename Types::Phdr raw = Fetch<typename Types::Phdr>(data, i);
+            Elf64_Phdr &phdr = phdrs[i];
+            phdr.p_type = Load<swap>(raw.p_type);
+            phdr.p_flags = Load<swap>(raw.p_flags);
+            phdr.p_offset = Load<swap>(raw.p_offset);
+            phdr.p_vaddr = Load<swap>(raw.p_vaddr);
+            phdr.p_paddr = Load<swap>(raw.p_paddr);
+            phdr.p_filesz = Load<swap>(raw.p_filesz);
+            phdr.p_memsz = Load<swap>(raw.p_memsz);
+            phdr.p_align = Load<swap>(raw.p_align);
         }
     }
 
-    // 读字符串表（.strtab）
-    for (size_t i = 0; i < tmp_elf_header.m_sections.size(); i++)
+    static void DecodeSymbols(const char *data, size_t num, void *out)
     {
-        const Section &section = tmp_elf_header.m_sections[i];
+        ELFReader::Symbol *symbols = static_cast<ELFReader::Symbol*>(out);
+        for (size_t i = 0; i < num; i++)
+        {
+            const typename Types::Sym raw = Fetch<typename Types::Sym>(data, i);
+            Elf64_Sym &sym = symbols[i].sym;
+            sym.st_name = Load<swap>(raw.st_name);
+            sym.st_info = raw.st_info;
+            sym.st_other = raw.st_other;
+            sym.st_shndx = Load<swap>(raw.st_shndx);
+            sym.st_value = Load<swap>(raw.st_value);
+            sym.st_size = Load<swap>(raw.st_size);
+        }
+    }
 
-        if (section.section_header.sh_type == SHT_STRTAB)
+    static void DecodeRelas(const char *data, size_t num, void *out)
+    {
+        ELFReader::Relocation *relocations = static_cast<ELFReader::Relocation*>(out);
+        for (size_t i = 0; i < num; i++)
         {
-            if (strcmp(section.get_name(tmp_elf_header), ".strtab") == 0)
-            {
-                if (!ELFReader::ReadStrTable(fp, section.section_header, tmp_elf_header.m_strs))
-                {
-                    std::cerr << "ELFReader::ReadELFFile failed: ReadStrTable .strtab failed" << std::endl;
-                    return false;
-                }
-            }
-            else if (strcmp(section.get_name(tmp_elf_header), ".dynstr") == 0)
-            {
-                if (!ELFReader::ReadStrTable(fp, section.section_header, tmp_elf_header.m_dynstrs))
-                {
-                    std::cerr << "ELFReader::ReadELFFile failed: ReadStrTable .dynstr failed" << std::endl;
-                    return false;
-                }
-            }
-        }        
+            const typename Types::Rela raw = Fetch<typename Types::Rela>(data, i);
+            Elf64_Rela &rel = relocations[i].rel;
+            rel.r_offset = Load<swap>(raw.r_offset);
+            rel.r_info = Types::RelocationInfo(Load<swap>(raw.r_info));
+            rel.r_addend = Load<swap>(raw.r_addend);
+        }
     }
 
-    for (const Section &section : tmp_elf_header.m_sections)
+    static void DecodeRels(const char *data, size_t num, void *out)
     {
-        switch (section.section_header.sh_type)
+        ELFReader::Relocation *relocations = static_cast<ELFReader::Relocation*>(out);
+        for (size_t i = 0; i < num; i++)
         {
-            case SHT_SYMTAB:
-                // 读符号表信息
-                if (!ELFReader::ReadSymbolTable(fp, section.section_header, tmp_elf_header.m_symbols))
-                {
-                    std::cerr << "ELFReader::ReadELFFile failed: ReadSymbolTable failed" << std::endl;
-                    return false;
-                }
-                break;
+            const typename Types::Rel raw = Fetch<typename Types::Rel>(data, i);
+            Elf64_Rela &rel = relocations[i].rel;
+            rel.r_offset = Load<swap>(raw.r_offset);
+            rel.r_info = Types::RelocationInfo(Load<swap>(raw.r_info));
+            rel.r_addend = 0;
+        }
+    }
 
-            case SHT_DYNSYM:
-                // 读动态库符号表信息
-                if (!ELFReader::ReadSymbolTable(fp, section.section_header, tmp_elf_header.m_dynsyms))
-                {
-                    std::cerr << "ELFReader::ReadELFFile failed: ReadSymbolTable for .dynsym failed" << std::endl;
-                    return false;
-                }
-                break;
+    static void DecodeDynamics(const char *data, size_t num, void *out)
+    {
+        ELFReader::Dynamic *dynamics = static_cast<ELFReader::Dynamic*>(out);
+        for (size_t i = 0; i < num; i++)
+        {
+            const typename Types::Dyn raw = Fetch<typename Types::Dyn>(data, i);
+            Elf64_Dyn &dyn = dynamics[i].dyn;
+            dyn.d_tag = Load<swap>(raw.d_tag);
+            dyn.d_un.d_val = Load<swap>(raw.d_un.d_val);
         }
     }
+};
 
-    for (const Section &section : tmp_elf_header.m_sections)
-	{
-		switch (section.section_header.sh_type)
-		{
-			case SHT_RELA:
-				// 读重定位表信息
-				if (!tmp_elf_header.ReadRelocationTable(fp, section.section_header, section.get_name(tmp_elf_header)))
-				{
-					std::cerr << "ELFReader::ReadlELFHeader failed: ReaedRelocationTable failed" << std::endl;
-					return false;
-				}
-				break;
-		}
-	}
+struct ELFReader::Layout
+{
+    bool native;        // 本机字节序的 ELF64，记录可以直接在映像上原地访问
+    bool swap;          // 字节序与本机相反
+    std::size_t header_size;
+    void (*decode_header)(const char *data, Elf64_Ehdr &header);
+    std::size_t entry_sizes[RECORD_KIND_NUM];
+    void (*decoders[RECORD_KIND_NUM])(const char *data, std::size_t num, void *out);
+};
 
-    for (const Section &section : tmp_elf_header.m_sections)
-	{
-		switch (section.section_header.sh_type)
-		{
-			case SHT_DYNAMIC:
-				// 读 dynamic 表信息
-				if (!tmp_elf_header.ReadDynamicTable(fp, section.section_header))
-				{
-					std::cerr << "ELFReader::ReadlELFHeader failed: ReadDynamicTable failed" << std::endl;
-					return false;
-				}
-				break;
-		}
-	}
+template <unsigned char elf_class, bool swap>
+const ELFReader::Layout &ELFReader::GetLayout()
+{
+    typedef ElfTypes<elf_class> Types;
+    typedef RecordDecoder<elf_class, swap> Decoder;
 
-    *this = tmp_elf_header;
-    return true;
+    static const Layout layout = {
+        elf_class == ELFCLASS64 && !swap,
+        swap,
+        sizeof(typename Types::Ehdr),
+        &Decoder::DecodeHeader,
+        {
+            sizeof(typename Types::Shdr),
+            sizeof(typename Types::Phdr),
+            sizeof(typename Types::Sym),
+            sizeof(typename Types::Rela),
+            sizeof(typename Types::Rel),
+            sizeof(typename Types::Dyn),
+        },
+        {
+            &Decoder::DecodeSections,
+            &Decoder::DecodeProgramHeaders,
+            &Decoder::DecodeSymbols,
+            &Decoder::DecodeRelas,
+            &Decoder::DecodeRels,
+            &Decoder::DecodeDynamics,
+        },
+    };
+    return layout;
 }
 
-bool ELFReader::ReadStrTable(FILE *fp, const Elf64_Shdr &section_header, std::string &str_table)
+const ELFReader::Layout *ELFReader::SelectLayout(unsigned char elf_class, unsigned char data)
 {
-    FilePosRAII fpraii(fp);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    const unsigned char native_data = ELFDATA2LSB;
+#else
+    const unsigned char native_data = ELFDATA2MSB;
+#endif
 
-    fseek(fp, section_header.sh_offset, SEEK_SET);
+    if (data != ELFDATA2LSB && data != ELFDATA2MSB)
+    {
+        return nullptr;
+    }
+    const bool swap = data != native_data;
 
-    str_table.clear();
-    for (size_t i = 0; i < section_header.sh_size; ++i)
+    switch (elf_class)
     {
-        int c = fgetc(fp);
-        str_table.push_back((char)c);
+        case ELFCLASS32:
+            return swap ? &GetLayout<ELFCLASS32, true>() : &GetLayout<ELFCLASS32, false>();
+
+        case ELFCLASS64:
+            return swap ? &GetLayout<ELFCLASS64, true>() : &GetLayout<ELFCLASS64, false>();
+
+        default:
+            return nullptr;
     }
+}
 
-    return true;
+void ELFReader::Reset()
+{
+    // 可复用的内存先取出来，其余成员整体恢复默认值
+    std::vector<RelocationTable> relocations;
+    relocations.swap(m_relocations);
+    relocations.clear();
+
+    std::shared_ptr<Arena> arena;
+    if (m_arena.use_count() == 1)
+    {
+        arena.swap(m_arena);
+        arena->Reset();
+    }
+
+    m_image_holder.reset();
+    std::shared_ptr<MappedRegion> region;
+    if (m_mapped_region.use_count() == 1)
+    {
+        region.swap(m_mapped_region);
+        region->Unmap();
+    }
+
+    *this = ELFReader();
+
+    m_relocations.swap(relocations);
+    m_arena.swap(arena);
+    m_mapped_region.swap(region);
+}
+
+Arena &ELFReader::GetArena() const
+{
+    if (!m_arena)
+    {
+        m_arena = std::make_shared<Arena>();
+    }
+    return *m_arena;
 }
 
-bool ELFReader::ReadSymbolTable(FILE *fp, const Elf64_Shdr &section_header, std::vector<Symbol> &symbols)
+bool ELFReader::ReadELFFile(FILE *fp)
 {
-    FilePosRAII fpraii(fp);
+    this->Reset();
+    if (fp == nullptr)
+    {
+        return false;
+    }
+
+    const char *image = nullptr;
+    size_t file_sz = 0;
+    if (MapFile(fileno(fp), m_mapped_region, image, file_sz))
+    {
+        return this->ParseImage(image, file_sz, m_mapped_region);
+    }
+
+    // 无法映射时整块读入内存
+    std::shared_ptr<std::string> buffer = std::make_shared<std::string>();
+    char chunk[64 * 1024];
+    size_t n = 0;
+    while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0)
+    {
+        buffer->append(chunk, n);
+    }
+    if (ferror(fp))
+    {
+        perror("ELFReader::ReadELFFile failed: fread failed");
+        return false;
+    }
 
-    assert(section_header.sh_entsize == sizeof(Elf64_Sym));
+    return this->ParseImage(buffer->data(), buffer->size(), buffer);
+}
 
-    int entry_num = section_header.sh_size / section_header.sh_entsize;
+bool ELFReader::ReadELFFile(const char *path)
+{
+    this->Reset();
+    if (path == nullptr)
+    {
+        return false;
+    }
 
-    fseek(fp, section_header.sh_offset, SEEK_SET);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        perror("ELFReader::ReadELFFile failed: open");
+        return false;
+    }
 
-    for (int i = 0; i < entry_num; i++)
+    const char *image = nullptr;
+    size_t file_sz = 0;
+    if (!MapFile(fd, m_mapped_region, image, file_sz))
     {
-        Elf64_Sym sym;
-        if (fread(&sym, sizeof(sym), 1, fp) != 1)
+        // 不是普通文件，走 FILE* 的读入路径
+        FILE *fp = fdopen(fd, "r");
+        if (fp == nullptr)
         {
-            perror("ELFReader::ReadSymbolTable failed: fread");
+            close(fd);
             return false;
         }
+        bool ret = this->ReadELFFile(fp);
+        fclose(fp);
+        return ret;
+    }
+    close(fd); // 映射建立后即可关闭描述符
 
-        Symbol symbol_item;
-        symbol_item.sym = sym;        
-        
-        // sym_info 的低4位表示符号类型
-        //symbol_item.sym_type = sym.st_info & 0x0F;
-        symbol_item.sym_type = ELF64_ST_TYPE(sym.st_info);
+    return this->ParseImage(image, file_sz, m_mapped_region);
+}
 
-        // sym_info 的高28位表示符号绑定类型
-        //symbol_item.sym_bind = (sym.st_info >> 4) & 0x0FFFFFFF;
-        symbol_item.sym_bind = ELF64_ST_BIND(sym.st_info);
+bool ELFReader::ReadELFBuffer(const void *data, size_t size)
+{
+    return this->ReadELFBuffer(data, size, nullptr);
+}
 
-        symbols.push_back(symbol_item);
+bool ELFReader::ReadELFBuffer(const void *data, size_t size, const std::shared_ptr<const void> &holder)
+{
+    this->Reset();
+    if (data == nullptr)
+    {
+        return false;
     }
-    
-    return true;
+
+    return this->ParseImage(static_cast<const char*>(data), size, holder);
 }
 
-bool ELFReader::ReadRelocationTable(FILE *fp, const Elf64_Shdr &section_header, const std::string &section_name)
+bool ELFReader::ParseImage(const char *image, size_t image_size, const std::shared_ptr<const void> &holder)
 {
-    FilePosRAII fpraii(fp);
+    char header_bytes[5] {};
+
+    if (image_size < sizeof(header_bytes))
+    {
+        std::cerr << "ELFReader::ReadELFFile failed: file size not correct" << std::endl;
+        return false;
+    }
+
+    if (image_size >= sizeof(CompactHeader) && memcmp(image, COMPACT_MAGIC, sizeof(COMPACT_MAGIC)) == 0)
+    {
+        return this->ParseCompactImage(image, image_size, holder);
+    }
+
+    memcpy(header_bytes, image, sizeof(header_bytes));
+
+    // 前四个字节为魔数：0x7F 0x45 0x4c 0x46, 用以识别文件是否为 ELF 文件
+    if (!(header_bytes[0] == 0x7f &&
+        header_bytes[1] == 'E' &&
+        header_bytes[2] == 'L' &&
+        header_bytes[3] == 'F'))
+    {
+        std::cerr << "ELFReader::ReadELFFile failed: This file is not an elf file" << std::endl;
+        return false;
+    }
+
+    // 第五、六个字节为 ELF 文件类与字节序，据此选定之后解码各表所用的布局
+    if (image_size <= EI_DATA)
+    {
+        std::cerr << "ELFReader::ReadELFFile failed: file size not correct 2" << std::endl;
+        return false;
+    }
+    const Layout *layout = SelectLayout(image[EI_CLASS], image[EI_DATA]);
+    if (layout == nullptr)
+    {
+        std::cerr << "ELFReader::ReadELFFile failed: unknown elf class or data encoding" << std::endl;
+        return false;
+    }
+
+    if (image_size < layout->header_size)
+    {
+        std::cerr << "ELFReader::ReadELFFile failed: file size not correct 2" << std::endl;
+        return false;
+    }
+
+    Elf64_Ehdr header_struct;
+    layout->decode_header(image, header_struct);
+
+    // 直接解析到本对象中（已由 Reset 清空），不再经过临时对象再整体赋值
+    m_image = image;
+    m_image_size = image_size;
+    m_image_holder = holder;
+    m_layout = layout;
+    m_header = header_struct;
+
+    // 段表直接取自映像
+    {
+        const size_t shdr_size = layout->entry_sizes[RECORD_SECTION];
+        Elf64_Shdr section_table_header {};
+        section_table_header.sh_offset = header_struct.e_shoff;
+        section_table_header.sh_size = static_cast<Elf64_Xword>(header_struct.e_shnum) * shdr_size;
+        section_table_header.sh_entsize = shdr_size;
+
+        if (header_struct.e_shnum != 0 && header_struct.e_shentsize != shdr_size)
+        {
+            std::cerr << "ELFReader::ReadELFFile failed: can not read section header table" << std::endl;
+            this->Reset();
+            return false;
+        }
+        if (!this->LoadSectionTable(section_table_header))
+        {
+            this->Reset();
+            return false;
+        }
+    }
+
+    // 程序头表只用于换算装载地址，不影响其余各表，读不到时留空
+    const size_t phdr_size = layout->entry_sizes[RECORD_PROGRAM_HEADER];
+    if (header_struct.e_phentsize == phdr_size)
+    {
+        Elf64_Shdr program_table_header {};
+        program_table_header.sh_offset = header_struct.e_phoff;
+        program_table_header.sh_size = static_cast<Elf64_Xword>(header_struct.e_phnum) * phdr_size;
+        program_table_header.sh_entsize = phdr_size;
+        this->ReadRecords(program_table_header, m_program_headers, RECORD_PROGRAM_HEADER);
+    }
 
-    assert(section_header.sh_entsize == sizeof(Elf64_Rela));
+    // 其余各表在首次访问时才解析
+    // 各表只是指向映像的视图，映像由 m_image_holder 共享持有，拷贝代价很小
+    return true;
+}
 
-    int entry_num = section_header.sh_size / section_header.sh_entsize;
+bool ELFReader::LoadSectionTable(const Elf64_Shdr &section_table_header)
+{
+    if (!this->ReadRecords(section_table_header, m_sections, RECORD_SECTION))
+    {
+        std::cerr << "ELFReader::ReadELFFile failed: can not read section header table" << std::endl;
+        return false;
+    }
 
-    fseek(fp, section_header.sh_offset, SEEK_SET);
+    if (m_header.e_shstrndx >= m_sections.size())
+    {
+        std::cerr << "ELFReader::ReadELFFile failed: e_shstrndx out of range" << std::endl;
+        return false;
+    }
 
-    for (int i = 0; i < entry_num; i++)
+    // 读段表字符串表（.shstrtab）
     {
-        Elf64_Rela rel;
-        if (fread(&rel, sizeof(rel), 1, fp) != 1)
+        const Section &section = m_sections.at(m_header.e_shstrndx);
+        if (!this->ReadStrTable(section.section_header, m_shstrs))
         {
-            perror("ELFReader::ReadRelocationTable failed: fread");
+            std::cerr << "ELFReader::ReadELFFile failed: ReadStrTable .shstrtab failed" << std::endl;
             return false;
         }
+    }
+
+    // 段名在此统一校验，之后 get_name 直接取
+    if (!m_shstrs.check_offsets(m_sections, [](const Section &section) { return section.section_header.sh_name; }))
+    {
+        std::cerr << "ELFReader::ReadELFFile failed: section name out of .shstrtab" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool ELFReader::IsTableSection(Elf64_Word sh_type)
+{
+    switch (sh_type)
+    {
+        case SHT_SYMTAB:
+        case SHT_DYNSYM:
+        case SHT_STRTAB:
+        case SHT_RELA:
+        case SHT_REL:
+        case SHT_RELR:
+        case SHT_GNU_versym:
+        case SHT_DYNAMIC:
+        case SHT_HASH:
+        case SHT_GNU_HASH:
+        case SHT_NOTE:
+            return true;
+
+        default:
+            return false;
+    }
+}
 
-        Relocation rel_item;
-        rel_item.rel = rel;        
+uint64_t ELFReader::GetRelrRelocationNum() const
+{
+    const bool is_32 = m_header.e_ident[EI_CLASS] == ELFCLASS32;
+    const bool swap = m_layout != nullptr && m_layout->swap;
+    const size_t word_size = is_32 ? sizeof(uint32_t) : sizeof(uint64_t);
+
+    uint64_t num = 0;
+    for (const Section &section : m_sections)
+    {
+        if (section.section_header.sh_type != SHT_RELR)
+        {
+            continue;
+        }
 
-		// 解析符号表下标
-		rel_item.symbol_index = ELF64_R_SYM(rel.r_info);
+        std::string_view content = this->GetSectionContent(section);
+        for (size_t offset = 0; offset + word_size <= content.size(); offset += word_size)
+        {
+            uint64_t word;
+            if (is_32)
+            {
+                uint32_t word_32;
+                memcpy(&word_32, content.data() + offset, sizeof(word_32));
+                word = swap ? __builtin_bswap32(word_32) : word_32;
+            }
+            else
+            {
+                memcpy(&word, content.data() + offset, sizeof(word));
+                word = swap ? __builtin_bswap64(word) : word;
+            }
 
-		// 解析类型
-		rel_item.type = ELF64_R_TYPE(rel.r_info);
-        
-        m_relocations[section_name].push_back(rel_item);
+            // 最低位为 0 的是一个要重定位的地址；为 1 的是位图，其余每个置位的位对应其后的一个字
+            num += (word & 1) ? __builtin_popcountll(word >> 1) : 1;
+        }
     }
-	return true;
+    return num;
+}
+
+bool ELFReader::IsLineInfoSection(std::string_view name)
+{
+    return name == ".debug_line" || name == ".debug_line_str" || name == ".debug_aranges" ||
+        name == ".debug_info" || name == ".debug_abbrev" || name == ".debug_str";
 }
 
-bool ELFReader::ReadDynamicTable(FILE *fp, const Elf64_Shdr &section_header)
+void ELFReader::WriteCompactImage(std::string &out, const std::string &extra) const
 {
-    FilePosRAII fpraii(fp);
+    out.clear();
 
-    assert(section_header.sh_entsize == sizeof(Elf64_Dyn));
+    CompactHeader header {};
+    memcpy(header.magic, COMPACT_MAGIC, sizeof(header.magic));
+    header.section_num = m_sections.size();
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
 
-    int entry_num = section_header.sh_size / section_header.sh_entsize;
+    header.ehdr_offset = AppendAligned(out, &m_header, sizeof(m_header));
+    header.shdr_offset = AppendAligned(out, m_sections.data(), m_sections.size() * sizeof(Section));
 
-    fseek(fp, section_header.sh_offset, SEEK_SET);
+    // 偏移表先占位，段数据写完后回填
+    std::vector<uint64_t> data_offsets(m_sections.size(), NO_SECTION_DATA);
+    header.data_offsets_offset = AppendAligned(out, data_offsets.data(), data_offsets.size() * sizeof(uint64_t));
 
-    for (int i = 0; i < entry_num; i++)
+    for (size_t i = 0; i < m_sections.size(); i++)
     {
-        Elf64_Dyn dyn;
-        if (fread(&dyn, sizeof(dyn), 1, fp) != 1)
+        const Elf64_Shdr &section_header = m_sections[i].section_header;
+        // 紧凑映像只保留读取器与 LineIndex 会访问的段
+        if (!IsTableSection(section_header.sh_type) && !IsLineInfoSection(m_sections[i].get_name(*this)))
         {
-            perror("ELFReader::ReadDynamicTable failed: fread");
-            return false;
+            continue;
+        }
+
+        const char *data = this->GetSectionBytes(section_header);
+        if (data != nullptr)
+        {
+            data_offsets[i] = AppendAligned(out, data, section_header.sh_size);
         }
+    }
+    memcpy(&out[header.data_offsets_offset], data_offsets.data(), data_offsets.size() * sizeof(uint64_t));
+
+    header.extra_offset = AppendAligned(out, extra.data(), extra.size());
+    header.extra_size = extra.size();
+
+    memcpy(&out[0], &header, sizeof(header));
+}
+
+const char *ELFReader::GetCompactExtra(size_t &size) const
+{
+    size = m_compact_extra_size;
+    return m_compact_extra;
+}
+
+bool ELFReader::ParseCompactImage(const char *image, size_t image_size, const std::shared_ptr<const void> &holder)
+{
+    CompactHeader header;
+    memcpy(&header, image, sizeof(header));
 
-        Dynamic dynamic_item;
-        dynamic_item.dyn = dyn;
+    if (header.ehdr_offset > image_size || sizeof(Elf64_Ehdr) > image_size - header.ehdr_offset ||
+        header.extra_offset > image_size || header.extra_size > image_size - header.extra_offset ||
+        header.section_num > UINT16_MAX)
+    {
+        std::cerr << "ELFReader::ReadELFFile failed: bad compact image" << std::endl;
+        return false;
+    }
 
-        m_dynamics.push_back(dynamic_item);
+    m_image = image;
+    m_image_size = image_size;
+    m_image_holder = holder;
+    memcpy(&m_header, image + header.ehdr_offset, sizeof(Elf64_Ehdr));
+    // 紧凑映像中的文件头与段表已是本机 Elf64 布局，其余各段数据仍按原文件的布局存放
+    const Layout *layout = SelectLayout(m_header.e_ident[EI_CLASS], m_header.e_ident[EI_DATA]);
+    if (layout == nullptr)
+    {
+        std::cerr << "ELFReader::ReadELFFile failed: bad compact image" << std::endl;
+        this->Reset();
+        return false;
+    }
+    m_layout = &GetLayout<ELFCLASS64, false>();
+    m_compact_extra = image + header.extra_offset;
+    m_compact_extra_size = header.extra_size;
+
+    Elf64_Shdr offsets_header {};
+    offsets_header.sh_offset = header.data_offsets_offset;
+    offsets_header.sh_size = header.section_num * sizeof(uint64_t);
+    offsets_header.sh_entsize = sizeof(uint64_t);
+    if (!this->ReadTable(offsets_header, m_data_offsets))
+    {
+        std::cerr << "ELFReader::ReadELFFile failed: bad compact image" << std::endl;
+        this->Reset();
+        return false;
+    }
+
+    Elf64_Shdr section_table_header {};
+    section_table_header.sh_offset = header.shdr_offset;
+    section_table_header.sh_size = header.section_num * sizeof(Elf64_Shdr);
+    section_table_header.sh_entsize = sizeof(Elf64_Shdr);
+    if (!this->LoadSectionTable(section_table_header))
+    {
+        this->Reset();
+        return false;
+    }
+    m_layout = layout;
+
+    return true;
+}
+
+const ELFReader::Section *ELFReader::FindSection(std::string_view name) const
+{
+    for (const Section &section : m_sections)
+    {
+        if (section.get_name(*this) == name)
+        {
+            return &section;
+        }
+    }
+    return nullptr;
+}
+
+std::string_view ELFReader::GetSectionContent(const Section &section) const
+{
+    if (section.section_header.sh_type == SHT_NOBITS)
+    {
+        return std::string_view();
+    }
+
+    const char *data = this->GetSectionBytes(section.section_header);
+    if (data == nullptr)
+    {
+        return std::string_view();
+    }
+    return std::string_view(data, section.section_header.sh_size);
+}
+
+std::string ELFReader::GetBuildId() const
+{
+    static const char HEX[] = "0123456789abcdef";
+
+    for (const Section &section : m_sections)
+    {
+        if (section.section_header.sh_type != SHT_NOTE)
+        {
+            continue;
+        }
+
+        const char *data = this->GetSectionBytes(section.section_header);
+        if (data == nullptr)
+        {
+            continue;
+        }
+
+        // note 由 Elf64_Nhdr + name + desc 组成，name、desc 各自按 4 字节对齐
+        size_t pos = 0;
+        const size_t size = section.section_header.sh_size;
+        while (pos + sizeof(Elf64_Nhdr) <= size)
+        {
+            // ELF32 与 ELF64 的 note 头相同，都是三个 4 字节字
+            Elf64_Nhdr note;
+            memcpy(&note, data + pos, sizeof(note));
+            if (m_layout->swap)
+            {
+                note.n_namesz = __builtin_bswap32(note.n_namesz);
+                note.n_descsz = __builtin_bswap32(note.n_descsz);
+                note.n_type = __builtin_bswap32(note.n_type);
+            }
+            size_t name_pos = pos + sizeof(note);
+            size_t desc_pos = name_pos + ((note.n_namesz + 3) & ~3u);
+            size_t next_pos = desc_pos + ((note.n_descsz + 3) & ~3u);
+            if (next_pos > size || next_pos <= pos)
+            {
+                break;
+            }
+
+            if (note.n_type == NT_GNU_BUILD_ID && note.n_namesz == sizeof(ELF_NOTE_GNU) &&
+                memcmp(data + name_pos, ELF_NOTE_GNU, sizeof(ELF_NOTE_GNU)) == 0)
+            {
+                std::string build_id;
+                for (size_t i = 0; i < note.n_descsz; i++)
+                {
+                    unsigned char c = data[desc_pos + i];
+                    build_id += HEX[c >> 4];
+                    build_id += HEX[c & 0x0f];
+                }
+                return build_id;
+            }
+            pos = next_pos;
+        }
+    }
+
+    return "";
+}
+
+const TableView<ELFReader::Symbol> &ELFReader::GetSymbols() const
+{
+    if (!m_loaded[LAZY_SYMBOLS])
+    {
+        m_loaded[LAZY_SYMBOLS] = true;
+        this->LoadSymbolTable(SHT_SYMTAB, m_symbols, m_strs);
+    }
+    return m_symbols;
+}
+
+const TableView<ELFReader::Symbol> &ELFReader::GetDynSyms() const
+{
+    if (!m_loaded[LAZY_DYNSYMS])
+    {
+        m_loaded[LAZY_DYNSYMS] = true;
+        this->LoadSymbolTable(SHT_DYNSYM, m_dynsyms, m_dynstrs);
+        m_loaded[LAZY_DYNSTRS] = true;
+    }
+    return m_dynsyms;
+}
+
+const std::vector<ELFReader::RelocationTable> &ELFReader::GetRelocations() const
+{
+    if (!m_loaded[LAZY_RELOCATIONS])
+    {
+        m_loaded[LAZY_RELOCATIONS] = true;
+        this->LoadRelocationTables();
+    }
+    return m_relocations;
+}
+
+const TableView<ELFReader::Dynamic> &ELFReader::GetDynamics() const
+{
+    if (!m_loaded[LAZY_DYNAMICS])
+    {
+        m_loaded[LAZY_DYNAMICS] = true;
+        this->LoadDynamicTable();
+    }
+    return m_dynamics;
+}
+
+const StrTable &ELFReader::GetDynamicStrs() const
+{
+    if (!m_loaded[LAZY_DYNSTRS])
+    {
+        m_loaded[LAZY_DYNSTRS] = true;
+        this->LoadDynamicStrTable();
+    }
+    return m_dynstrs;
+}
+
+const StrTable &ELFReader::GetSymbolStrs() const
+{
+    this->GetSymbols();
+    return m_strs;
+}
+
+void ELFReader::LoadAllTables() const
+{
+    this->GetSymbols();
+    this->GetDynSyms();
+    this->GetRelocations();
+    this->GetDynamics();
+    this->GetDynamicStrs();
+    this->EnsureHashTables();
+}
+
+void ELFReader::LoadSymbolTable(Elf64_Word sh_type, TableView<Symbol> &symbols, StrTable &str_table) const
+{
+    for (const Section &section : m_sections)
+    {
+        if (section.section_header.sh_type != sh_type)
+        {
+            continue;
+        }
+
+        // 符号表通过 sh_link 指向其名字所在的字符串表（.strtab 或 .dynstr）
+        if (section.section_header.sh_link >= m_sections.size() ||
+            !this->ReadStrTable(m_sections[section.section_header.sh_link].section_header, str_table))
+        {
+            std::cerr << "ELFReader::LoadSymbolTable failed: ReadStrTable " << section.get_name(*this) << " failed" << std::endl;
+            return;
+        }
+
+        if (!this->ReadRecords(section.section_header, symbols, RECORD_SYMBOL))
+        {
+            std::cerr << "ELFReader::LoadSymbolTable failed: ReadSymbolTable " << section.get_name(*this) << " failed" << std::endl;
+            str_table = StrTable();
+            return;
+        }
+
+        // 符号名在加载时统一校验，之后 get_sym_name 等直接返回字符串表上的视图
+        if (!str_table.check_offsets(symbols, [](const Symbol &symbol) { return symbol.sym.st_name; }))
+        {
+            std::cerr << "ELFReader::LoadSymbolTable failed: symbol name out of string table in " << section.get_name(*this) << std::endl;
+            symbols = TableView<Symbol>();
+            str_table = StrTable();
+        }
+        return;
+    }
+}
+
+void ELFReader::LoadRelocationTables() const
+{
+    m_relocations.clear();
+
+    size_t table_num = 0;
+    for (const Section &section : m_sections)
+    {
+        if (section.section_header.sh_type == SHT_RELA || section.section_header.sh_type == SHT_REL) table_num++;
+    }
+    m_relocations.reserve(table_num);
+
+    for (const Section &section : m_sections)
+    {
+        const Elf64_Shdr &header = section.section_header;
+        if (header.sh_type != SHT_RELA && header.sh_type != SHT_REL)
+        {
+            continue;
+        }
+
+        RelocationTable table;
+        table.section = &section;
+        if (!this->ReadRecords(header, table.relocations, header.sh_type == SHT_RELA ? RECORD_RELA : RECORD_REL))
+        {
+            std::cerr << "ELFReader::LoadRelocationTables failed: ReadRelocationTable " << section.get_name(*this) << " failed" << std::endl;
+            continue;
+        }
+
+        if (header.sh_info != 0 && header.sh_info < m_sections.size())
+        {
+            table.target = &m_sections[header.sh_info];
+        }
+
+        // 按 sh_link 找符号表，再把每条重定位与其符号关联起来
+        const TableView<Symbol> *symbols = nullptr;
+        if (header.sh_link != 0 && header.sh_link < m_sections.size())
+        {
+            Elf64_Word link_type = m_sections[header.sh_link].section_header.sh_type;
+            if (link_type == SHT_DYNSYM)
+            {
+                symbols = &this->GetDynSyms();
+                table.is_dyn = true;
+            }
+            else if (link_type == SHT_SYMTAB)
+            {
+                symbols = &this->GetSymbols();
+            }
+        }
+
+        const Symbol **table_symbols = reinterpret_cast<const Symbol**>(
+            this->GetArena().Allocate(table.relocations.size() * sizeof(const Symbol*), alignof(const Symbol*)));
+        for (std::size_t i = 0; i < table.relocations.size(); i++)
+        {
+            std::size_t symbol_index = table.relocations[i].get_symbol_index();
+            table_symbols[i] = symbols != nullptr && symbol_index < symbols->size() ? &(*symbols)[symbol_index] : nullptr;
+        }
+        table.symbols = TableView<const Symbol*>(table_symbols, table.relocations.size());
+
+        m_relocations.push_back(std::move(table));
+    }
+}
+
+void ELFReader::LoadDynamicTable() const
+{
+    for (const Section &section : m_sections)
+	{
+		if (section.section_header.sh_type == SHT_DYNAMIC)
+		{
+			// 读 dynamic 表信息
+			if (!this->ReadRecords(section.section_header, m_dynamics, RECORD_DYNAMIC))
+			{
+				std::cerr << "ELFReader::LoadDynamicTable failed: ReadDynamicTable failed" << std::endl;
+			}
+			return;
+		}
+	}
+}
+
+void ELFReader::LoadDynamicStrTable() const
+{
+    // .dynstr 一般随 .dynsym 一起读取，这里只在没有 .dynsym 时单独按名字查找
+    for (const Section &section : m_sections)
+    {
+        if (section.section_header.sh_type == SHT_STRTAB && section.get_name(*this) == ".dynstr")
+        {
+            if (!this->ReadStrTable(section.section_header, m_dynstrs))
+            {
+                std::cerr << "ELFReader::LoadDynamicStrTable failed: ReadStrTable .dynstr failed" << std::endl;
+            }
+            return;
+        }
+    }
+}
+
+const char *ELFReader::GetSectionBytes(const Elf64_Shdr &section_header) const
+{
+    uint64_t offset = section_header.sh_offset;
+
+    // 紧凑映像中段数据的位置由 m_data_offsets 给出，段表中仍是原文件的偏移
+    if (!m_data_offsets.empty())
+    {
+        const Section *section = reinterpret_cast<const Section*>(&section_header);
+        if (section >= m_sections.begin() && section < m_sections.end())
+        {
+            offset = m_data_offsets[section - m_sections.begin()];
+        }
+    }
+
+    if (offset > m_image_size || section_header.sh_size > m_image_size - offset)
+    {
+        return nullptr;
+    }
+
+    return m_image + offset;
+}
+
+const char *ELFReader::GetSectionData(const Elf64_Shdr &section_header, size_t align) const
+{
+    const char *data = this->GetSectionBytes(section_header);
+    if (data == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (reinterpret_cast<uintptr_t>(data) % align == 0)
+    {
+        return data;
+    }
+
+    char *copy = this->GetArena().Allocate(section_header.sh_size, align);
+    memcpy(copy, data, section_header.sh_size);
+    return copy;
+}
+
+void ELFReader::LoadHashTables() const
+{
+    // 哈希表按原始字节直接访问，ELF32 的布隆过滤器字长不同、异字节序的要逐字交换，这两种情况都退化为线性查找
+    if (m_layout == nullptr || !m_layout->native)
+    {
+        return;
+    }
+
+    const size_t dynsym_num = this->GetDynSyms().size();
+
+    for (const Section &section : m_sections)
+    {
+        const Elf64_Shdr &header = section.section_header;
+
+        if (header.sh_type == SHT_GNU_HASH && m_gnu_hash.buckets == nullptr)
+        {
+            const char *data = this->GetSectionData(header, sizeof(uint64_t));
+            if (data == nullptr || header.sh_size < 4 * sizeof(uint32_t))
+            {
+                std::cerr << "ELFReader::LoadHashTables failed: bad .gnu.hash" << std::endl;
+                continue;
+            }
+
+            const uint32_t *words = reinterpret_cast<const uint32_t*>(data);
+            GnuHashTable table;
+            table.bucket_num = words[0];
+            table.sym_offset = words[1];
+            table.bloom_size = words[2];
+            table.bloom_shift = words[3];
+
+            uint64_t fixed_size = 4 * sizeof(uint32_t) + static_cast<uint64_t>(table.bloom_size) * sizeof(uint64_t) +
+                static_cast<uint64_t>(table.bucket_num) * sizeof(uint32_t);
+            if (table.bucket_num == 0 || table.bloom_size == 0 || fixed_size > header.sh_size)
+            {
+                std::cerr << "ELFReader::LoadHashTables failed: bad .gnu.hash" << std::endl;
+                continue;
+            }
+
+            table.bloom = reinterpret_cast<const uint64_t*>(data + 4 * sizeof(uint32_t));
+            table.buckets = reinterpret_cast<const uint32_t*>(table.bloom + table.bloom_size);
+            table.chains = table.buckets + table.bucket_num;
+            table.chain_num = static_cast<uint32_t>((header.sh_size - fixed_size) / sizeof(uint32_t));
+
+            // 链不会超出 .dynsym 的范围
+            if (table.sym_offset > dynsym_num)
+            {
+                table.chain_num = 0;
+            }
+            else if (table.chain_num > dynsym_num - table.sym_offset)
+            {
+                table.chain_num = static_cast<uint32_t>(dynsym_num - table.sym_offset);
+            }
+            m_gnu_hash = table;
+        }
+        else if (header.sh_type == SHT_HASH && m_sysv_hash.buckets == nullptr)
+        {
+            const char *data = this->GetSectionData(header, sizeof(uint32_t));
+            if (data == nullptr || header.sh_size < 2 * sizeof(uint32_t))
+            {
+                std::cerr << "ELFReader::LoadHashTables failed: bad .hash" << std::endl;
+                continue;
+            }
+
+            const uint32_t *words = reinterpret_cast<const uint32_t*>(data);
+            SysvHashTable table;
+            table.bucket_num = words[0];
+            table.chain_num = words[1];
+            if (table.bucket_num == 0 ||
+                (2 + static_cast<uint64_t>(table.bucket_num) + table.chain_num) * sizeof(uint32_t) > header.sh_size)
+            {
+                std::cerr << "ELFReader::LoadHashTables failed: bad .hash" << std::endl;
+                continue;
+            }
+
+            table.buckets = words + 2;
+            table.chains = table.buckets + table.bucket_num;
+            if (table.chain_num > dynsym_num)
+            {
+                table.chain_num = static_cast<uint32_t>(dynsym_num);
+            }
+            m_sysv_hash = table;
+        }
+    }
+}
+
+void ELFReader::LoadVersymTable() const
+{
+    for (const Section &section : m_sections)
+    {
+        const Elf64_Shdr &header = section.section_header;
+        if (header.sh_type == SHT_GNU_versym)
+        {
+            // 按字读取时再处理对齐与字节序，这里只记下位置
+            m_versyms = this->GetSectionBytes(header);
+            m_versym_num = m_versyms != nullptr ? header.sh_size / sizeof(Elf64_Half) : 0;
+            return;
+        }
+    }
+}
+
+void ELFReader::EnsureHashTables() const
+{
+    if (!m_loaded[LAZY_HASH])
+    {
+        m_loaded[LAZY_HASH] = true;
+        this->LoadHashTables();
+        this->LoadVersymTable();
+    }
+}
+
+uint16_t ELFReader::GetDynSymVersion(std::size_t index) const
+{
+    this->EnsureHashTables();
+    if (index >= m_versym_num)
+    {
+        return VER_NDX_GLOBAL;
+    }
+
+    uint16_t version;
+    memcpy(&version, m_versyms + index * sizeof(Elf64_Half), sizeof(version));
+    return m_layout->swap ? __builtin_bswap16(version) : version;
+}
+
+// GNU 风格哈希（DJB 哈希）
+static uint32_t GnuHash(const char *name)
+{
+    uint32_t h = 5381;
+    for (const unsigned char *p = reinterpret_cast<const unsigned char*>(name); *p != '\0'; p++)
+    {
+        h = (h << 5) + h + *p;
+    }
+    return h;
+}
+
+// System V ABI 中的 ELF 哈希
+static uint32_t SysvHash(const char *name)
+{
+    uint32_t h = 0;
+    for (const unsigned char *p = reinterpret_cast<const unsigned char*>(name); *p != '\0'; p++)
+    {
+        h = (h << 4) + *p;
+        uint32_t g = h & 0xf0000000;
+        if (g != 0)
+        {
+            h ^= g >> 24;
+        }
+        h &= ~g;
+    }
+    return h;
+}
+
+const ELFReader::Symbol *ELFReader::FindDynamicSymbol(const char *name) const
+{
+    const TableView<Symbol> &dynsyms = this->GetDynSyms();
+    this->EnsureHashTables();
+
+    // 只认有名字的已定义符号，与动态链接器一致；隐藏的版本先记下，链上没有非隐藏的同名符号时才返回它
+    const Symbol *hidden = nullptr;
+    auto is_match = [this, &dynsyms, name, &hidden](uint32_t index)
+    {
+        const Symbol &symbol = dynsyms[index];
+        if (symbol.sym.st_shndx == SHN_UNDEF || strcmp(m_dynstrs.data() + symbol.sym.st_name, name) != 0)
+        {
+            return false;
+        }
+        if (this->GetDynSymVersion(index) & VERSYM_HIDDEN)
+        {
+            if (hidden == nullptr)
+            {
+                hidden = &symbol;
+            }
+            return false;
+        }
+        return true;
+    };
+
+    if (m_gnu_hash.buckets != nullptr)
+    {
+        const GnuHashTable &table = m_gnu_hash;
+        const uint32_t h1 = GnuHash(name);
+
+        // 布隆过滤器：两个比特都置位才可能存在
+        const uint64_t word = table.bloom[(h1 / 64) % table.bloom_size];
+        const uint64_t mask = (uint64_t(1) << (h1 % 64)) | (uint64_t(1) << ((h1 >> table.bloom_shift) % 64));
+        if ((word & mask) != mask)
+        {
+            return nullptr;
+        }
+
+        uint32_t index = table.buckets[h1 % table.bucket_num];
+        if (index < table.sym_offset)
+        {
+            return nullptr;
+        }
+
+        for (; index - table.sym_offset < table.chain_num; index++)
+        {
+            // 链中存的是哈希值，最低位作为链尾标记
+            const uint32_t h2 = table.chains[index - table.sym_offset];
+            if ((h1 | 1) == (h2 | 1) && is_match(index))
+            {
+                return &dynsyms[index];
+            }
+            if (h2 & 1)
+            {
+                break;
+            }
+        }
+        return hidden;
+    }
+
+    if (m_sysv_hash.buckets != nullptr)
+    {
+        const SysvHashTable &table = m_sysv_hash;
+        const uint32_t h = SysvHash(name);
+
+        uint32_t steps = 0; // 防止损坏的链成环
+        for (uint32_t index = table.buckets[h % table.bucket_num];
+            index != STN_UNDEF && index < table.chain_num && steps < table.chain_num;
+            index = table.chains[index], steps++)
+        {
+            if (is_match(index))
+            {
+                return &dynsyms[index];
+            }
+        }
+        return hidden;
+    }
+
+    for (uint32_t index = 0; index < dynsyms.size(); index++)
+    {
+        if (is_match(index))
+        {
+            return &dynsyms[index];
+        }
+    }
+    return hidden;
+}
+
+std::vector<ELFReader::HashTableStats> ELFReader::GetHashTableStats() const
+{
+    this->EnsureHashTables();
+
+    std::vector<HashTableStats> stats_list;
+
+    auto add_chain = [](HashTableStats &stats, uint32_t chain_len)
+    {
+        if (chain_len >= stats.chain_len_histogram.size())
+        {
+            stats.chain_len_histogram.resize(chain_len + 1);
+        }
+        stats.chain_len_histogram[chain_len]++;
+        stats.symbol_num += chain_len;
+        if (chain_len == 0) stats.empty_bucket_num++;
+        if (chain_len > stats.max_chain_len) stats.max_chain_len = chain_len;
+    };
+
+    if (m_gnu_hash.buckets != nullptr)
+    {
+        const GnuHashTable &table = m_gnu_hash;
+        HashTableStats stats;
+        stats.kind = ".gnu.hash";
+        stats.bucket_num = table.bucket_num;
+        stats.bloom_word_num = table.bloom_size;
+        for (uint32_t i = 0; i < table.bloom_size; i++)
+        {
+            stats.bloom_bits_set += __builtin_popcountll(table.bloom[i]);
+        }
+
+        for (uint32_t b = 0; b < table.bucket_num; b++)
+        {
+            uint32_t chain_len = 0;
+            uint32_t index = table.buckets[b];
+            if (index >= table.sym_offset)
+            {
+                for (; index - table.sym_offset < table.chain_num; index++)
+                {
+                    chain_len++;
+                    if (table.chains[index - table.sym_offset] & 1)
+                    {
+                        break;
+                    }
+                }
+            }
+            add_chain(stats, chain_len);
+        }
+        stats_list.push_back(stats);
+    }
+
+    if (m_sysv_hash.buckets != nullptr)
+    {
+        const SysvHashTable &table = m_sysv_hash;
+        HashTableStats stats;
+        stats.kind = ".hash";
+        stats.bucket_num = table.bucket_num;
+
+        for (uint32_t b = 0; b < table.bucket_num; b++)
+        {
+            uint32_t chain_len = 0;
+            for (uint32_t index = table.buckets[b];
+                index != STN_UNDEF && index < table.chain_num && chain_len < table.chain_num;
+                index = table.chains[index])
+            {
+                chain_len++;
+            }
+            add_chain(stats, chain_len);
+        }
+        stats_list.push_back(stats);
+    }
+
+    return stats_list;
+}
+
+bool ELFReader::ReadStrTable(const Elf64_Shdr &section_header, StrTable &str_table) const
+{
+    const char *data = this->GetSectionBytes(section_header);
+    if (data == nullptr)
+    {
+        return false;
+    }
+
+    size_t size = section_header.sh_size;
+
+    // 按规范字符串表以 '\0' 结尾，不满足时拷贝一份补上结尾，保证 at() 取到的名字不会越界
+    if (size == 0 || data[size - 1] != '\0')
+    {
+        data = this->GetArena().Store(std::string_view(data, size)).data();
+        size++;
+    }
+
+    str_table = StrTable(data, size);
+    return true;
+}
+
+template <typename T>
+bool ELFReader::ReadTable(const Elf64_Shdr &section_header, TableView<T> &table) const
+{
+    if (!table.empty())
+    {
+        return true; // 同类型的表只取第一个
+    }
+
+    if (section_header.sh_size != 0 && section_header.sh_entsize != sizeof(T))
+    {
+        return false;
+    }
+
+    const char *data = this->GetSectionBytes(section_header);
+    if (data == nullptr)
+    {
+        return false;
+    }
+
+    size_t entry_num = section_header.sh_size / sizeof(T);
+
+    if (reinterpret_cast<uintptr_t>(data) % alignof(T) == 0)
+    {
+        // 对齐时直接在映像上原地访问
+        table = TableView<T>(reinterpret_cast<const T*>(data), entry_num);
+    }
+    else
+    {
+        T *copy = reinterpret_cast<T*>(this->GetArena().Allocate(entry_num * sizeof(T), alignof(T)));
+        memcpy(copy, data, entry_num * sizeof(T));
+        table = TableView<T>(copy, entry_num);
+    }
+
+    return true;
+}
+
+template <typename T>
+bool ELFReader::ReadRecords(const Elf64_Shdr &section_header, TableView<T> &table, RecordKind kind) const
+{
+    if (!table.empty())
+    {
+        return true; // 同类型的表只取第一个
+    }
+
+    const size_t entry_size = m_layout->entry_sizes[kind];
+    if (m_layout->native && entry_size == sizeof(T))
+    {
+        return this->ReadTable(section_header, table);
+    }
+
+    if (section_header.sh_size != 0 && section_header.sh_entsize != entry_size)
+    {
+        return false;
+    }
+
+    const char *data = this->GetSectionBytes(section_header);
+    if (data == nullptr)
+    {
+        return false;
+    }
+
+    // 整表解码一次，之后与本机布局的表一样按下标访问
+    size_t entry_num = section_header.sh_size / entry_size;
+    T *records = reinterpret_cast<T*>(this->GetArena().Allocate(entry_num * sizeof(T), alignof(T)));
+    m_layout->decoders[kind](data, entry_num, records);
+    table = TableView<T>(records, entry_num);
+    return true;
+}
+
+bool ELFReader::Triage(int fd, TriageInfo &info)
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        return false;
+    }
+
+    // e_type、e_machine 在 ELF32 与 ELF64 中偏移相同，读 ELF32 头的大小即可
+    unsigned char ident[sizeof(Elf32_Ehdr)];
+    if (pread(fd, ident, sizeof(ident), 0) != static_cast<ssize_t>(sizeof(ident)))
+    {
+        return false;
+    }
+
+    if (memcmp(ident, ELFMAG, SELFMAG) != 0)
+    {
+        return false;
+    }
+
+    if ((ident[EI_CLASS] != ELFCLASS32 && ident[EI_CLASS] != ELFCLASS64) ||
+        (ident[EI_DATA] != ELFDATA2LSB && ident[EI_DATA] != ELFDATA2MSB))
+    {
+        return false;
+    }
+
+    const unsigned char *type = ident + offsetof(Elf32_Ehdr, e_type);
+    const unsigned char *machine = ident + offsetof(Elf32_Ehdr, e_machine);
+
+    info.elf_class = ident[EI_CLASS];
+    info.data = ident[EI_DATA];
+    if (info.data == ELFDATA2LSB)
+    {
+        info.type = static_cast<uint16_t>(type[0] | (type[1] << 8));
+        info.machine = static_cast<uint16_t>(machine[0] | (machine[1] << 8));
+    }
+    else
+    {
+        info.type = static_cast<uint16_t>((type[0] << 8) | type[1]);
+        info.machine = static_cast<uint16_t>((machine[0] << 8) | machine[1]);
+    }
+    info.file_size = st.st_size;
+
+    return true;
+}
+
+const char *ELFReader::GetClassName(unsigned char elf_class)
+{
+    switch (elf_class)
+    {
+        case ELFCLASS32:
+            return "ELF32";
+
+        case ELFCLASS64:
+            return "ELF64";
+
+        default:
+            return "Unknown";
+    }
+}
+
+const char *ELFReader::GetTypeName(uint16_t type)
+{
+    switch (type)
+    {
+        case ET_REL:
+            return "REL";
+
+        case ET_EXEC:
+            return "EXEC";
+
+        case ET_DYN:
+            return "DYN";
+
+        case ET_CORE:
+            return "CORE";
+
+        default:
+            return "Unknown";
+    }
+}
+
+const char *ELFReader::GetMachineName(uint16_t machine)
+{
+    switch (machine)
+    {
+        case EM_386:
+            return "i386";
+
+        case EM_X86_64:
+            return "x86_64";
+
+        case EM_ARM:
+            return "arm";
+
+        case EM_AARCH64:
+            return "aarch64";
+
+        case EM_RISCV:
+            return "riscv";
+
+        case EM_PPC:
+            return "ppc";
+
+        case EM_PPC64:
+            return "ppc64";
+
+        case EM_MIPS:
+            return "mips";
+
+        case EM_S390:
+            return "s390";
+
+        case EM_BPF:
+            return "bpf";
+
+        default:
+            return "Unknown";
+    }
+}
+
+static const char *GetX86_64RelocationTypeName(int type)
+{
+    switch (type)
+    {
+        case R_X86_64_NONE: return "R_X86_64_NONE";
+        case R_X86_64_64: return "R_X86_64_64";
+        case R_X86_64_PC32: return "R_X86_64_PC32";
+        case R_X86_64_GOT32: return "R_X86_64_GOT32";
+        case R_X86_64_PLT32: return "R_X86_64_PLT32";
+        case R_X86_64_COPY: return "R_X86_64_COPY";
+        case R_X86_64_GLOB_DAT: return "R_X86_64_GLOB_DAT";
+        case R_X86_64_JUMP_SLOT: return "R_X86_64_JUMP_SLOT";
+        case R_X86_64_RELATIVE: return "R_X86_64_RELATIVE";
+        case R_X86_64_GOTPCREL: return "R_X86_64_GOTPCREL";
+        case R_X86_64_32: return "R_X86_64_32";
+        case R_X86_64_32S: return "R_X86_64_32S";
+        case R_X86_64_16: return "R_X86_64_16";
+        case R_X86_64_PC16: return "R_X86_64_PC16";
+        case R_X86_64_8: return "R_X86_64_8";
+        case R_X86_64_PC8: return "R_X86_64_PC8";
+        case R_X86_64_DTPMOD64: return "R_X86_64_DTPMOD64";
+        case R_X86_64_DTPOFF64: return "R_X86_64_DTPOFF64";
+        case R_X86_64_TPOFF64: return "R_X86_64_TPOFF64";
+        case R_X86_64_TLSGD: return "R_X86_64_TLSGD";
+        case R_X86_64_TLSLD: return "R_X86_64_TLSLD";
+        case R_X86_64_DTPOFF32: return "R_X86_64_DTPOFF32";
+        case R_X86_64_GOTTPOFF: return "R_X86_64_GOTTPOFF";
+        case R_X86_64_TPOFF32: return "R_X86_64_TPOFF32";
+        case R_X86_64_PC64: return "R_X86_64_PC64";
+        case R_X86_64_GOTOFF64: return "R_X86_64_GOTOFF64";
+        case R_X86_64_GOTPC32: return "R_X86_64_GOTPC32";
+        case R_X86_64_SIZE32: return "R_X86_64_SIZE32";
+        case R_X86_64_SIZE64: return "R_X86_64_SIZE64";
+        case R_X86_64_GOTPC32_TLSDESC: return "R_X86_64_GOTPC32_TLSDESC";
+        case R_X86_64_TLSDESC_CALL: return "R_X86_64_TLSDESC_CALL";
+        case R_X86_64_TLSDESC: return "R_X86_64_TLSDESC";
+        case R_X86_64_IRELATIVE: return "R_X86_64_IRELATIVE";
+        case R_X86_64_GOTPCRELX: return "R_X86_64_GOTPCRELX";
+        case R_X86_64_REX_GOTPCRELX: return "R_X86_64_REX_GOTPCRELX";
+        default: return nullptr;
+    }
+}
+
+static const char *GetI386RelocationTypeName(int type)
+{
+    switch (type)
+    {
+        case R_386_NONE: return "R_386_NONE";
+        case R_386_32: return "R_386_32";
+        case R_386_PC32: return "R_386_PC32";
+        case R_386_GOT32: return "R_386_GOT32";
+        case R_386_PLT32: return "R_386_PLT32";
+        case R_386_COPY: return "R_386_COPY";
+        case R_386_GLOB_DAT: return "R_386_GLOB_DAT";
+        case R_386_JMP_SLOT: return "R_386_JMP_SLOT";
+        case R_386_RELATIVE: return "R_386_RELATIVE";
+        case R_386_GOTOFF: return "R_386_GOTOFF";
+        case R_386_GOTPC: return "R_386_GOTPC";
+        case R_386_32PLT: return "R_386_32PLT";
+        case R_386_TLS_TPOFF: return "R_386_TLS_TPOFF";
+        case R_386_TLS_IE: return "R_386_TLS_IE";
+        case R_386_TLS_GOTIE: return "R_386_TLS_GOTIE";
+        case R_386_TLS_LE: return "R_386_TLS_LE";
+        case R_386_TLS_GD: return "R_386_TLS_GD";
+        case R_386_TLS_LDM: return "R_386_TLS_LDM";
+        case R_386_16: return "R_386_16";
+        case R_386_PC16: return "R_386_PC16";
+        case R_386_8: return "R_386_8";
+        case R_386_PC8: return "R_386_PC8";
+        case R_386_TLS_GD_32: return "R_386_TLS_GD_32";
+        case R_386_TLS_GD_PUSH: return "R_386_TLS_GD_PUSH";
+        case R_386_TLS_GD_CALL: return "R_386_TLS_GD_CALL";
+        case R_386_TLS_GD_POP: return "R_386_TLS_GD_POP";
+        case R_386_TLS_LDM_32: return "R_386_TLS_LDM_32";
+        case R_386_TLS_LDM_PUSH: return "R_386_TLS_LDM_PUSH";
+        case R_386_TLS_LDM_CALL: return "R_386_TLS_LDM_CALL";
+        case R_386_TLS_LDM_POP: return "R_386_TLS_LDM_POP";
+        case R_386_TLS_LDO_32: return "R_386_TLS_LDO_32";
+        case R_386_TLS_IE_32: return "R_386_TLS_IE_32";
+        case R_386_TLS_LE_32: return "R_386_TLS_LE_32";
+        case R_386_TLS_DTPMOD32: return "R_386_TLS_DTPMOD32";
+        case R_386_TLS_DTPOFF32: return "R_386_TLS_DTPOFF32";
+        case R_386_TLS_TPOFF32: return "R_386_TLS_TPOFF32";
+        case R_386_SIZE32: return "R_386_SIZE32";
+        case R_386_TLS_GOTDESC: return "R_386_TLS_GOTDESC";
+        case R_386_TLS_DESC_CALL: return "R_386_TLS_DESC_CALL";
+        case R_386_TLS_DESC: return "R_386_TLS_DESC";
+        case R_386_IRELATIVE: return "R_386_IRELATIVE";
+        case R_386_GOT32X: return "R_386_GOT32X";
+        default: return nullptr;
+    }
+}
+
+// 不含 ILP32（R_AARCH64_P32_*）的类型
+static const char *GetAArch64RelocationTypeName(int type)
+{
+    switch (type)
+    {
+        case R_AARCH64_NONE: return "R_AARCH64_NONE";
+        case R_AARCH64_ABS64: return "R_AARCH64_ABS64";
+        case R_AARCH64_ABS32: return "R_AARCH64_ABS32";
+        case R_AARCH64_ABS16: return "R_AARCH64_ABS16";
+        case R_AARCH64_PREL64: return "R_AARCH64_PREL64";
+        case R_AARCH64_PREL32: return "R_AARCH64_PREL32";
+        case R_AARCH64_PREL16: return "R_AARCH64_PREL16";
+        case R_AARCH64_MOVW_UABS_G0: return "R_AARCH64_MOVW_UABS_G0";
+        case R_AARCH64_MOVW_UABS_G0_NC: return "R_AARCH64_MOVW_UABS_G0_NC";
+        case R_AARCH64_MOVW_UABS_G1: return "R_AARCH64_MOVW_UABS_G1";
+        case R_AARCH64_MOVW_UABS_G1_NC: return "R_AARCH64_MOVW_UABS_G1_NC";
+        case R_AARCH64_MOVW_UABS_G2: return "R_AARCH64_MOVW_UABS_G2";
+        case R_AARCH64_MOVW_UABS_G2_NC: return "R_AARCH64_MOVW_UABS_G2_NC";
+        case R_AARCH64_MOVW_UABS_G3: return "R_AARCH64_MOVW_UABS_G3";
+        case R_AARCH64_MOVW_SABS_G0: return "R_AARCH64_MOVW_SABS_G0";
+        case R_AARCH64_MOVW_SABS_G1: return "R_AARCH64_MOVW_SABS_G1";
+        case R_AARCH64_MOVW_SABS_G2: return "R_AARCH64_MOVW_SABS_G2";
+        case R_AARCH64_LD_PREL_LO19: return "R_AARCH64_LD_PREL_LO19";
+        case R_AARCH64_ADR_PREL_LO21: return "R_AARCH64_ADR_PREL_LO21";
+        case R_AARCH64_ADR_PREL_PG_HI21: return "R_AARCH64_ADR_PREL_PG_HI21";
+        case R_AARCH64_ADR_PREL_PG_HI21_NC: return "R_AARCH64_ADR_PREL_PG_HI21_NC";
+        case R_AARCH64_ADD_ABS_LO12_NC: return "R_AARCH64_ADD_ABS_LO12_NC";
+        case R_AARCH64_LDST8_ABS_LO12_NC: return "R_AARCH64_LDST8_ABS_LO12_NC";
+        case R_AARCH64_TSTBR14: return "R_AARCH64_TSTBR14";
+        case R_AARCH64_CONDBR19: return "R_AARCH64_CONDBR19";
+        case R_AARCH64_JUMP26: return "R_AARCH64_JUMP26";
+        case R_AARCH64_CALL26: return "R_AARCH64_CALL26";
+        case R_AARCH64_LDST16_ABS_LO12_NC: return "R_AARCH64_LDST16_ABS_LO12_NC";
+        case R_AARCH64_LDST32_ABS_LO12_NC: return "R_AARCH64_LDST32_ABS_LO12_NC";
+        case R_AARCH64_LDST64_ABS_LO12_NC: return "R_AARCH64_LDST64_ABS_LO12_NC";
+        case R_AARCH64_MOVW_PREL_G0: return "R_AARCH64_MOVW_PREL_G0";
+        case R_AARCH64_MOVW_PREL_G0_NC: return "R_AARCH64_MOVW_PREL_G0_NC";
+        case R_AARCH64_MOVW_PREL_G1: return "R_AARCH64_MOVW_PREL_G1";
+        case R_AARCH64_MOVW_PREL_G1_NC: return "R_AARCH64_MOVW_PREL_G1_NC";
+        case R_AARCH64_MOVW_PREL_G2: return "R_AARCH64_MOVW_PREL_G2";
+        case R_AARCH64_MOVW_PREL_G2_NC: return "R_AARCH64_MOVW_PREL_G2_NC";
+        case R_AARCH64_MOVW_PREL_G3: return "R_AARCH64_MOVW_PREL_G3";
+        case R_AARCH64_LDST128_ABS_LO12_NC: return "R_AARCH64_LDST128_ABS_LO12_NC";
+        case R_AARCH64_MOVW_GOTOFF_G0: return "R_AARCH64_MOVW_GOTOFF_G0";
+        case R_AARCH64_MOVW_GOTOFF_G0_NC: return "R_AARCH64_MOVW_GOTOFF_G0_NC";
+        case R_AARCH64_MOVW_GOTOFF_G1: return "R_AARCH64_MOVW_GOTOFF_G1";
+        case R_AARCH64_MOVW_GOTOFF_G1_NC: return "R_AARCH64_MOVW_GOTOFF_G1_NC";
+        case R_AARCH64_MOVW_GOTOFF_G2: return "R_AARCH64_MOVW_GOTOFF_G2";
+        case R_AARCH64_MOVW_GOTOFF_G2_NC: return "R_AARCH64_MOVW_GOTOFF_G2_NC";
+        case R_AARCH64_MOVW_GOTOFF_G3: return "R_AARCH64_MOVW_GOTOFF_G3";
+        case R_AARCH64_GOTREL64: return "R_AARCH64_GOTREL64";
+        case R_AARCH64_GOTREL32: return "R_AARCH64_GOTREL32";
+        case R_AARCH64_GOT_LD_PREL19: return "R_AARCH64_GOT_LD_PREL19";
+        case R_AARCH64_LD64_GOTOFF_LO15: return "R_AARCH64_LD64_GOTOFF_LO15";
+        case R_AARCH64_ADR_GOT_PAGE: return "R_AARCH64_ADR_GOT_PAGE";
+        case R_AARCH64_LD64_GOT_LO12_NC: return "R_AARCH64_LD64_GOT_LO12_NC";
+        case R_AARCH64_LD64_GOTPAGE_LO15: return "R_AARCH64_LD64_GOTPAGE_LO15";
+        case R_AARCH64_TLSGD_ADR_PREL21: return "R_AARCH64_TLSGD_ADR_PREL21";
+        case R_AARCH64_TLSGD_ADR_PAGE21: return "R_AARCH64_TLSGD_ADR_PAGE21";
+        case R_AARCH64_TLSGD_ADD_LO12_NC: return "R_AARCH64_TLSGD_ADD_LO12_NC";
+        case R_AARCH64_TLSGD_MOVW_G1: return "R_AARCH64_TLSGD_MOVW_G1";
+        case R_AARCH64_TLSGD_MOVW_G0_NC: return "R_AARCH64_TLSGD_MOVW_G0_NC";
+        case R_AARCH64_TLSLD_ADR_PREL21: return "R_AARCH64_TLSLD_ADR_PREL21";
+        case R_AARCH64_TLSLD_ADR_PAGE21: return "R_AARCH64_TLSLD_ADR_PAGE21";
+        case R_AARCH64_TLSLD_ADD_LO12_NC: return "R_AARCH64_TLSLD_ADD_LO12_NC";
+        case R_AARCH64_TLSLD_MOVW_G1: return "R_AARCH64_TLSLD_MOVW_G1";
+        case R_AARCH64_TLSLD_MOVW_G0_NC: return "R_AARCH64_TLSLD_MOVW_G0_NC";
+        case R_AARCH64_TLSLD_LD_PREL19: return "R_AARCH64_TLSLD_LD_PREL19";
+        case R_AARCH64_TLSLD_MOVW_DTPREL_G2: return "R_AARCH64_TLSLD_MOVW_DTPREL_G2";
+        case R_AARCH64_TLSLD_MOVW_DTPREL_G1: return "R_AARCH64_TLSLD_MOVW_DTPREL_G1";
+        case R_AARCH64_TLSLD_MOVW_DTPREL_G1_NC: return "R_AARCH64_TLSLD_MOVW_DTPREL_G1_NC";
+        case R_AARCH64_TLSLD_MOVW_DTPREL_G0: return "R_AARCH64_TLSLD_MOVW_DTPREL_G0";
+        case R_AARCH64_TLSLD_MOVW_DTPREL_G0_NC: return "R_AARCH64_TLSLD_MOVW_DTPREL_G0_NC";
+        case R_AARCH64_TLSLD_ADD_DTPREL_HI12: return "R_AARCH64_TLSLD_ADD_DTPREL_HI12";
+        case R_AARCH64_TLSLD_ADD_DTPREL_LO12: return "R_AARCH64_TLSLD_ADD_DTPREL_LO12";
+        case R_AARCH64_TLSLD_ADD_DTPREL_LO12_NC: return "R_AARCH64_TLSLD_ADD_DTPREL_LO12_NC";
+        case R_AARCH64_TLSLD_LDST8_DTPREL_LO12: return "R_AARCH64_TLSLD_LDST8_DTPREL_LO12";
+        case R_AARCH64_TLSLD_LDST8_DTPREL_LO12_NC: return "R_AARCH64_TLSLD_LDST8_DTPREL_LO12_NC";
+        case R_AARCH64_TLSLD_LDST16_DTPREL_LO12: return "R_AARCH64_TLSLD_LDST16_DTPREL_LO12";
+        case R_AARCH64_TLSLD_LDST16_DTPREL_LO12_NC: return "R_AARCH64_TLSLD_LDST16_DTPREL_LO12_NC";
+        case R_AARCH64_TLSLD_LDST32_DTPREL_LO12: return "R_AARCH64_TLSLD_LDST32_DTPREL_LO12";
+        case R_AARCH64_TLSLD_LDST32_DTPREL_LO12_NC: return "R_AARCH64_TLSLD_LDST32_DTPREL_LO12_NC";
+        case R_AARCH64_TLSLD_LDST64_DTPREL_LO12: return "R_AARCH64_TLSLD_LDST64_DTPREL_LO12";
+        case R_AARCH64_TLSLD_LDST64_DTPREL_LO12_NC: return "R_AARCH64_TLSLD_LDST64_DTPREL_LO12_NC";
+        case R_AARCH64_TLSIE_MOVW_GOTTPREL_G1: return "R_AARCH64_TLSIE_MOVW_GOTTPREL_G1";
+        case R_AARCH64_TLSIE_MOVW_GOTTPREL_G0_NC: return "R_AARCH64_TLSIE_MOVW_GOTTPREL_G0_NC";
+        case R_AARCH64_TLSIE_ADR_GOTTPREL_PAGE21: return "R_AARCH64_TLSIE_ADR_GOTTPREL_PAGE21";
+        case R_AARCH64_TLSIE_LD64_GOTTPREL_LO12_NC: return "R_AARCH64_TLSIE_LD64_GOTTPREL_LO12_NC";
+        case R_AARCH64_TLSIE_LD_GOTTPREL_PREL19: return "R_AARCH64_TLSIE_LD_GOTTPREL_PREL19";
+        case R_AARCH64_TLSLE_MOVW_TPREL_G2: return "R_AARCH64_TLSLE_MOVW_TPREL_G2";
+        case R_AARCH64_TLSLE_MOVW_TPREL_G1: return "R_AARCH64_TLSLE_MOVW_TPREL_G1";
+        case R_AARCH64_TLSLE_MOVW_TPREL_G1_NC: return "R_AARCH64_TLSLE_MOVW_TPREL_G1_NC";
+        case R_AARCH64_TLSLE_MOVW_TPREL_G0: return "R_AARCH64_TLSLE_MOVW_TPREL_G0";
+        case R_AARCH64_TLSLE_MOVW_TPREL_G0_NC: return "R_AARCH64_TLSLE_MOVW_TPREL_G0_NC";
+        case R_AARCH64_TLSLE_ADD_TPREL_HI12: return "R_AARCH64_TLSLE_ADD_TPREL_HI12";
+        case R_AARCH64_TLSLE_ADD_TPREL_LO12: return "R_AARCH64_TLSLE_ADD_TPREL_LO12";
+        case R_AARCH64_TLSLE_ADD_TPREL_LO12_NC: return "R_AARCH64_TLSLE_ADD_TPREL_LO12_NC";
+        case R_AARCH64_TLSLE_LDST8_TPREL_LO12: return "R_AARCH64_TLSLE_LDST8_TPREL_LO12";
+        case R_AARCH64_TLSLE_LDST8_TPREL_LO12_NC: return "R_AARCH64_TLSLE_LDST8_TPREL_LO12_NC";
+        case R_AARCH64_TLSLE_LDST16_TPREL_LO12: return "R_AARCH64_TLSLE_LDST16_TPREL_LO12";
+        case R_AARCH64_TLSLE_LDST16_TPREL_LO12_NC: return "R_AARCH64_TLSLE_LDST16_TPREL_LO12_NC";
+        case R_AARCH64_TLSLE_LDST32_TPREL_LO12: return "R_AARCH64_TLSLE_LDST32_TPREL_LO12";
+        case R_AARCH64_TLSLE_LDST32_TPREL_LO12_NC: return "R_AARCH64_TLSLE_LDST32_TPREL_LO12_NC";
+        case R_AARCH64_TLSLE_LDST64_TPREL_LO12: return "R_AARCH64_TLSLE_LDST64_TPREL_LO12";
+        case R_AARCH64_TLSLE_LDST64_TPREL_LO12_NC: return "R_AARCH64_TLSLE_LDST64_TPREL_LO12_NC";
+        case R_AARCH64_TLSDESC_LD_PREL19: return "R_AARCH64_TLSDESC_LD_PREL19";
+        case R_AARCH64_TLSDESC_ADR_PREL21: return "R_AARCH64_TLSDESC_ADR_PREL21";
+        case R_AARCH64_TLSDESC_ADR_PAGE21: return "R_AARCH64_TLSDESC_ADR_PAGE21";
+        case R_AARCH64_TLSDESC_LD64_LO12: return "R_AARCH64_TLSDESC_LD64_LO12";
+        case R_AARCH64_TLSDESC_ADD_LO12: return "R_AARCH64_TLSDESC_ADD_LO12";
+        case R_AARCH64_TLSDESC_OFF_G1: return "R_AARCH64_TLSDESC_OFF_G1";
+        case R_AARCH64_TLSDESC_OFF_G0_NC: return "R_AARCH64_TLSDESC_OFF_G0_NC";
+        case R_AARCH64_TLSDESC_LDR: return "R_AARCH64_TLSDESC_LDR";
+        case R_AARCH64_TLSDESC_ADD: return "R_AARCH64_TLSDESC_ADD";
+        case R_AARCH64_TLSDESC_CALL: return "R_AARCH64_TLSDESC_CALL";
+        case R_AARCH64_TLSLE_LDST128_TPREL_LO12: return "R_AARCH64_TLSLE_LDST128_TPREL_LO12";
+        case R_AARCH64_TLSLE_LDST128_TPREL_LO12_NC: return "R_AARCH64_TLSLE_LDST128_TPREL_LO12_NC";
+        case R_AARCH64_TLSLD_LDST128_DTPREL_LO12: return "R_AARCH64_TLSLD_LDST128_DTPREL_LO12";
+        case R_AARCH64_TLSLD_LDST128_DTPREL_LO12_NC: return "R_AARCH64_TLSLD_LDST128_DTPREL_LO12_NC";
+        case R_AARCH64_COPY: return "R_AARCH64_COPY";
+        case R_AARCH64_GLOB_DAT: return "R_AARCH64_GLOB_DAT";
+        case R_AARCH64_JUMP_SLOT: return "R_AARCH64_JUMP_SLOT";
+        case R_AARCH64_RELATIVE: return "R_AARCH64_RELATIVE";
+        case R_AARCH64_TLS_DTPMOD: return "R_AARCH64_TLS_DTPMOD";
+        case R_AARCH64_TLS_DTPREL: return "R_AARCH64_TLS_DTPREL";
+        case R_AARCH64_TLS_TPREL: return "R_AARCH64_TLS_TPREL";
+        case R_AARCH64_TLSDESC: return "R_AARCH64_TLSDESC";
+        case R_AARCH64_IRELATIVE: return "R_AARCH64_IRELATIVE";
+        default: return nullptr;
+    }
+}
+
+const char *ELFReader::GetRelocationTypeName(uint16_t machine, int type)
+{
+    if (type == RELOCATION_TYPE_RELR)
+    {
+        return "RELR";
+    }
+
+    switch (machine)
+    {
+        case EM_X86_64: return GetX86_64RelocationTypeName(type);
+        case EM_386: return GetI386RelocationTypeName(type);
+        case EM_AARCH64: return GetAArch64RelocationTypeName(type);
+        default: return nullptr;
+    }
+}
+
+const char *ELFReader::GetDynamicTagName(int64_t tag)
+{
+    switch (tag)
+    {
+        case DT_NEEDED: return "DT_NEEDED";
+        case DT_PLTRELSZ: return "DT_PLTRELSZ";
+        case DT_PLTGOT: return "DT_PLTGOT";
+        case DT_HASH: return "DT_HASH";
+        case DT_STRTAB: return "DT_STRTAB";
+        case DT_SYMTAB: return "DT_SYMTAB";
+        case DT_RELA: return "DT_RELA";
+        case DT_RELASZ: return "DT_RELASZ";
+        case DT_RELAENT: return "DT_RELAENT";
+        case DT_STRSZ: return "DT_STRSZ";
+        case DT_SYMENT: return "DT_SYMENT";
+        case DT_INIT: return "DT_INIT";
+        case DT_FINI: return "DT_FINI";
+        case DT_SONAME: return "DT_SONAME";
+        case DT_RPATH: return "DT_RPATH";
+        case DT_SYMBOLIC: return "DT_SYMBOLIC";
+        case DT_REL: return "DT_REL";
+        case DT_RELSZ: return "DT_RELSZ";
+        case DT_RELENT: return "DT_RELENT";
+        case DT_PLTREL: return "DT_PLTREL";
+        case DT_DEBUG: return "DT_DEBUG";
+        case DT_TEXTREL: return "DT_TEXTREL";
+        case DT_JMPREL: return "DT_JMPREL";
+        case DT_BIND_NOW: return "DT_BIND_NOW";
+        case DT_INIT_ARRAY: return "DT_INIT_ARRAY";
+        case DT_FINI_ARRAY: return "DT_FINI_ARRAY";
+        case DT_INIT_ARRAYSZ: return "DT_INIT_ARRAYSZ";
+        case DT_FINI_ARRAYSZ: return "DT_FINI_ARRAYSZ";
+        case DT_RUNPATH: return "DT_RUNPATH";
+        case DT_FLAGS: return "DT_FLAGS";
+        case DT_PREINIT_ARRAY: return "DT_PREINIT_ARRAY";
+        case DT_PREINIT_ARRAYSZ: return "DT_PREINIT_ARRAYSZ";
+        case DT_GNU_HASH: return "DT_GNU_HASH";
+        case DT_VERSYM: return "DT_VERSYM";
+        case DT_RELACOUNT: return "DT_RELACOUNT";
+        case DT_FLAGS_1: return "DT_FLAGS_1";
+        case DT_VERDEF: return "DT_VERDEF";
+        case DT_VERDEFNUM: return "DT_VERDEFNUM";
+        case DT_VERNEED: return "DT_VERNEED";
+        case DT_VERNEEDNUM: return "DT_VERNEEDNUM";
+        default: return nullptr;
     }
-	return true;
 }
 
 const char *ELFReader::GetELFClass() const
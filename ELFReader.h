@@ -1,15 +1,97 @@
 #pragma once
 
 #include <cstdio>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <map>
+#include <memory>
+#include <stdexcept>
 
 #include <elf.h>
 
-// ELF Format Cheatsheet: 
+#include "Arena.h"
+
+struct MappedRegion;
+
+// ELF Format Cheatsheet:
 // https://gist.github.com/x0nu11byt3/bcb35c3de461e5fb66173071a2379779
 
+// 一段连续表项的只读视图，数据一般直接位于 ELF 文件的映射内存中，本身不拥有内存
+template <typename T>
+class TableView
+{
+public:
+    TableView() : m_data(nullptr), m_size(0) {}
+    TableView(const T *data, std::size_t size) : m_data(data), m_size(size) {}
+
+    const T *begin() const { return m_data; }
+    const T *end() const { return m_data + m_size; }
+    const T *data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    const T &operator[](std::size_t i) const { return m_data[i]; }
+    const T &at(std::size_t i) const
+    {
+        if (i >= m_size)
+        {
+            throw std::out_of_range("TableView::at");
+        }
+        return m_data[i];
+    }
+
+private:
+    const T *m_data;
+    std::size_t m_size;
+};
+
+// 字符串表的只读视图，加载时保证以 '\0' 结尾
+// 引用它的名字偏移在加载时统一校验，之后通过 view() 直接取名字，不再逐次检查
+class StrTable
+{
+public:
+    StrTable() : m_data(nullptr), m_size(0) {}
+    StrTable(const char *data, std::size_t size) : m_data(data), m_size(size) {}
+
+    const char *data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+    const char &at(std::size_t offset) const
+    {
+        if (offset >= m_size)
+        {
+            throw std::out_of_range("StrTable::at");
+        }
+        return m_data[offset];
+    }
+
+    // 不做越界检查，调用方保证 offset 已校验；返回的视图之后紧跟 '\0'
+    std::string_view view(std::size_t offset) const
+    {
+        return std::string_view(m_data + offset);
+    }
+
+    // 所有偏移都在表内时返回 true
+    template <typename T, typename GetOffset>
+    bool check_offsets(const T &table, GetOffset get_offset) const
+    {
+        for (const auto &item : table)
+        {
+            if (get_offset(item) >= m_size)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    const char *m_data;
+    std::size_t m_size;
+};
+
 class ELFReader
 {
 public:
@@ -17,11 +99,15 @@ public:
     struct Section
     {
         Elf64_Shdr section_header;
-        int number;
 
-        const char *get_name(const ELFReader &reader) const
+        int get_number(const ELFReader &reader) const
+        {
+            return static_cast<int>(this - reader.m_sections.data());
+        }
+
+        std::string_view get_name(const ELFReader &reader) const
         {
-            return &reader.m_shstrs.at(section_header.sh_name);
+            return reader.m_shstrs.view(section_header.sh_name);
         }
     };
 
@@ -29,34 +115,38 @@ public:
     struct Symbol
     {
         Elf64_Sym sym;
-        int sym_type;
-        int sym_bind;
 
-        const char *get_sym_name(const ELFReader &reader) const
+        // sym_info 的低4位表示符号类型
+        int get_sym_type() const { return ELF64_ST_TYPE(sym.st_info); }
+
+        // sym_info 的高4位表示符号绑定类型
+        int get_sym_bind() const { return ELF64_ST_BIND(sym.st_info); }
+
+        std::string_view get_sym_name(const ELFReader &reader) const
         {
-            switch (sym_type)
+            switch (get_sym_type())
             {
             case STT_NOTYPE:
             case STT_OBJECT:
             case STT_FUNC:
             case STT_FILE:
-                return &reader.m_strs.at(sym.st_name);
+                return reader.m_strs.view(sym.st_name);
 
             case STT_SECTION:
                 return reader.m_sections.at(sym.st_shndx).get_name(reader);
             }
             return "unkown";
         }
-    
-        const char *get_dynsym_name(const ELFReader &reader) const
+
+        std::string_view get_dynsym_name(const ELFReader &reader) const
         {
-            switch (sym_type)
+            switch (get_sym_type())
             {
             case STT_NOTYPE:
             case STT_OBJECT:
             case STT_FUNC:
             case STT_FILE:
-                return &reader.m_dynstrs.at(sym.st_name);
+                return reader.m_dynstrs.view(sym.st_name);
 
             case STT_SECTION:
                 return reader.m_sections.at(sym.st_shndx).get_name(reader);
@@ -64,9 +154,10 @@ public:
             return "unkown";
         }
 
-        std::string get_sym_type_desc() const
+        // 类型、绑定的名字，未知时返回 nullptr（由调用方输出数值，不必为每行构造字符串）
+        const char *get_sym_type_name() const
         {
-            switch(sym_type)
+            switch(get_sym_type())
             {
             case STT_NOTYPE:
                 return "STT_NOTYPE";
@@ -79,13 +170,13 @@ public:
             case STT_FILE:
                 return "STT_FILE";
             default:
-                return std::to_string(sym_type);
+                return nullptr;
             }
         }
-    
-        std::string get_sym_bind_desc() const
+
+        const char *get_sym_bind_name() const
         {
-            switch (sym_bind)
+            switch (get_sym_bind())
             {
                 case STB_LOCAL:
                     return "STB_LOCAL";
@@ -94,11 +185,23 @@ public:
                 case STB_WEAK:
                     return "STB_WEAK";
                 default:
-                    return std::to_string(sym_bind);
+                    return nullptr;
             }
         }
-    
-        const char *get_sym_section_desc(const ELFReader &reader) const
+
+        std::string get_sym_type_desc() const
+        {
+            const char *name = get_sym_type_name();
+            return name != nullptr ? name : std::to_string(get_sym_type());
+        }
+
+        std::string get_sym_bind_desc() const
+        {
+            const char *name = get_sym_bind_name();
+            return name != nullptr ? name : std::to_string(get_sym_bind());
+        }
+
+        std::string_view get_sym_section_desc(const ELFReader &reader) const
         {
             switch (sym.st_shndx)
             {
@@ -118,22 +221,26 @@ public:
 	struct Relocation
 	{
 		Elf64_Rela rel;
-		int type;
-		int symbol_index;
 
-        const char *get_symbol_name(const ELFReader &reader) const
+		// 解析类型
+		int get_type() const { return ELF64_R_TYPE(rel.r_info); }
+
+		// 解析符号表下标
+		int get_symbol_index() const { return ELF64_R_SYM(rel.r_info); }
+
+        std::string_view get_symbol_name(const ELFReader &reader) const
         {
-            return reader.m_symbols.at(symbol_index).get_sym_name(reader);
+            return reader.GetSymbols().at(get_symbol_index()).get_sym_name(reader);
         }
 
-        const char *get_dynsym_name(const ELFReader &reader) const
+        std::string_view get_dynsym_name(const ELFReader &reader) const
         {
-            return reader.m_dynsyms.at(symbol_index).get_dynsym_name(reader);
+            return reader.GetDynSyms().at(get_symbol_index()).get_dynsym_name(reader);
         }
 
-        std::string get_type_desc() const
+        const char *get_type_name() const
         {
-            switch (type)
+            switch (get_type())
             {
                 case R_X86_64_32:
                     return "R_X86_64_32";
@@ -148,9 +255,15 @@ public:
                 case R_X86_64_GLOB_DAT:
                     return "R_X86_64_GLOB_DAT";
                 default:
-                    return std::to_string(type);
+                    return nullptr;
             }
         }
+
+        std::string get_type_desc() const
+        {
+            const char *name = get_type_name();
+            return name != nullptr ? name : std::to_string(get_type());
+        }
 	};
 
     // dynamic 表项
@@ -159,32 +272,264 @@ public:
         Elf64_Dyn dyn;
     };
 
+    // 一个 SHT_RELA 或 SHT_REL 段，符号表与被重定位的段分别由 sh_link、sh_info 指定。
+    // SHT_REL 的加数存放在被重定位的位置上，这里的 r_addend 记为 0
+    struct RelocationTable
+    {
+        const Section *section = nullptr;   // 重定位段本身
+        const Section *target = nullptr;    // 被重定位的段，sh_info 为 0 时为空
+        bool is_dyn = false;                // 符号来自 .dynsym
+        TableView<Relocation> relocations;
+        // 与 relocations 一一对应的符号，加载时一次性关联好（存放在读取器的 arena 中）；下标越界或没有符号表时为空
+        TableView<const Symbol*> symbols;
+
+        std::string_view get_name(const ELFReader &reader) const { return section->get_name(reader); }
+
+        std::string_view get_symbol_name(const ELFReader &reader, std::size_t i) const
+        {
+            const Symbol *symbol = symbols[i];
+            if (symbol == nullptr)
+            {
+                return std::string_view();
+            }
+            return is_dyn ? symbol->get_dynsym_name(reader) : symbol->get_sym_name(reader);
+        }
+    };
+
+    // 读取新文件前会清空上一个文件的内容，但保留已申请的内存（arena、容器容量、映射对象），
+    // 同一个对象反复读取文件时不再分配内存。读取失败时对象为空。
+
+    // 从已打开的文件读取，优先 mmap 整个文件，失败（如管道）时退化为一次性读入内存
     bool ReadELFFile(FILE *fp);
 
-    const char *GetELFClass() const; // ELF64
+    // 按路径 mmap 打开文件，映射与本对象（及其拷贝）同生命周期
+    bool ReadELFFile(const char *path);
+
+    // 直接解析调用方提供的内存，不做拷贝，调用方需保证 data 在本对象使用期间有效
+    bool ReadELFBuffer(const void *data, std::size_t size);
+
+    // 同上，data 由 holder 持有，与本对象（及其拷贝）同生命周期
+    bool ReadELFBuffer(const void *data, std::size_t size, const std::shared_ptr<const void> &holder);
+
+    // ELF32/ELF64、大小端的文件都能读：打开时按文件头选定一次布局，非本机 ELF64 布局的头、段表、程序头、
+    // 符号、重定位、dynamic 在首次解析时整表解码为下面的 Elf64 记录（存放在 arena 中），之后各接口与读 ELF64 文件时一致；
+    // 本机字节序的 ELF64 文件仍直接在映像上原地访问。哈希表只在本机 ELF64 布局下使用，其余退化为线性查找
+
+    // 读取器会访问其数据的段（符号表、字符串表、重定位表、dynamic、哈希表、note），
+    // 其余段（代码、数据、调试信息等）的内容从不读取
+    static bool IsTableSection(Elf64_Word sh_type);
+
+    // 地址到行号查找（LineIndex）用到的 DWARF 段，紧凑映像中与上面的表一起保留
+    static bool IsLineInfoSection(std::string_view name);
+
+    const Elf64_Ehdr &GetHeader() const { return m_header; }
+    const char *GetELFClass() const; // ELF32 / ELF64
     const char *GetELFType() const; // .o executable .so
 
-    const std::vector<Section> &GetSections() const { return m_sections; }
-    const std::vector<Symbol> &GetSymbols() const { return m_symbols; }
-    const std::vector<Symbol> &GetDynSyms() const { return m_dynsyms; }
-    const std::map<std::string, std::vector<Relocation>> &GetRelocations() const { return m_relocations; }
-    const std::vector<Dynamic> &GetDynamics() const { return m_dynamics; }
-    const std::string &GetDynamicStrs() const { return m_dynstrs; }
+    // 只看文件头就能得到的信息，用于快速筛选文件
+    struct TriageInfo
+    {
+        unsigned char elf_class; // ELFCLASS32 / ELFCLASS64
+        unsigned char data;      // ELFDATA2LSB / ELFDATA2MSB
+        uint16_t type;           // ET_*
+        uint16_t machine;        // EM_*
+        uint64_t file_size;
+    };
+
+    // 用一次 pread 读取文件头判断是否为 ELF 文件，不是 ELF 时静默返回 false（不输出错误），
+    // 支持 ELF32/ELF64 及两种字节序
+    static bool Triage(int fd, TriageInfo &info);
+
+    static const char *GetClassName(unsigned char elf_class);
+    static const char *GetTypeName(uint16_t type);
+    static const char *GetMachineName(uint16_t machine);
+
+    // 重定位类型（x86_64、i386、aarch64）与 dynamic tag 的名字，未知时返回 nullptr；
+    // -r 与 --diff 共用，比 Relocation::get_type_name 全。RELOCATION_TYPE_RELR 在各架构下都叫 "RELR"
+    static const char *GetRelocationTypeName(uint16_t machine, int type);
+    static const char *GetDynamicTagName(int64_t tag);
+
+    // 段表在读文件时即解析，其余各表在第一次访问时才解析（各表独立），
+    // 因此只看段表时不会触碰符号、重定位等表的数据。
+    // 注意首次访问会修改内部缓存，多线程共享同一对象前应先调用 LoadAllTables()
+    const TableView<Section> &GetSections() const { return m_sections; }
+    const TableView<Elf64_Phdr> &GetProgramHeaders() const { return m_program_headers; } // 随段表一起读取；紧凑映像不保留程序头，为空
+
+    // 按名字找段，没有时返回 nullptr
+    const Section *FindSection(std::string_view name) const;
+
+    // 段在映像中的原始内容；SHT_NOBITS、越界或紧凑映像中没有保留数据的段为空
+    std::string_view GetSectionContent(const Section &section) const;
+    const TableView<Symbol> &GetSymbols() const;
+    const TableView<Symbol> &GetDynSyms() const;
+    const std::vector<RelocationTable> &GetRelocations() const; // 按段下标排列
+
+    // SHT_RELR 段（.relr.dyn，DT_RELR）中的相对重定位条数。RELR 只是地址与位图的压缩编码，
+    // 不出现在 GetRelocations() 中，统计重定位时用 RELOCATION_TYPE_RELR 这个伪类型计入
+    static constexpr int RELOCATION_TYPE_RELR = -1;
+    uint64_t GetRelrRelocationNum() const;
+    const TableView<Dynamic> &GetDynamics() const;
+    const StrTable &GetDynamicStrs() const;
+    const StrTable &GetSymbolStrs() const; // .symtab 的字符串表
+
+    // 一次性解析所有表
+    void LoadAllTables() const;
+
+    // 借助文件自带的 .gnu.hash（优先）或 .hash 按名字查找动态符号，与动态链接器的做法一致：
+    // 先用布隆过滤器排除，再只比较同一个桶链上哈希值相同的符号。两者都没有时退化为线性查找。
+    // 与不带版本的查找一样，有 .gnu.version 时优先返回非隐藏的版本（如 memcpy@@GLIBC_2.14 而非 memcpy@GLIBC_2.2.5），
+    // 只有隐藏的版本时才返回它。找不到时返回 nullptr
+    const Symbol *FindDynamicSymbol(const char *name) const;
+
+    // .gnu.version 中动态符号的版本号，最高位（VERSYM_HIDDEN）为 1 表示隐藏的非默认版本；没有版本表时为 VER_NDX_GLOBAL
+    static const uint16_t VERSYM_HIDDEN = 0x8000;
+    uint16_t GetDynSymVersion(std::size_t index) const;
+
+    // 哈希表分布情况，用于发现分布不均、拖慢进程启动的库
+    struct HashTableStats
+    {
+        const char *kind = "";          // ".gnu.hash" / ".hash"
+        uint32_t bucket_num = 0;
+        uint32_t symbol_num = 0;        // 表中挂接的符号数
+        uint32_t empty_bucket_num = 0;
+        uint32_t max_chain_len = 0;
+        uint32_t bloom_word_num = 0;    // 仅 .gnu.hash
+        uint32_t bloom_bits_set = 0;    // 仅 .gnu.hash，置位的比特数
+        std::vector<uint32_t> chain_len_histogram; // 下标为链长，值为桶数
+    };
+
+    // 返回文件中每个哈希表的统计信息（可能为 0~2 个）
+    std::vector<HashTableStats> GetHashTableStats() const;
+
+    // GNU build-id 的十六进制串，没有时返回空串
+    std::string GetBuildId() const;
+
+    // 紧凑映像：原始 ELF 头与段表，加上符号表、字符串表、重定位表、dynamic、哈希表、note 等段的数据，
+    // 丢弃代码、数据、调试信息等段的内容。映像可以 mmap 后直接用 ReadELFFile/ReadELFBuffer 打开，
+    // 打开后各接口的结果与读原文件时一致。extra 为附加数据（如序列化的 SymbolIndex），8 字节对齐存放
+    void WriteCompactImage(std::string &out, const std::string &extra) const;
+
+    // 当前打开的是紧凑映像时返回其附加数据，否则返回 nullptr
+    const char *GetCompactExtra(std::size_t &size) const;
 
 private:
-    static bool ReadStrTable(FILE *fp, const Elf64_Shdr &section_header, std::string &str_table);
-    static bool ReadSymbolTable(FILE *fp, const Elf64_Shdr &section_header, std::vector<Symbol> &symbols);
-	bool ReadRelocationTable(FILE *fp, const Elf64_Shdr &section_header, const std::string &section_name);
-    bool ReadDynamicTable(FILE *fp, const Elf64_Shdr &section_header);
+    // 按需解析的表
+    enum LazyTable
+    {
+        LAZY_SYMBOLS,
+        LAZY_DYNSYMS,
+        LAZY_RELOCATIONS,
+        LAZY_DYNAMICS,
+        LAZY_DYNSTRS,
+        LAZY_HASH,      // .gnu.hash、.hash 与 .gnu.version
+        LAZY_TABLE_NUM
+    };
+
+    // 随文件布局而变的记录
+    enum RecordKind
+    {
+        RECORD_SECTION,
+        RECORD_PROGRAM_HEADER,
+        RECORD_SYMBOL,
+        RECORD_RELA,
+        RECORD_REL,
+        RECORD_DYNAMIC,
+        RECORD_KIND_NUM
+    };
+
+    // 一种 ELF 类别与字节序组合的记录大小与解码函数，定义在 ELFReader.cpp
+    struct Layout;
+
+    template <unsigned char elf_class, bool swap>
+    static const Layout &GetLayout();
+
+    // 按 EI_CLASS、EI_DATA 选定布局，不支持时返回 nullptr
+    static const Layout *SelectLayout(unsigned char elf_class, unsigned char data);
+
+    // 回到未读取文件的状态，保留可复用的内存
+    void Reset();
+
+    // 存放本文件拷贝出来的数据，没有时现建
+    Arena &GetArena() const;
+
+    bool ParseImage(const char *image, std::size_t image_size, const std::shared_ptr<const void> &holder);
+    bool ParseCompactImage(const char *image, std::size_t image_size, const std::shared_ptr<const void> &holder);
+    bool LoadSectionTable(const Elf64_Shdr &section_table_header);
+
+    void LoadSymbolTable(Elf64_Word sh_type, TableView<Symbol> &symbols, StrTable &str_table) const;
+    void LoadRelocationTables() const;
+    void LoadDynamicTable() const;
+    void LoadDynamicStrTable() const;
+    void LoadHashTables() const;
+    void LoadVersymTable() const;
+
+    // 首次调用时加载按名字查找用到的表（LAZY_HASH），之后什么也不做
+    void EnsureHashTables() const;
+
+    // 段数据在映像中的起始地址，越界时返回 nullptr
+    const char *GetSectionBytes(const Elf64_Shdr &section_header) const;
+
+    // 取段在映像中的数据，起始地址未按 align 对齐时拷贝一份，越界时返回 nullptr
+    const char *GetSectionData(const Elf64_Shdr &section_header, std::size_t align) const;
+
+    bool ReadStrTable(const Elf64_Shdr &section_header, StrTable &str_table) const;
+    template <typename T>
+    bool ReadTable(const Elf64_Shdr &section_header, TableView<T> &table) const;
+
+    // 按文件布局读 kind 类记录：本机 ELF64 布局直接走上面的原地访问，其余整表解码一次
+    template <typename T>
+    bool ReadRecords(const Elf64_Shdr &section_header, TableView<T> &table, RecordKind kind) const;
 
 private:
+    const char *m_image = nullptr; // 整个 ELF 文件的内存映像
+    std::size_t m_image_size = 0;
+    std::shared_ptr<const void> m_image_holder; // 持有映射（或读入的缓冲区），拷贝之间共享
+    std::shared_ptr<MappedRegion> m_mapped_region; // 映射对象，没有其他拷贝持有时下一个文件复用
+    // 拷贝出来的数据：未对齐的表、补了结尾的字符串表、重定位关联的符号。
+    // 拷贝之间共享，拷贝后若要在不同线程中使用，应先调用 LoadAllTables()
+    mutable std::shared_ptr<Arena> m_arena;
+
+    const Layout *m_layout = nullptr; // 打开文件时选定，之后不再变
     Elf64_Ehdr m_header;
-    std::vector<Section> m_sections;
-    std::string m_shstrs; // 段表字符串表
-    std::string m_strs; // 字符串表
-    std::string m_dynstrs; // 动态链接字符串表
-    std::vector<Symbol> m_symbols;
-    std::vector<Symbol> m_dynsyms;
-	std::map<std::string, std::vector<Relocation>> m_relocations;
-    std::vector<Dynamic> m_dynamics;
+    TableView<Section> m_sections;
+    TableView<Elf64_Phdr> m_program_headers;
+    TableView<uint64_t> m_data_offsets; // 仅紧凑映像：各段数据在映像中的偏移，没有数据时为 UINT64_MAX
+    const char *m_compact_extra = nullptr;
+    std::size_t m_compact_extra_size = 0;
+    StrTable m_shstrs; // 段表字符串表
+
+    mutable bool m_loaded[LAZY_TABLE_NUM] {};
+    mutable StrTable m_strs; // 字符串表
+    mutable StrTable m_dynstrs; // 动态链接字符串表
+    mutable TableView<Symbol> m_symbols;
+    mutable TableView<Symbol> m_dynsyms;
+    mutable std::vector<RelocationTable> m_relocations;
+    mutable TableView<Dynamic> m_dynamics;
+
+    // .gnu.hash 的布局：头部 4 个 uint32，之后依次是布隆过滤器、桶、哈希链
+    struct GnuHashTable
+    {
+        uint32_t bucket_num = 0;
+        uint32_t sym_offset = 0; // 第一个参与哈希的动态符号下标
+        uint32_t bloom_size = 0;
+        uint32_t bloom_shift = 0;
+        const uint64_t *bloom = nullptr;
+        const uint32_t *buckets = nullptr;
+        const uint32_t *chains = nullptr; // 下标为 符号下标 - sym_offset
+        uint32_t chain_num = 0;
+    };
+
+    // .hash 的布局：nbucket、nchain，之后是桶与链
+    struct SysvHashTable
+    {
+        uint32_t bucket_num = 0;
+        uint32_t chain_num = 0;
+        const uint32_t *buckets = nullptr;
+        const uint32_t *chains = nullptr;
+    };
+
+    mutable GnuHashTable m_gnu_hash;
+    mutable SysvHashTable m_sysv_hash;
+    mutable const char *m_versyms = nullptr; // .gnu.version 的原始数据，每项一个 Elf64_Half，未必对齐
+    mutable std::size_t m_versym_num = 0;
 };
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include <unistd.h>
+
+#include "NumberFormat.h"
+
+// 带大缓冲的输出：直接 write(2) 到文件描述符，绕过 iostream。
+// fd 为 -1 时只累积在内存里，由调用方用 TakeBuffer() 取走（批量模式下每个工作线程先写到自己的缓冲）
+class FdWriter
+{
+public:
+    explicit FdWriter(int fd = -1, std::size_t capacity = 1 << 20) : m_fd(fd), m_capacity(capacity)
+    {
+        m_buffer.reserve(capacity);
+    }
+
+    FdWriter(const FdWriter&) = delete;
+    FdWriter &operator=(const FdWriter&) = delete;
+
+    ~FdWriter() { this->Flush(); }
+
+    void Write(const char *data, std::size_t size)
+    {
+        if (m_fd >= 0 && m_buffer.size() + size > m_capacity)
+        {
+            this->Flush();
+            if (size >= m_capacity)
+            {
+                this->WriteFd(data, size);
+                return;
+            }
+        }
+        m_buffer.append(data, size);
+    }
+
+    void Write(std::string_view s) { this->Write(s.data(), s.size()); }
+    void Put(char c) { this->Write(&c, 1); }
+
+    // 十进制整数，不经过 std::string
+    void WriteUInt(uint64_t v)
+    {
+        char buffer[NUMBER_MAX_LEN];
+        this->Write(buffer, NumberFormat::FormatUInt(buffer, v) - buffer);
+    }
+
+    void WriteInt(int64_t v)
+    {
+        char buffer[NUMBER_MAX_LEN];
+        this->Write(buffer, NumberFormat::FormatInt(buffer, v) - buffer);
+    }
+
+    // 按内存布局原样写出（二进制格式用）
+    template <typename T>
+    void WriteRaw(const T &v) { this->Write(reinterpret_cast<const char*>(&v), sizeof(v)); }
+
+    // 写 size 个 0
+    void WriteZeros(std::size_t size)
+    {
+        m_buffer.append(size, '\0');
+        if (m_fd >= 0 && m_buffer.size() > m_capacity)
+        {
+            this->Flush();
+        }
+    }
+
+    void Flush()
+    {
+        if (m_fd >= 0 && !m_buffer.empty())
+        {
+            this->WriteFd(m_buffer.data(), m_buffer.size());
+            m_buffer.clear();
+        }
+    }
+
+    // 仅内存模式：取走已写内容
+    std::string TakeBuffer()
+    {
+        std::string out;
+        out.swap(m_buffer);
+        m_buffer.reserve(m_capacity);
+        return out;
+    }
+
+    bool Failed() const { return m_failed; }
+
+private:
+    void WriteFd(const char *data, std::size_t size)
+    {
+        while (size > 0 && !m_failed)
+        {
+            ssize_t n = ::write(m_fd, data, size);
+            if (n < 0)
+            {
+                if (errno == EINTR) continue;
+                m_failed = true;
+                break;
+            }
+            data += n;
+            size -= n;
+        }
+    }
+
+private:
+    int m_fd;
+    std::size_t m_capacity;
+    std::string m_buffer;
+    bool m_failed = false;
+};
@@ -0,0 +1,960 @@
+#include "LineIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace
+{
+    // 用到的 DWARF 常量（系统不一定装有 dwarf.h）
+    enum
+    {
+        DW_UT_compile = 0x01,
+        DW_UT_type = 0x02,
+        DW_UT_skeleton = 0x04,
+        DW_UT_split_compile = 0x05,
+        DW_UT_split_type = 0x06,
+
+        DW_AT_stmt_list = 0x10,
+        DW_AT_low_pc = 0x11,
+        DW_AT_high_pc = 0x12,
+        DW_AT_comp_dir = 0x1b,
+
+        DW_FORM_addr = 0x01,
+        DW_FORM_block2 = 0x03,
+        DW_FORM_block4 = 0x04,
+        DW_FORM_data2 = 0x05,
+        DW_FORM_data4 = 0x06,
+        DW_FORM_data8 = 0x07,
+        DW_FORM_string = 0x08,
+        DW_FORM_block = 0x09,
+        DW_FORM_block1 = 0x0a,
+        DW_FORM_data1 = 0x0b,
+        DW_FORM_flag = 0x0c,
+        DW_FORM_sdata = 0x0d,
+        DW_FORM_strp = 0x0e,
+        DW_FORM_udata = 0x0f,
+        DW_FORM_ref_addr = 0x10,
+        DW_FORM_ref1 = 0x11,
+        DW_FORM_ref2 = 0x12,
+        DW_FORM_ref4 = 0x13,
+        DW_FORM_ref8 = 0x14,
+        DW_FORM_ref_udata = 0x15,
+        DW_FORM_indirect = 0x16,
+        DW_FORM_sec_offset = 0x17,
+        DW_FORM_exprloc = 0x18,
+        DW_FORM_flag_present = 0x19,
+        DW_FORM_strx = 0x1a,
+        DW_FORM_addrx = 0x1b,
+        DW_FORM_ref_sup4 = 0x1c,
+        DW_FORM_strp_sup = 0x1d,
+        DW_FORM_data16 = 0x1e,
+        DW_FORM_line_strp = 0x1f,
+        DW_FORM_ref_sig8 = 0x20,
+        DW_FORM_implicit_const = 0x21,
+        DW_FORM_loclistx = 0x22,
+        DW_FORM_rnglistx = 0x23,
+        DW_FORM_ref_sup8 = 0x24,
+        DW_FORM_strx1 = 0x25,
+        DW_FORM_strx2 = 0x26,
+        DW_FORM_strx3 = 0x27,
+        DW_FORM_strx4 = 0x28,
+        DW_FORM_addrx1 = 0x29,
+        DW_FORM_addrx2 = 0x2a,
+        DW_FORM_addrx3 = 0x2b,
+        DW_FORM_addrx4 = 0x2c,
+        DW_FORM_GNU_addr_index = 0x1f01,
+        DW_FORM_GNU_str_index = 0x1f02,
+        DW_FORM_GNU_ref_alt = 0x1f20,
+        DW_FORM_GNU_strp_alt = 0x1f21,
+
+        DW_LNS_copy = 1,
+        DW_LNS_advance_pc = 2,
+        DW_LNS_advance_line = 3,
+        DW_LNS_set_file = 4,
+        DW_LNS_const_add_pc = 8,
+        DW_LNS_fixed_advance_pc = 9,
+
+        DW_LNE_end_sequence = 1,
+        DW_LNE_set_address = 2,
+        DW_LNE_define_file = 3,
+
+        DW_LNCT_path = 1,
+        DW_LNCT_directory_index = 2,
+    };
+
+    const uint64_t NO_OFFSET = UINT64_MAX;
+    const uint32_t NO_FILE = UINT32_MAX;   // 行表中表示序列结束；文件表中表示不存在的 0 号文件（DWARF 5 之前）
+
+    // 带边界检查的顺序读取，越界后置 failed，之后读到的都是 0
+    struct Cursor
+    {
+        const unsigned char *data;
+        std::size_t size;
+        std::size_t pos;
+        bool failed = false;
+
+        Cursor(std::string_view bytes, std::size_t offset) :
+            data(reinterpret_cast<const unsigned char*>(bytes.data())), size(bytes.size()), pos(offset)
+        {
+            failed = offset > size;
+        }
+
+        std::size_t Remaining() const { return failed ? 0 : size - pos; }
+
+        bool Skip(uint64_t n)
+        {
+            if (failed || n > size - pos)
+            {
+                failed = true;
+                return false;
+            }
+            pos += n;
+            return true;
+        }
+
+        uint64_t ReadFixed(std::size_t n)
+        {
+            uint64_t value = 0;
+            if (n > 8 || !this->Skip(n))
+            {
+                failed = true;
+                return 0;
+            }
+            memcpy(&value, data + pos - n, n); // 只支持小端
+            return value;
+        }
+
+        uint8_t U8() { return static_cast<uint8_t>(this->ReadFixed(1)); }
+        uint16_t U16() { return static_cast<uint16_t>(this->ReadFixed(2)); }
+        uint32_t U32() { return static_cast<uint32_t>(this->ReadFixed(4)); }
+        uint64_t U64() { return this->ReadFixed(8); }
+        uint64_t Offset(bool is64) { return is64 ? this->U64() : this->U32(); }
+
+        uint64_t ULEB()
+        {
+            uint64_t value = 0;
+            for (int shift = 0; !failed; shift += 7)
+            {
+                if (pos >= size)
+                {
+                    failed = true;
+                    break;
+                }
+                uint8_t byte = data[pos++];
+                if (shift < 64)
+                {
+                    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                }
+                if ((byte & 0x80) == 0)
+                {
+                    return value;
+                }
+            }
+            return 0;
+        }
+
+        int64_t SLEB()
+        {
+            uint64_t value = 0;
+            int shift = 0;
+            for (; !failed; shift += 7)
+            {
+                if (pos >= size)
+                {
+                    failed = true;
+                    break;
+                }
+                uint8_t byte = data[pos++];
+                if (shift < 64)
+                {
+                    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                }
+                if ((byte & 0x80) == 0)
+                {
+                    if (shift + 7 < 64 && (byte & 0x40))
+                    {
+                        value |= ~static_cast<uint64_t>(0) << (shift + 7);
+                    }
+                    return static_cast<int64_t>(value);
+                }
+            }
+            return 0;
+        }
+
+        std::string_view CStr()
+        {
+            if (failed)
+            {
+                return std::string_view();
+            }
+            const void *end = memchr(data + pos, '\0', size - pos);
+            if (end == nullptr)
+            {
+                failed = true;
+                return std::string_view();
+            }
+            std::string_view s(reinterpret_cast<const char*>(data + pos), static_cast<const unsigned char*>(end) - (data + pos));
+            pos += s.size() + 1;
+            return s;
+        }
+
+        // 单元头的长度字段：0xffffffff 表示 64 位 DWARF，其后是 8 字节长度
+        uint64_t Length(bool &is64)
+        {
+            uint64_t length = this->U32();
+            is64 = length == 0xffffffffu;
+            if (is64)
+            {
+                length = this->U64();
+            }
+            return length;
+        }
+
+        // 只保留到 pos + length 为止的数据
+        bool Limit(uint64_t length)
+        {
+            if (failed || length > size - pos)
+            {
+                failed = true;
+                return false;
+            }
+            size = pos + length;
+            return true;
+        }
+    };
+
+    // 读一个属性值：定长与变长整数返回其值，字符串、块等只跳过（值为 0）
+    bool ReadFormValue(Cursor &cursor, uint64_t form, uint16_t version, uint8_t address_size, bool is64, uint64_t &value)
+    {
+        value = 0;
+        switch (form)
+        {
+            case DW_FORM_addr: value = cursor.ReadFixed(address_size); break;
+            case DW_FORM_data1: case DW_FORM_ref1: case DW_FORM_flag: case DW_FORM_strx1: case DW_FORM_addrx1:
+                value = cursor.U8(); break;
+            case DW_FORM_data2: case DW_FORM_ref2: case DW_FORM_strx2: case DW_FORM_addrx2:
+                value = cursor.U16(); break;
+            case DW_FORM_strx3: case DW_FORM_addrx3:
+                value = cursor.ReadFixed(3); break;
+            case DW_FORM_data4: case DW_FORM_ref4: case DW_FORM_ref_sup4: case DW_FORM_strx4: case DW_FORM_addrx4:
+                value = cursor.U32(); break;
+            case DW_FORM_data8: case DW_FORM_ref8: case DW_FORM_ref_sig8: case DW_FORM_ref_sup8:
+                value = cursor.U64(); break;
+            case DW_FORM_data16: cursor.Skip(16); break;
+            case DW_FORM_sdata: value = static_cast<uint64_t>(cursor.SLEB()); break;
+            case DW_FORM_udata: case DW_FORM_ref_udata: case DW_FORM_strx: case DW_FORM_addrx:
+            case DW_FORM_loclistx: case DW_FORM_rnglistx: case DW_FORM_GNU_addr_index: case DW_FORM_GNU_str_index:
+                value = cursor.ULEB(); break;
+            case DW_FORM_strp: case DW_FORM_line_strp: case DW_FORM_sec_offset: case DW_FORM_strp_sup:
+            case DW_FORM_GNU_ref_alt: case DW_FORM_GNU_strp_alt:
+                value = cursor.Offset(is64); break;
+            case DW_FORM_ref_addr: value = version <= 2 ? cursor.ReadFixed(address_size) : cursor.Offset(is64); break;
+            case DW_FORM_string: cursor.CStr(); break;
+            case DW_FORM_block1: cursor.Skip(cursor.U8()); break;
+            case DW_FORM_block2: cursor.Skip(cursor.U16()); break;
+            case DW_FORM_block4: cursor.Skip(cursor.U32()); break;
+            case DW_FORM_block: case DW_FORM_exprloc: cursor.Skip(cursor.ULEB()); break;
+            case DW_FORM_flag_present: case DW_FORM_implicit_const: value = 1; break;
+            case DW_FORM_indirect: return ReadFormValue(cursor, cursor.ULEB(), version, address_size, is64, value);
+            default: return false;
+        }
+        return !cursor.failed;
+    }
+
+    // 取 .debug_str / .debug_line_str 中的字符串
+    std::string_view StrAt(std::string_view section, uint64_t offset)
+    {
+        if (offset >= section.size())
+        {
+            return std::string_view();
+        }
+        const char *begin = section.data() + offset;
+        const void *end = memchr(begin, '\0', section.size() - offset);
+        return end == nullptr ? std::string_view() : std::string_view(begin, static_cast<const char*>(end) - begin);
+    }
+
+    // 字符串形式（string、strp、line_strp）的属性值，value_pos 为 ReadFormValue 读之前 cursor 的位置
+    std::string_view FormString(const Cursor &cursor, std::size_t value_pos, uint64_t form, uint64_t value,
+        std::string_view debug_str, std::string_view debug_line_str)
+    {
+        switch (form)
+        {
+            case DW_FORM_string:
+                return std::string_view(reinterpret_cast<const char*>(cursor.data + value_pos), cursor.pos - value_pos - 1);
+            case DW_FORM_line_strp:
+                return StrAt(debug_line_str, value);
+            case DW_FORM_strp:
+                return StrAt(debug_str, value);
+            default:
+                return std::string_view(); // strx 需要 .debug_str_offsets，不支持
+        }
+    }
+
+}
+
+bool LineIndex::Build(const ELFReader &reader)
+{
+    auto content = [&reader](const char *name)
+    {
+        const ELFReader::Section *section = reader.FindSection(name);
+        // 压缩的调试段（SHF_COMPRESSED）不支持
+        if (section == nullptr || (section->section_header.sh_flags & SHF_COMPRESSED))
+        {
+            return std::string_view();
+        }
+        return reader.GetSectionContent(*section);
+    };
+
+    // 各字段按小端读取，大端文件不支持
+    if (reader.GetHeader().e_ident[EI_DATA] != ELFDATA2LSB)
+    {
+        return false;
+    }
+
+    m_debug_line = content(".debug_line");
+    m_debug_info = content(".debug_info");
+    m_debug_abbrev = content(".debug_abbrev");
+    m_debug_aranges = content(".debug_aranges");
+    m_debug_str = content(".debug_str");
+    m_debug_line_str = content(".debug_line_str");
+
+    m_skip_zero_sequences = reader.GetHeader().e_type != ET_REL;
+
+    if (m_debug_line.empty())
+    {
+        return false;
+    }
+
+    if (!m_debug_info.empty() && !m_debug_abbrev.empty())
+    {
+        this->LoadUnitsFromInfo();
+    }
+    if (m_units.empty())
+    {
+        this->LoadUnitsFromLine();
+    }
+
+    std::sort(m_ranges.begin(), m_ranges.end(), [](const Range &a, const Range &b) { return a.start < b.start; });
+    return !m_units.empty();
+}
+
+void LineIndex::LoadUnitsFromInfo()
+{
+    std::unordered_map<uint64_t, uint32_t> unit_by_offset;
+
+    Cursor cursor(m_debug_info, 0);
+    while (cursor.Remaining() > 0)
+    {
+        uint64_t offset = cursor.pos;
+        bool is64 = false;
+        uint64_t length = cursor.Length(is64);
+        if (cursor.failed || length == 0 || !cursor.Skip(length))
+        {
+            break;
+        }
+
+        unit_by_offset[offset] = static_cast<uint32_t>(m_units.size());
+        m_units.push_back(Unit { offset, NO_OFFSET, std::string_view(), false });
+    }
+
+    // .debug_aranges 中列出的单元直接用它的范围
+    std::vector<bool> has_range(m_units.size(), false);
+    Cursor aranges(m_debug_aranges, 0);
+    while (aranges.Remaining() > 0)
+    {
+        std::size_t set_begin = aranges.pos;
+        bool is64 = false;
+        uint64_t length = aranges.Length(is64);
+        std::size_t set_end = aranges.pos + length;
+        if (aranges.failed || length > aranges.Remaining())
+        {
+            break;
+        }
+
+        Cursor set = aranges;
+        set.Limit(length);
+        set.U16(); // version
+        uint64_t info_offset = set.Offset(is64);
+        uint8_t address_size = set.U8();
+        uint8_t segment_size = set.U8();
+        aranges.pos = set_end;
+
+        auto it = unit_by_offset.find(info_offset);
+        if (set.failed || it == unit_by_offset.end() || (address_size != 4 && address_size != 8) || segment_size != 0)
+        {
+            continue;
+        }
+
+        // 各项按 2 * address_size 对齐（相对本组起点）
+        const std::size_t tuple_size = 2 * address_size;
+        std::size_t header_size = set.pos - set_begin;
+        set.Skip((tuple_size - header_size % tuple_size) % tuple_size);
+        while (set.Remaining() >= tuple_size)
+        {
+            uint64_t start = set.ReadFixed(address_size);
+            uint64_t size = set.ReadFixed(address_size);
+            if (start == 0 && size == 0)
+            {
+                break;
+            }
+            if (size == 0 || (start == 0 && m_skip_zero_sequences))
+            {
+                continue;
+            }
+            m_ranges.push_back(Range { start, start + size, it->second });
+            has_range[it->second] = true;
+        }
+    }
+
+    // 其余的单元读编译单元 DIE，顺便取得行号程序的偏移
+    for (uint32_t i = 0; i < m_units.size(); i++)
+    {
+        if (has_range[i])
+        {
+            continue;
+        }
+
+        uint64_t line_offset = NO_OFFSET;
+        uint64_t low_pc = 1, high_pc = 0;
+        if (!this->ReadUnitDie(m_units[i].info_offset, line_offset, low_pc, high_pc, m_units[i].comp_dir) ||
+            line_offset == NO_OFFSET)
+        {
+            // 没有行号程序的单元（如类型单元）不参与查找
+            m_units[i].decoded = true;
+            continue;
+        }
+
+        m_units[i].line_offset = line_offset;
+        if (low_pc < high_pc && !(low_pc == 0 && m_skip_zero_sequences))
+        {
+            m_ranges.push_back(Range { low_pc, high_pc, i });
+        }
+        else
+        {
+            // 地址不连续（DW_AT_ranges）或没有地址的单元，查不到时再解码
+            m_unranged_units.push_back(i);
+        }
+    }
+}
+
+void LineIndex::LoadUnitsFromLine()
+{
+    // 没有 .debug_info 时每个行号程序当作一个范围未知的单元
+    Cursor cursor(m_debug_line, 0);
+    while (cursor.Remaining() > 0)
+    {
+        uint64_t offset = cursor.pos;
+        bool is64 = false;
+        uint64_t length = cursor.Length(is64);
+        if (cursor.failed || length == 0 || !cursor.Skip(length))
+        {
+            break;
+        }
+
+        m_unranged_units.push_back(static_cast<uint32_t>(m_units.size()));
+        m_units.push_back(Unit { NO_OFFSET, offset, std::string_view(), false });
+    }
+}
+
+bool LineIndex::ReadUnitDie(uint64_t info_offset, uint64_t &line_offset, uint64_t &low_pc, uint64_t &high_pc,
+    std::string_view &comp_dir) const
+{
+    Cursor cursor(m_debug_info, info_offset);
+    bool is64 = false;
+    uint64_t length = cursor.Length(is64);
+    if (!cursor.Limit(length))
+    {
+        return false;
+    }
+
+    uint16_t version = cursor.U16();
+    if (version < 2 || version > 5)
+    {
+        return false;
+    }
+
+    uint8_t unit_type = DW_UT_compile;
+    uint8_t address_size = 0;
+    uint64_t abbrev_offset = 0;
+    if (version >= 5)
+    {
+        unit_type = cursor.U8();
+        address_size = cursor.U8();
+        abbrev_offset = cursor.Offset(is64);
+        if (unit_type == DW_UT_skeleton || unit_type == DW_UT_split_compile)
+        {
+            cursor.Skip(8); // dwo_id
+        }
+        else if (unit_type == DW_UT_type || unit_type == DW_UT_split_type)
+        {
+            cursor.Skip(8);
+            cursor.Offset(is64);
+        }
+    }
+    else
+    {
+        abbrev_offset = cursor.Offset(is64);
+        address_size = cursor.U8();
+    }
+
+    uint64_t code = cursor.ULEB();
+    if (cursor.failed || code == 0)
+    {
+        return false;
+    }
+
+    // 在本单元的缩写表中找到第一个 DIE 的缩写
+    Cursor abbrev(m_debug_abbrev, abbrev_offset);
+    for (;;)
+    {
+        uint64_t abbrev_code = abbrev.ULEB();
+        if (abbrev.failed || abbrev_code == 0)
+        {
+            return false;
+        }
+        abbrev.ULEB(); // tag
+        abbrev.U8();   // children
+        if (abbrev_code == code)
+        {
+            break;
+        }
+        for (;;)
+        {
+            uint64_t name = abbrev.ULEB();
+            uint64_t form = abbrev.ULEB();
+            if (form == DW_FORM_implicit_const)
+            {
+                abbrev.SLEB();
+            }
+            if (abbrev.failed || (name == 0 && form == 0))
+            {
+                break;
+            }
+        }
+    }
+
+    bool has_low_pc = false, has_high_pc = false, high_is_size = false;
+    uint64_t low = 0, high = 0;
+    for (;;)
+    {
+        uint64_t name = abbrev.ULEB();
+        uint64_t form = abbrev.ULEB();
+        int64_t implicit_value = form == DW_FORM_implicit_const ? abbrev.SLEB() : 0;
+        if (abbrev.failed)
+        {
+            return false;
+        }
+        if (name == 0 && form == 0)
+        {
+            break;
+        }
+
+        std::size_t value_pos = cursor.pos;
+        uint64_t value = 0;
+        if (!ReadFormValue(cursor, form, version, address_size, is64, value))
+        {
+            return false;
+        }
+        if (form == DW_FORM_implicit_const)
+        {
+            value = static_cast<uint64_t>(implicit_value);
+        }
+
+        switch (name)
+        {
+            case DW_AT_stmt_list:
+                line_offset = value;
+                break;
+            case DW_AT_low_pc:
+                // addrx 需要 .debug_addr，按没有地址处理
+                has_low_pc = form == DW_FORM_addr;
+                low = value;
+                break;
+            case DW_AT_high_pc:
+                has_high_pc = form != DW_FORM_addrx && form != DW_FORM_GNU_addr_index &&
+                    !(form >= DW_FORM_addrx1 && form <= DW_FORM_addrx4);
+                high_is_size = form != DW_FORM_addr; // DWARF 4 起 high_pc 可以是相对 low_pc 的长度
+                high = value;
+                break;
+            case DW_AT_comp_dir:
+                comp_dir = FormString(cursor, value_pos, form, value, m_debug_str, m_debug_line_str);
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (has_low_pc && has_high_pc)
+    {
+        low_pc = low;
+        high_pc = high_is_size ? low + high : high;
+    }
+    return true;
+}
+
+LineIndex::Match LineIndex::LookupAddress(uint64_t addr)
+{
+    Match match;
+    if (m_units.empty())
+    {
+        return match;
+    }
+
+    // 先解码地址所在的单元
+    auto range = std::upper_bound(m_ranges.begin(), m_ranges.end(), addr,
+        [](uint64_t value, const Range &r) { return value < r.start; });
+    bool covered = range != m_ranges.begin() && addr < (range - 1)->end;
+    if (covered)
+    {
+        this->DecodeUnit((range - 1)->unit);
+    }
+
+    auto find_row = [this, addr]()
+    {
+        auto it = std::upper_bound(m_rows.begin(), m_rows.end(), addr,
+            [](uint64_t value, const Row &row) { return value < row.address; });
+        return it == m_rows.begin() || (it - 1)->file == NO_FILE ? m_rows.end() : it - 1;
+    };
+
+    auto row = find_row();
+    if (row == m_rows.end() && !covered && !m_unranged_units.empty())
+    {
+        for (uint32_t unit : m_unranged_units)
+        {
+            this->DecodeUnit(unit);
+        }
+        m_unranged_units.clear();
+        row = find_row();
+    }
+
+    if (row != m_rows.end())
+    {
+        match.file = m_files[row->file];
+        match.line = row->line;
+        match.address = row->address;
+    }
+    return match;
+}
+
+void LineIndex::DecodeUnit(uint32_t index)
+{
+    Unit &unit = m_units[index];
+    if (unit.decoded)
+    {
+        return;
+    }
+    unit.decoded = true;
+    m_decoded_unit_num++;
+
+    if (unit.line_offset == NO_OFFSET)
+    {
+        uint64_t low_pc = 1, high_pc = 0;
+        if (!this->ReadUnitDie(unit.info_offset, unit.line_offset, low_pc, high_pc, unit.comp_dir) ||
+            unit.line_offset == NO_OFFSET)
+        {
+            return;
+        }
+    }
+
+    m_new_rows.clear();
+    this->DecodeLineProgram(unit.line_offset, unit.comp_dir);
+    this->MergeNewRows();
+}
+
+bool LineIndex::DecodeLineProgram(uint64_t offset, std::string_view comp_dir)
+{
+    Cursor cursor(m_debug_line, offset);
+    bool is64 = false;
+    uint64_t length = cursor.Length(is64);
+    if (!cursor.Limit(length))
+    {
+        return false;
+    }
+
+    uint16_t version = cursor.U16();
+    if (version < 2 || version > 5)
+    {
+        return false;
+    }
+
+    uint8_t address_size = 8;
+    if (version >= 5)
+    {
+        address_size = cursor.U8();
+        cursor.U8(); // segment_selector_size
+    }
+    uint64_t header_length = cursor.Offset(is64);
+    std::size_t program_begin = cursor.pos + header_length;
+
+    uint8_t min_inst_length = cursor.U8();
+    if (version >= 4)
+    {
+        cursor.U8(); // maximum_operations_per_instruction，x86 上为 1
+    }
+    cursor.U8(); // default_is_stmt
+    int8_t line_base = static_cast<int8_t>(cursor.U8());
+    uint8_t line_range = cursor.U8();
+    uint8_t opcode_base = cursor.U8();
+    const unsigned char *opcode_lengths = cursor.data + cursor.pos;
+    if (cursor.failed || line_range == 0 || opcode_base == 0 || !cursor.Skip(opcode_base - 1) || program_begin > cursor.size)
+    {
+        return false;
+    }
+
+    // 目录与文件表，文件转成全局编号
+    std::vector<std::string_view> dirs;
+    std::vector<uint32_t> files;
+    if (version < 5)
+    {
+        dirs.push_back(comp_dir); // 0 号目录即编译目录
+        for (;;)
+        {
+            std::string_view dir = cursor.CStr();
+            if (cursor.failed || dir.empty())
+            {
+                break;
+            }
+            dirs.push_back(dir);
+        }
+
+        files.push_back(NO_FILE); // 文件从 1 开始编号
+        for (;;)
+        {
+            std::string_view name = cursor.CStr();
+            if (cursor.failed || name.empty())
+            {
+                break;
+            }
+            uint64_t dir = cursor.ULEB();
+            cursor.ULEB(); // mtime
+            cursor.ULEB(); // length
+            files.push_back(this->InternFile(comp_dir, dir < dirs.size() ? dirs[dir] : std::string_view(), name));
+        }
+    }
+    else
+    {
+        // DWARF 5：目录与文件都是按格式描述的表
+        for (int table = 0; table < 2 && !cursor.failed; table++)
+        {
+            std::vector<std::pair<uint64_t, uint64_t>> formats;
+            uint8_t format_count = cursor.U8();
+            for (uint8_t i = 0; i < format_count; i++)
+            {
+                uint64_t content_type = cursor.ULEB();
+                uint64_t form = cursor.ULEB();
+                formats.emplace_back(content_type, form);
+            }
+
+            uint64_t count = cursor.ULEB();
+            for (uint64_t i = 0; i < count && !cursor.failed; i++)
+            {
+                std::string_view path;
+                uint64_t dir = 0;
+                for (const auto &format : formats)
+                {
+                    std::size_t value_pos = cursor.pos;
+                    uint64_t value = 0;
+                    if (!ReadFormValue(cursor, format.second, version, address_size, is64, value))
+                    {
+                        return false;
+                    }
+
+                    if (format.first == DW_LNCT_path)
+                    {
+                        path = FormString(cursor, value_pos, format.second, value, m_debug_str, m_debug_line_str);
+                    }
+                    else if (format.first == DW_LNCT_directory_index)
+                    {
+                        dir = value;
+                    }
+                }
+
+                if (table == 0)
+                {
+                    dirs.push_back(path);
+                }
+                else
+                {
+                    files.push_back(this->InternFile(comp_dir, dir < dirs.size() ? dirs[dir] : std::string_view(), path));
+                }
+            }
+        }
+    }
+    if (cursor.failed)
+    {
+        return false;
+    }
+
+    // 执行行号程序，每段序列结束时补一个结束标记
+    const uint32_t unknown_file = this->InternFile(std::string_view(), std::string_view(), "??");
+    auto file_id = [&files, unknown_file](uint64_t file)
+    {
+        return file < files.size() && files[file] != NO_FILE ? files[file] : unknown_file;
+    };
+
+    cursor.pos = program_begin;
+    uint64_t address = 0;
+    uint64_t file = 1;
+    int64_t line = 1;
+    std::size_t sequence_begin = m_new_rows.size();
+
+    auto emit_row = [&]()
+    {
+        m_new_rows.push_back(Row { address, file_id(file), static_cast<uint32_t>(line) });
+    };
+
+    while (cursor.Remaining() > 0)
+    {
+        uint8_t opcode = cursor.U8();
+        if (opcode >= opcode_base)
+        {
+            // 特殊操作码：同时推进地址与行号并生成一行
+            uint8_t adjusted = opcode - opcode_base;
+            address += static_cast<uint64_t>(adjusted / line_range) * min_inst_length;
+            line += line_base + adjusted % line_range;
+            emit_row();
+            continue;
+        }
+
+        switch (opcode)
+        {
+            case 0:
+            {
+                uint64_t extended_length = cursor.ULEB();
+                if (cursor.failed || extended_length == 0 || extended_length > cursor.Remaining())
+                {
+                    cursor.failed = true;
+                    break;
+                }
+                std::size_t extended_end = cursor.pos + extended_length;
+                uint8_t sub_opcode = cursor.U8();
+                if (sub_opcode == DW_LNE_end_sequence)
+                {
+                    // 与结束地址相同的行长度为 0，丢掉
+                    while (m_new_rows.size() > sequence_begin && m_new_rows.back().address >= address)
+                    {
+                        m_new_rows.pop_back();
+                    }
+                    bool discarded = m_new_rows.size() > sequence_begin && m_skip_zero_sequences &&
+                        m_new_rows[sequence_begin].address == 0;
+                    if (discarded)
+                    {
+                        m_new_rows.resize(sequence_begin);
+                    }
+                    else if (m_new_rows.size() > sequence_begin)
+                    {
+                        m_new_rows.push_back(Row { address, NO_FILE, 0 });
+                    }
+                    sequence_begin = m_new_rows.size();
+                    address = 0;
+                    file = 1;
+                    line = 1;
+                }
+                else if (sub_opcode == DW_LNE_set_address)
+                {
+                    address = cursor.ReadFixed(std::min<std::size_t>(extended_length - 1, 8));
+                }
+                else if (sub_opcode == DW_LNE_define_file)
+                {
+                    std::string_view name = cursor.CStr();
+                    uint64_t dir = cursor.ULEB();
+                    files.push_back(this->InternFile(comp_dir, dir < dirs.size() ? dirs[dir] : std::string_view(), name));
+                }
+                cursor.pos = extended_end;
+                break;
+            }
+            case DW_LNS_copy:
+                emit_row();
+                break;
+            case DW_LNS_advance_pc:
+                address += cursor.ULEB() * min_inst_length;
+                break;
+            case DW_LNS_advance_line:
+                line += cursor.SLEB();
+                break;
+            case DW_LNS_set_file:
+                file = cursor.ULEB();
+                break;
+            case DW_LNS_const_add_pc:
+                address += static_cast<uint64_t>((255 - opcode_base) / line_range) * min_inst_length;
+                break;
+            case DW_LNS_fixed_advance_pc:
+                address += cursor.U16();
+                break;
+            default:
+                // 其余标准操作码（列号、is_stmt 等）与查找无关，按声明的参数个数跳过
+                for (uint8_t i = 0; i < opcode_lengths[opcode - 1]; i++)
+                {
+                    cursor.ULEB();
+                }
+                break;
+        }
+        if (cursor.failed)
+        {
+            break;
+        }
+    }
+
+    // 没有正常结束的序列不要
+    m_new_rows.resize(sequence_begin);
+    return !cursor.failed;
+}
+
+void LineIndex::MergeNewRows()
+{
+    if (m_new_rows.empty())
+    {
+        return;
+    }
+
+    // 同一地址上序列结束标记排在前面，新序列的第一行覆盖它
+    auto less = [](const Row &a, const Row &b)
+    {
+        if (a.address != b.address)
+        {
+            return a.address < b.address;
+        }
+        return a.file == NO_FILE && b.file != NO_FILE;
+    };
+    std::stable_sort(m_new_rows.begin(), m_new_rows.end(), less);
+
+    std::size_t old_size = m_rows.size();
+    m_rows.insert(m_rows.end(), m_new_rows.begin(), m_new_rows.end());
+    std::inplace_merge(m_rows.begin(), m_rows.begin() + old_size, m_rows.end(), less);
+    m_new_rows.clear();
+}
+
+uint32_t LineIndex::InternFile(std::string_view comp_dir, std::string_view dir, std::string_view name)
+{
+    // 相对路径依次拼上目录与编译目录，DWARF 4 与 5 得到同样的绝对路径
+    auto is_relative = [](std::string_view path) { return path.empty() || path[0] != '/'; };
+
+    std::string path;
+    if (is_relative(name))
+    {
+        if (is_relative(dir) && !comp_dir.empty() && dir != comp_dir)
+        {
+            path.append(comp_dir.data(), comp_dir.size());
+            path += '/';
+        }
+        if (!dir.empty())
+        {
+            path.append(dir.data(), dir.size());
+            path += '/';
+        }
+    }
+    path.append(name.data(), name.size());
+
+    auto it = m_file_ids.find(path);
+    if (it != m_file_ids.end())
+    {
+        return it->second;
+    }
+
+    std::string_view stored = m_arena.Store(path);
+    uint32_t id = static_cast<uint32_t>(m_files.size());
+    m_files.push_back(stored.data());
+    m_file_ids.emplace(stored, id);
+    return id;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Arena.h"
+#include "ELFReader.h"
+
+// 地址 -> 源码行（file:line），基于 DWARF 的 .debug_line（版本 2~5）。
+// 建立时只确定各编译单元的地址范围：有 .debug_aranges 时取自它，否则取编译单元 DIE 的 low_pc/high_pc。
+// 某个单元的行号程序在第一次查到它范围内的地址时才解码，解码出的行并入一张按地址排序的紧凑表，
+// 之后的查找都在这张表上二分，不再重放行号程序。范围未知的单元在第一次查不到时一并解码。
+//
+// 只读 reader 的映像，reader 须在本对象使用期间有效；查找会解码并修改内部状态，非线程安全
+class LineIndex
+{
+public:
+    struct Match
+    {
+        const char *file = nullptr; // 源文件路径，本对象存活期间有效
+        uint32_t line = 0;
+        uint64_t address = 0;       // 该行的起始地址
+
+        bool found() const { return file != nullptr; }
+    };
+
+    LineIndex() {}
+    LineIndex(const LineIndex&) = delete;
+    LineIndex &operator=(const LineIndex&) = delete;
+    explicit LineIndex(const ELFReader &reader) { this->Build(reader); }
+
+    // 没有 .debug_line（或格式不支持）时返回 false，之后的查找都找不到
+    bool Build(const ELFReader &reader);
+
+    Match LookupAddress(uint64_t addr);
+
+    bool HasLineInfo() const { return !m_units.empty(); }
+    std::size_t GetUnitNum() const { return m_units.size(); }
+    std::size_t GetDecodedUnitNum() const { return m_decoded_unit_num; }
+    std::size_t GetRowNum() const { return m_rows.size(); }
+
+private:
+    struct Unit
+    {
+        uint64_t info_offset;   // 编译单元在 .debug_info 中的偏移，没有 .debug_info 时为 UINT64_MAX
+        uint64_t line_offset;   // 行号程序在 .debug_line 中的偏移，解码前才从 DIE 中取得时为 UINT64_MAX
+        std::string_view comp_dir; // DW_AT_comp_dir，与 line_offset 一起从 DIE 中取得
+        bool decoded;
+    };
+
+    struct Range
+    {
+        uint64_t start;
+        uint64_t end;   // 不含
+        uint32_t unit;
+    };
+
+    // 表中的一行覆盖 [address, 下一行的 address)；file 为 UINT32_MAX 表示一段指令序列在此结束
+    struct Row
+    {
+        uint64_t address;
+        uint32_t file;
+        uint32_t line;
+    };
+
+    void LoadUnitsFromInfo();
+    void LoadUnitsFromLine();
+
+    // 读编译单元的第一个 DIE，取出行号程序偏移、地址范围（没有时 low_pc > high_pc）与编译目录
+    bool ReadUnitDie(uint64_t info_offset, uint64_t &line_offset, uint64_t &low_pc, uint64_t &high_pc,
+        std::string_view &comp_dir) const;
+
+    void DecodeUnit(uint32_t unit);
+    bool DecodeLineProgram(uint64_t offset, std::string_view comp_dir);
+    void MergeNewRows();
+
+    // name 为相对路径时拼上 dir，结果仍为相对路径时再拼上编译目录
+    uint32_t InternFile(std::string_view comp_dir, std::string_view dir, std::string_view name);
+
+private:
+    std::string_view m_debug_line;
+    std::string_view m_debug_info;
+    std::string_view m_debug_abbrev;
+    std::string_view m_debug_aranges;
+    std::string_view m_debug_str;
+    std::string_view m_debug_line_str;
+    bool m_skip_zero_sequences = false;         // 可执行文件与共享库中从 0 开始的序列是链接时丢弃的代码
+
+    std::vector<Unit> m_units;
+    std::vector<Range> m_ranges;                // 按 start 排序
+    std::vector<uint32_t> m_unranged_units;     // 地址范围未知的单元
+    std::size_t m_decoded_unit_num = 0;
+
+    std::vector<Row> m_rows;                    // 按 address 排序
+    std::vector<Row> m_new_rows;                // 解码一个单元时暂存
+
+    Arena m_arena;                              // 文件路径
+    std::vector<const char*> m_files;
+    std::unordered_map<std::string_view, uint32_t> m_file_ids;
+};
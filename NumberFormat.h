@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+
+// 整数格式化：直接写入调用方提供的缓冲（至少 NUMBER_MAX_LEN 字节），返回写入后的末尾，不分配内存
+const std::size_t NUMBER_MAX_LEN = 24;
+
+namespace NumberFormat
+{
+    // 00 01 02 ... 99，每次处理两位十进制数
+    static const char DIGIT_PAIRS[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    inline char *FormatUInt(char *out, uint64_t v)
+    {
+        char buffer[NUMBER_MAX_LEN];
+        char *p = buffer + sizeof(buffer);
+        while (v >= 100)
+        {
+            const char *pair = DIGIT_PAIRS + (v % 100) * 2;
+            v /= 100;
+            *--p = pair[1];
+            *--p = pair[0];
+        }
+        if (v >= 10)
+        {
+            const char *pair = DIGIT_PAIRS + v * 2;
+            *--p = pair[1];
+            *--p = pair[0];
+        }
+        else
+        {
+            *--p = static_cast<char>('0' + v);
+        }
+
+        std::size_t len = buffer + sizeof(buffer) - p;
+        memcpy(out, p, len);
+        return out + len;
+    }
+
+    inline char *FormatInt(char *out, int64_t v)
+    {
+        if (v < 0)
+        {
+            *out++ = '-';
+            return FormatUInt(out, 0 - static_cast<uint64_t>(v));
+        }
+        return FormatUInt(out, static_cast<uint64_t>(v));
+    }
+
+    // 与 printf("0x%lx") 相同：小写，无前导 0
+    inline char *FormatHex(char *out, uint64_t v)
+    {
+        *out++ = '0';
+        *out++ = 'x';
+
+        int digits = v == 0 ? 1 : (64 - __builtin_clzll(v) + 3) / 4;
+        for (int i = digits - 1; i >= 0; i--)
+        {
+            out[i] = HEX_DIGITS[v & 0xf];
+            v >>= 4;
+        }
+        return out + digits;
+    }
+}
+
+// 按 0x 十六进制输出的整数，可直接传给 FormattedTable::AddRow 或输出到流
+struct Hex
+{
+    explicit Hex(uint64_t v) : value(v) {}
+    uint64_t value;
+};
+
+inline std::ostream &operator<<(std::ostream &os, const Hex &hex)
+{
+    char buffer[NUMBER_MAX_LEN];
+    return os.write(buffer, NumberFormat::FormatHex(buffer, hex.value) - buffer);
+}
@@ -0,0 +1,173 @@
+#include "ProcessSymbolizer.h"
+#include "Demangler.h"
+#include "NumberFormat.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include <unistd.h>
+
+bool ProcessSymbolizer::LoadMaps(int pid)
+{
+    std::string maps_path = "/proc/" + std::to_string(pid) + "/maps";
+    std::ifstream ifs(maps_path);
+    if (!ifs)
+    {
+        std::cerr << "ProcessSymbolizer::LoadMaps failed: can not open " << maps_path << std::endl;
+        return false;
+    }
+
+    m_mappings.clear();
+
+    // 格式：start-end perms offset major:minor inode path
+    std::string line;
+    while (std::getline(ifs, line))
+    {
+        uint64_t start = 0, end = 0, offset = 0, inode = 0;
+        unsigned int major = 0, minor = 0;
+        char perms[8];
+        int path_pos = 0;
+        if (sscanf(line.c_str(), "%" SCNx64 "-%" SCNx64 " %7s %" SCNx64 " %x:%x %" SCNu64 " %n",
+            &start, &end, perms, &offset, &major, &minor, &inode, &path_pos) < 7)
+        {
+            continue;
+        }
+
+        // 只要文件映射；[heap]、[stack]、匿名映射等没有 inode
+        if (inode == 0 || path_pos <= 0 || static_cast<std::size_t>(path_pos) >= line.size() || line[path_pos] != '/')
+        {
+            continue;
+        }
+
+        std::unique_ptr<Module> &module = m_modules[std::make_pair((static_cast<uint64_t>(major) << 32) | minor, inode)];
+        if (!module)
+        {
+            module.reset(new Module);
+            module->path = line.substr(path_pos);
+        }
+
+        Mapping mapping;
+        mapping.start = start;
+        mapping.end = end;
+        mapping.offset = offset;
+        mapping.module = module.get();
+        m_mappings.push_back(mapping);
+    }
+
+    std::sort(m_mappings.begin(), m_mappings.end(), [](const Mapping &a, const Mapping &b) { return a.start < b.start; });
+    return true;
+}
+
+ProcessSymbolizer::Frame ProcessSymbolizer::Symbolize(uint64_t addr)
+{
+    Frame frame;
+    frame.addr = addr;
+
+    auto it = std::upper_bound(m_mappings.begin(), m_mappings.end(), addr,
+        [](uint64_t value, const Mapping &mapping) { return value < mapping.start; });
+    if (it == m_mappings.begin() || addr >= (it - 1)->end)
+    {
+        return frame;
+    }
+
+    Mapping &mapping = *(it - 1);
+    Module &module = this->ParseModule(*mapping.module);
+    frame.module = module.path;
+    if (!module.ok)
+    {
+        frame.module_addr = addr - mapping.start + mapping.offset;
+        return frame;
+    }
+
+    if (!mapping.bias_ready)
+    {
+        mapping.bias = ComputeLoadBias(module.reader, mapping);
+        mapping.bias_ready = true;
+    }
+    frame.module_addr = addr - mapping.bias;
+    frame.match = module.index.LookupAddress(frame.module_addr);
+    return frame;
+}
+
+void ProcessSymbolizer::Format(const Frame &frame, std::string &out) const
+{
+    char buffer[NUMBER_MAX_LEN];
+    if (frame.module.empty())
+    {
+        out.append(buffer, NumberFormat::FormatHex(buffer, frame.addr));
+        return;
+    }
+
+    std::string_view module = frame.module;
+    std::size_t slash = module.rfind('/');
+    if (slash != std::string_view::npos)
+    {
+        module.remove_prefix(slash + 1);
+    }
+    out.append(module.data(), module.size());
+
+    if (!frame.match.found())
+    {
+        out += '+';
+        out.append(buffer, NumberFormat::FormatHex(buffer, frame.module_addr));
+        return;
+    }
+
+    std::string_view name = frame.match.name;
+    if (m_demangler != nullptr)
+    {
+        name = m_demangler->Demangle(name);
+    }
+    out += '!';
+    out.append(name.data(), name.size());
+    out += '+';
+    out.append(buffer, NumberFormat::FormatHex(buffer, frame.match.offset));
+}
+
+ProcessSymbolizer::Module &ProcessSymbolizer::ParseModule(Module &module)
+{
+    if (module.parsed)
+    {
+        return module;
+    }
+
+    module.parsed = true;
+    m_parsed_module_num++;
+    module.ok = module.reader.ReadELFFile(module.path.c_str());
+    if (module.ok)
+    {
+        module.index.Build(module.reader);
+    }
+    else
+    {
+        std::cerr << "ProcessSymbolizer::ParseModule failed: " << module.path << std::endl;
+    }
+    return module;
+}
+
+uint64_t ProcessSymbolizer::ComputeLoadBias(const ELFReader &reader, const Mapping &mapping)
+{
+    // 映射起点对应文件偏移 offset，找到包含它的 PT_LOAD 段（段在文件中的起点向下按页对齐），
+    // 该偏移在段内的虚拟地址为 p_vaddr + (offset - p_offset)，装载偏移 = start - 该虚拟地址
+    static const uint64_t page_size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    for (const Elf64_Phdr &phdr : reader.GetProgramHeaders())
+    {
+        if (phdr.p_type != PT_LOAD)
+        {
+            continue;
+        }
+
+        uint64_t file_begin = phdr.p_offset - phdr.p_offset % page_size;
+        uint64_t file_end = phdr.p_offset + std::max<uint64_t>(phdr.p_filesz, 1);
+        if (mapping.offset >= file_begin && mapping.offset < file_end)
+        {
+            return mapping.start - mapping.offset + phdr.p_offset - phdr.p_vaddr;
+        }
+    }
+
+    // 没有程序头（或映射不属于任何 PT_LOAD）时按虚拟地址等于文件偏移处理，对通常的共享库成立
+    return mapping.start - mapping.offset;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "ELFReader.h"
+#include "SymbolIndex.h"
+
+class Demangler;
+
+// 运行中进程的地址符号化，不需要 ptrace：读取 /proc/<pid>/maps，找到地址所在的文件映射，
+// 用模块的程序头与映射的文件偏移换算出装载偏移（load bias），再在模块的 SymbolIndex 中查找。
+//
+// 模块按 设备号 + inode 缓存，第一次查到某个模块的地址时才解析，之后所有查询（包括 LoadMaps 换成
+// 其他进程后）共用同一份解析结果，每个库只解析一次。非线程安全。
+class ProcessSymbolizer
+{
+public:
+    struct Frame
+    {
+        uint64_t addr = 0;
+        std::string_view module;    // 所在模块的路径，不在任何文件映射中时为空
+        uint64_t module_addr = 0;   // 模块内地址（addr - 装载偏移），与符号表中的值可直接比较
+        SymbolIndex::Match match;   // 模块解析失败或没有包含该地址的符号时为空
+    };
+
+    ProcessSymbolizer() {}
+    ProcessSymbolizer(const ProcessSymbolizer&) = delete;
+    ProcessSymbolizer &operator=(const ProcessSymbolizer&) = delete;
+
+    // 读取进程的映射表，替换之前的映射；已解析的模块保留
+    bool LoadMaps(int pid);
+
+    Frame Symbolize(uint64_t addr);
+
+    // 追加 module!symbol+0xoffset；没有符号时为 module+0xmodule_addr，不在模块中时为 0xaddr
+    void Format(const Frame &frame, std::string &out) const;
+
+    // 不为空时 Format 输出反修饰后的名字
+    void SetDemangler(Demangler *demangler) { m_demangler = demangler; }
+
+    std::size_t GetMappingNum() const { return m_mappings.size(); }
+    std::size_t GetModuleNum() const { return m_modules.size(); }
+    std::size_t GetParsedModuleNum() const { return m_parsed_module_num; }
+
+private:
+    struct Module
+    {
+        std::string path;
+        bool parsed = false;    // 已尝试解析（失败也不再重试）
+        bool ok = false;
+        ELFReader reader;
+        SymbolIndex index;      // 引用 reader，Module 不可移动
+    };
+
+    struct Mapping
+    {
+        uint64_t start = 0;
+        uint64_t end = 0;       // 不含
+        uint64_t offset = 0;    // 映射起点对应的文件偏移
+        Module *module = nullptr;
+        bool bias_ready = false;
+        uint64_t bias = 0;
+    };
+
+    Module &ParseModule(Module &module);
+    static uint64_t ComputeLoadBias(const ELFReader &reader, const Mapping &mapping);
+
+private:
+    std::vector<Mapping> m_mappings;    // 按 start 排序
+    std::map<std::pair<uint64_t, uint64_t>, std::unique_ptr<Module>> m_modules; // key: 设备号, inode
+    std::size_t m_parsed_module_num = 0;
+    Demangler *m_demangler = nullptr;
+};
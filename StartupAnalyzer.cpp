@@ -0,0 +1,258 @@
+#include "StartupAnalyzer.h"
+#include "ELFReader.h"
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+
+namespace
+{
+    // 各项的权重，大致按 ld.so 每做一次所花的时间定，只有相对大小有意义
+    const uint64_t WEIGHT_RELATIVE = 1;     // 一次内存写
+    const uint64_t WEIGHT_LAZY = 2;         // 写 GOT 表项，查符号推迟到第一次调用
+    const uint64_t WEIGHT_SYMBOLIC = 30;    // 在装载范围内的各个库中查一次符号
+    const uint64_t WEIGHT_COPY = 40;        // 查符号 + 复制数据
+    const uint64_t WEIGHT_IFUNC = 50;       // 调用解析函数
+    const uint64_t WEIGHT_TLS = 30;
+    const uint64_t WEIGHT_NEEDED = 2000;    // 查找、打开、映射一个库
+    const uint64_t WEIGHT_CONSTRUCTOR = 200;
+    const uint64_t WEIGHT_TEXTREL = 5000;   // 代码段改为可写、写时复制、再改回来
+}
+
+const char *StartupAnalyzer::GetKindName(Kind kind)
+{
+    switch (kind)
+    {
+        case KIND_RELATIVE: return "relative";
+        case KIND_SYMBOLIC: return "symbolic";
+        case KIND_LAZY: return "lazy";
+        case KIND_IFUNC: return "ifunc";
+        case KIND_COPY: return "copy";
+        case KIND_TLS: return "tls";
+        default: return "unknown";
+    }
+}
+
+StartupAnalyzer::Kind StartupAnalyzer::GetKind(uint16_t machine, int type, bool has_symbol, bool bind_now)
+{
+    // 不带符号的 R_X86_64_64 等只加基址
+    const Kind plain = has_symbol ? KIND_SYMBOLIC : KIND_RELATIVE;
+    const Kind jump_slot = bind_now ? KIND_SYMBOLIC : KIND_LAZY;
+
+    switch (machine)
+    {
+        case EM_X86_64:
+            switch (type)
+            {
+                case R_X86_64_RELATIVE: return KIND_RELATIVE;
+                case R_X86_64_IRELATIVE: return KIND_IFUNC;
+                case R_X86_64_COPY: return KIND_COPY;
+                case R_X86_64_JUMP_SLOT: return jump_slot;
+                case R_X86_64_DTPMOD64:
+                case R_X86_64_DTPOFF64:
+                case R_X86_64_TPOFF64:
+                case R_X86_64_TLSDESC: return KIND_TLS;
+                default: return plain;
+            }
+
+        case EM_386:
+            switch (type)
+            {
+                case R_386_RELATIVE: return KIND_RELATIVE;
+                case R_386_IRELATIVE: return KIND_IFUNC;
+                case R_386_COPY: return KIND_COPY;
+                case R_386_JMP_SLOT: return jump_slot;
+                case R_386_TLS_DTPMOD32:
+                case R_386_TLS_DTPOFF32:
+                case R_386_TLS_TPOFF:
+                case R_386_TLS_TPOFF32:
+                case R_386_TLS_DESC: return KIND_TLS;
+                default: return plain;
+            }
+
+        case EM_AARCH64:
+            switch (type)
+            {
+                case R_AARCH64_RELATIVE: return KIND_RELATIVE;
+                case R_AARCH64_IRELATIVE: return KIND_IFUNC;
+                case R_AARCH64_COPY: return KIND_COPY;
+                case R_AARCH64_JUMP_SLOT: return jump_slot;
+                case R_AARCH64_TLS_DTPMOD:
+                case R_AARCH64_TLS_DTPREL:
+                case R_AARCH64_TLS_TPREL:
+                case R_AARCH64_TLSDESC: return KIND_TLS;
+                default: return plain;
+            }
+
+        default:
+            return plain;
+    }
+}
+
+void StartupAnalyzer::Clear()
+{
+    *this = StartupAnalyzer();
+}
+
+void StartupAnalyzer::Analyze(const ELFReader &reader)
+{
+    this->Clear();
+
+    // dynamic 表：依赖、标志、构造函数
+    const TableView<ELFReader::Dynamic> &dynamics = reader.GetDynamics();
+    m_dynamic = !dynamics.empty();
+    if (!m_dynamic)
+    {
+        return;
+    }
+    m_machine = reader.GetHeader().e_machine;
+    // DT_INIT_ARRAYSZ 等以字节计，元素为一个地址
+    const uint64_t addr_size = reader.GetHeader().e_ident[EI_CLASS] == ELFCLASS32 ? sizeof(Elf32_Addr) : sizeof(Elf64_Addr);
+    for (const ELFReader::Dynamic &dynamic : dynamics)
+    {
+        const Elf64_Dyn &dyn = dynamic.dyn;
+        switch (dyn.d_tag)
+        {
+            case DT_NEEDED: m_needed_num++; break;
+            case DT_BIND_NOW: m_bind_now = true; break;
+            case DT_TEXTREL: m_textrel = true; break;
+            case DT_GNU_HASH: m_gnu_hash = true; break;
+            case DT_FLAGS: m_flags = dyn.d_un.d_val; break;
+            case DT_FLAGS_1: m_flags_1 = dyn.d_un.d_val; break;
+            case DT_INIT: m_init_num = 1; break;
+            case DT_INIT_ARRAYSZ: m_init_array_num = dyn.d_un.d_val / addr_size; break;
+            case DT_PREINIT_ARRAYSZ: m_preinit_array_num = dyn.d_un.d_val / addr_size; break;
+        }
+    }
+    m_bind_now = m_bind_now || (m_flags & DF_BIND_NOW) || (m_flags_1 & DF_1_NOW);
+    m_textrel = m_textrel || (m_flags & DF_TEXTREL);
+
+    // 导出与导入的动态符号
+    const TableView<ELFReader::Symbol> &dynsyms = reader.GetDynSyms();
+    for (std::size_t i = 1; i < dynsyms.size(); i++)
+    {
+        const Elf64_Sym &sym = dynsyms[i].sym;
+        if (sym.st_name == 0)
+        {
+            continue;
+        }
+        if (sym.st_shndx == SHN_UNDEF)
+        {
+            m_imported_num++;
+            continue;
+        }
+        int bind = ELF64_ST_BIND(sym.st_info);
+        int visibility = ELF64_ST_VISIBILITY(sym.st_other);
+        if (bind != STB_LOCAL && (visibility == STV_DEFAULT || visibility == STV_PROTECTED))
+        {
+            m_exported_num++;
+        }
+    }
+
+    // 动态重定位（SHF_ALLOC 的重定位段，即 .rela.dyn、.rela.plt 或 .rel.dyn、.rel.plt）
+    // 同一类型按有无符号可能归入不同种类（如没有符号的 R_X86_64_64 是相对重定位），按（类型, 种类）分别计数
+    std::map<std::pair<int, Kind>, uint64_t> type_nums;
+    std::unordered_map<std::string_view, uint64_t> local_targets;
+    std::vector<bool> looked_up(dynsyms.size(), false);
+    for (const ELFReader::RelocationTable &table : reader.GetRelocations())
+    {
+        if (!(table.section->section_header.sh_flags & SHF_ALLOC))
+        {
+            continue;
+        }
+
+        for (std::size_t i = 0; i < table.relocations.size(); i++)
+        {
+            const ELFReader::Relocation &relocation = table.relocations[i];
+            int type = relocation.get_type();
+            if (type == 0) // 各架构的 *_NONE 都是 0
+            {
+                continue;
+            }
+            m_relocation_num++;
+
+            const ELFReader::Symbol *symbol = relocation.get_symbol_index() != 0 ? table.symbols[i] : nullptr;
+            Kind kind = GetKind(m_machine, type, symbol != nullptr, m_bind_now);
+            m_kind_nums[kind]++;
+            type_nums[std::make_pair(type, kind)]++;
+
+            if (symbol == nullptr || kind == KIND_RELATIVE || kind == KIND_IFUNC)
+            {
+                continue;
+            }
+
+            // 装载时真正要查的符号，同一个符号查多次按一次计
+            std::size_t index = relocation.get_symbol_index();
+            if (table.is_dyn && kind != KIND_LAZY && index < looked_up.size() && !looked_up[index])
+            {
+                looked_up[index] = true;
+                m_symbol_lookup_num++;
+            }
+
+            // 符号就定义在本文件中，却仍要在运行时查找；延迟绑定的是 PLT 调用，与装载时的查找分开计
+            if (table.is_dyn && symbol->sym.st_shndx != SHN_UNDEF)
+            {
+                if (kind == KIND_SYMBOLIC)
+                {
+                    m_local_symbolic_num++;
+                    local_targets[reader.GetDynamicStrs().view(symbol->sym.st_name)]++;
+                }
+                else if (kind == KIND_LAZY)
+                {
+                    m_local_lazy_num++;
+                }
+            }
+        }
+    }
+
+    // .relr.dyn 中的都是相对重定位，按 RELR 伪类型计入
+    uint64_t relr_num = reader.GetRelrRelocationNum();
+    if (relr_num > 0)
+    {
+        type_nums[std::make_pair(ELFReader::RELOCATION_TYPE_RELR, KIND_RELATIVE)] += relr_num;
+        m_relocation_num += relr_num;
+        m_kind_nums[KIND_RELATIVE] += relr_num;
+    }
+
+    for (const auto &item : type_nums)
+    {
+        m_type_counts.push_back(TypeCount { item.first.first, item.first.second, item.second });
+    }
+    std::sort(m_type_counts.begin(), m_type_counts.end(), [](const TypeCount &a, const TypeCount &b)
+    {
+        return a.num != b.num ? a.num > b.num : a.type != b.type ? a.type < b.type : a.kind < b.kind;
+    });
+
+    m_local_symbolic_targets.reserve(local_targets.size());
+    for (const auto &item : local_targets)
+    {
+        m_local_symbolic_targets.push_back(SymbolCount { item.first, item.second });
+    }
+    std::sort(m_local_symbolic_targets.begin(), m_local_symbolic_targets.end(), [](const SymbolCount &a, const SymbolCount &b)
+    {
+        return a.num != b.num ? a.num > b.num : a.name < b.name;
+    });
+
+    this->MakeCostItems();
+}
+
+void StartupAnalyzer::MakeCostItems()
+{
+    m_cost_items = {
+        { "relative relocations", m_kind_nums[KIND_RELATIVE], WEIGHT_RELATIVE },
+        { "symbolic relocations", m_kind_nums[KIND_SYMBOLIC], WEIGHT_SYMBOLIC },
+        { "lazy PLT relocations", m_kind_nums[KIND_LAZY], WEIGHT_LAZY },
+        { "copy relocations", m_kind_nums[KIND_COPY], WEIGHT_COPY },
+        { "ifunc relocations", m_kind_nums[KIND_IFUNC], WEIGHT_IFUNC },
+        { "TLS relocations", m_kind_nums[KIND_TLS], WEIGHT_TLS },
+        { "DT_NEEDED libraries", m_needed_num, WEIGHT_NEEDED },
+        { "constructors", m_init_num + m_init_array_num + m_preinit_array_num, WEIGHT_CONSTRUCTOR },
+        { "text relocations", m_textrel ? 1u : 0u, WEIGHT_TEXTREL },
+    };
+
+    m_score = 0;
+    for (const CostItem &item : m_cost_items)
+    {
+        m_score += item.cost();
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+class ELFReader;
+
+// 估计 ld.so 在 main 之前为一个文件做的工作：只看 .dynamic、.rela.dyn/.rela.plt（i386 为 .rel.*）、.relr.dyn 与 .dynsym。
+// RELATIVE 只是加上装载基址；GLOB_DAT、64、JUMP_SLOT（BIND_NOW 时）等符号重定位每条都要在所有已装载库的
+// 散列表里查一次符号，是启动开销的大头。指向本文件内定义的符号的符号重定位，用 -Bsymbolic 或隐藏可见性
+// 就能变成 RELATIVE，单独统计出来。得分是各项条数乘以权重之和，只用于同类文件之间的比较
+class StartupAnalyzer
+{
+public:
+    enum Kind
+    {
+        KIND_RELATIVE,  // R_X86_64_RELATIVE 等
+        KIND_SYMBOLIC,  // 装载时要查符号：GLOB_DAT、64、BIND_NOW 时的 JUMP_SLOT 等
+        KIND_LAZY,      // 延迟绑定的 JUMP_SLOT，装载时只加基址，第一次调用时才查符号
+        KIND_IFUNC,     // IRELATIVE，装载时调用解析函数
+        KIND_COPY,      // COPY，查符号后还要复制数据
+        KIND_TLS,       // DTPMOD、DTPOFF、TPOFF、TLSDESC
+        KIND_NUM
+    };
+
+    struct TypeCount
+    {
+        int type;   // .relr.dyn 中的相对重定位为 ELFReader::RELOCATION_TYPE_RELR
+        Kind kind;
+        uint64_t num;
+    };
+
+    struct SymbolCount
+    {
+        std::string_view name;  // 指向 reader 的 .dynstr
+        uint64_t num;
+    };
+
+    struct CostItem
+    {
+        const char *name;
+        uint64_t num;
+        uint64_t weight;
+
+        uint64_t cost() const { return num * weight; }
+    };
+
+    StartupAnalyzer() {}
+    explicit StartupAnalyzer(const ELFReader &reader) { this->Analyze(reader); }
+
+    void Analyze(const ELFReader &reader);
+
+    // 认得 x86_64、i386、aarch64 的类型，其余架构只按有无符号分为 symbolic 与 relative
+    static Kind GetKind(uint16_t machine, int type, bool has_symbol, bool bind_now);
+    static const char *GetKindName(Kind kind);
+
+    bool IsDynamic() const { return m_dynamic; } // 有 .dynamic 时为 true，否则下面都为 0
+
+    const std::vector<TypeCount> &GetTypeCounts() const { return m_type_counts; } // 按（类型, 种类）计数，条数从多到少
+    uint64_t GetKindNum(Kind kind) const { return m_kind_nums[kind]; }
+    uint64_t GetRelocationNum() const { return m_relocation_num; }
+    uint64_t GetSymbolLookupNum() const { return m_symbol_lookup_num; } // 符号重定位涉及的不同符号数
+
+    // 指向本文件内定义的符号、装载时就要查找的符号重定位（KIND_SYMBOLIC），以及涉及的符号（按引用次数从多到少），
+    // 是 GetSymbolLookupNum 所计符号的一部分
+    uint64_t GetLocalSymbolicNum() const { return m_local_symbolic_num; }
+    const std::vector<SymbolCount> &GetLocalSymbolicTargets() const { return m_local_symbolic_targets; }
+
+    // 指向本文件内定义的函数的延迟绑定 JUMP_SLOT，第一次调用时才查找，单独统计
+    uint64_t GetLocalLazyNum() const { return m_local_lazy_num; }
+
+    uint64_t GetExportedNum() const { return m_exported_num; }
+    uint64_t GetImportedNum() const { return m_imported_num; }
+    uint64_t GetNeededNum() const { return m_needed_num; }
+
+    bool IsBindNow() const { return m_bind_now; }   // DT_BIND_NOW、DF_BIND_NOW 或 DF_1_NOW
+    bool HasTextRel() const { return m_textrel; }   // DT_TEXTREL 或 DF_TEXTREL
+    bool HasGnuHash() const { return m_gnu_hash; }
+    uint64_t GetFlags() const { return m_flags; }   // DT_FLAGS
+    uint64_t GetFlags1() const { return m_flags_1; } // DT_FLAGS_1
+
+    // 构造函数：DT_INIT 的个数（0 或 1）与 DT_INIT_ARRAY、DT_PREINIT_ARRAY 的元素数
+    uint64_t GetInitNum() const { return m_init_num; }
+    uint64_t GetInitArrayNum() const { return m_init_array_num; }
+    uint64_t GetPreinitArrayNum() const { return m_preinit_array_num; }
+
+    const std::vector<CostItem> &GetCostItems() const { return m_cost_items; }
+    uint64_t GetScore() const { return m_score; }
+
+private:
+    void Clear();
+    void MakeCostItems();
+
+private:
+    bool m_dynamic = false;
+    uint16_t m_machine = 0;
+    std::vector<TypeCount> m_type_counts;
+    uint64_t m_kind_nums[KIND_NUM] = {};
+    uint64_t m_relocation_num = 0;
+    uint64_t m_symbol_lookup_num = 0;
+    uint64_t m_local_symbolic_num = 0;
+    uint64_t m_local_lazy_num = 0;
+    std::vector<SymbolCount> m_local_symbolic_targets;
+
+    uint64_t m_exported_num = 0;
+    uint64_t m_imported_num = 0;
+    uint64_t m_needed_num = 0;
+
+    bool m_bind_now = false;
+    bool m_textrel = false;
+    bool m_gnu_hash = false;
+    uint64_t m_flags = 0;
+    uint64_t m_flags_1 = 0;
+
+    uint64_t m_init_num = 0;
+    uint64_t m_init_array_num = 0;
+    uint64_t m_preinit_array_num = 0;
+
+    std::vector<CostItem> m_cost_items;
+    uint64_t m_score = 0;
+};
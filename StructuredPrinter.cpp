@@ -0,0 +1,486 @@
+#include "StructuredPrinter.h"
+
+#include <cstring>
+#include <vector>
+
+#include "ELFReader.h"
+#include "FdWriter.h"
+#include "SymbolStore.h"
+#include "Demangler.h"
+
+static_assert(sizeof(StructuredPrinter::ColumnarBlockHeader) == 64, "columnar block header must be 64 bytes");
+static_assert(sizeof(StructuredPrinter::ColumnarColumn) == 32, "columnar column must be 32 bytes");
+
+struct StructuredPrinter::Schema
+{
+    Kind kind;
+    const char *kind_name;
+    const ColumnarColumn *columns;
+    std::size_t column_num;
+};
+
+namespace
+{
+    const StructuredPrinter::ColumnType U64 = StructuredPrinter::COLUMN_U64;
+    const StructuredPrinter::ColumnType I64 = StructuredPrinter::COLUMN_I64;
+    const StructuredPrinter::ColumnType STR = StructuredPrinter::COLUMN_STR;
+
+    const StructuredPrinter::ColumnarColumn SECTION_COLUMNS[] = {
+        { "index", U64 }, { "name", STR }, { "type", U64 }, { "flags", U64 }, { "addr", U64 },
+        { "offset", U64 }, { "size", U64 }, { "entsize", U64 }, { "link", U64 }, { "info", U64 },
+    };
+
+    const StructuredPrinter::ColumnarColumn SYMBOL_COLUMNS[] = {
+        { "index", U64 }, { "name", STR }, { "type", U64 }, { "bind", U64 }, { "shndx", U64 },
+        { "section", STR }, { "value", U64 }, { "size", U64 },
+    };
+
+    const StructuredPrinter::ColumnarColumn RELOCATION_COLUMNS[] = {
+        { "index", U64 }, { "offset", U64 }, { "type", U64 }, { "symbol_index", U64 }, { "symbol", STR }, { "addend", I64 },
+    };
+
+    const StructuredPrinter::ColumnarColumn DYNAMIC_COLUMNS[] = {
+        { "index", U64 }, { "tag", I64 }, { "value", U64 },
+    };
+
+    template <std::size_t N>
+    StructuredPrinter::Schema MakeSchema(StructuredPrinter::Kind kind, const char *kind_name, const StructuredPrinter::ColumnarColumn (&columns)[N])
+    {
+        return StructuredPrinter::Schema { kind, kind_name, columns, N };
+    }
+
+    const char COLUMNAR_MAGIC[8] = { 'E', 'L', 'F', 'R', 'C', 'O', 'L', '1' };
+
+    uint64_t Align8(uint64_t n)
+    {
+        return (n + 7) & ~static_cast<uint64_t>(7);
+    }
+
+    void WriteJsonString(FdWriter &writer, std::string_view s)
+    {
+        writer.Put('"');
+        std::size_t begin = 0;
+        for (std::size_t i = 0; i < s.size(); i++)
+        {
+            unsigned char c = static_cast<unsigned char>(s[i]);
+            if (c != '"' && c != '\\' && c >= 0x20)
+            {
+                continue;
+            }
+
+            writer.Write(s.data() + begin, i - begin);
+            begin = i + 1;
+            if (c == '"' || c == '\\')
+            {
+                writer.Put('\\');
+                writer.Put(static_cast<char>(c));
+            }
+            else
+            {
+                static const char hex[] = "0123456789abcdef";
+                char escaped[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf] };
+                writer.Write(escaped, sizeof(escaped));
+            }
+        }
+        writer.Write(s.data() + begin, s.size() - begin);
+        writer.Put('"');
+    }
+
+    void WriteCsvField(FdWriter &writer, std::string_view s)
+    {
+        if (s.find_first_of(",\"\r\n") == std::string_view::npos)
+        {
+            writer.Write(s);
+            return;
+        }
+
+        writer.Put('"');
+        for (char c : s)
+        {
+            if (c == '"') writer.Put('"');
+            writer.Put(c);
+        }
+        writer.Put('"');
+    }
+}
+
+// 接收一行的各字段，按模式写成 jsonl / csv，或为 columnar 统计、写出某一列
+class StructuredPrinter::RowSink
+{
+public:
+    enum Mode
+    {
+        MODE_JSONL,
+        MODE_CSV,
+        MODE_MEASURE,   // 统计各字符串列的总长度
+        MODE_COLUMN,    // 只写出第 m_target 列的值
+        MODE_HEAP,      // 只写出第 m_target 列的字符串
+    };
+
+    RowSink(Mode mode, FdWriter &writer, const Schema &schema, std::string_view file, std::string_view table) :
+        m_mode(mode), m_writer(&writer), m_schema(&schema), m_file(file), m_table(table)
+    {
+        if (mode == MODE_MEASURE)
+        {
+            m_str_sizes.resize(schema.column_num, 0);
+        }
+    }
+
+    void SetTarget(std::size_t column, uint64_t heap_pos)
+    {
+        m_target = column;
+        m_heap_pos = heap_pos;
+    }
+
+    void BeginRow()
+    {
+        m_column = 0;
+        if (m_mode == MODE_JSONL)
+        {
+            m_writer->Write("{\"kind\":\"");
+            m_writer->Write(m_schema->kind_name);
+            m_writer->Write("\",\"file\":");
+            WriteJsonString(*m_writer, m_file);
+            m_writer->Write(",\"table\":");
+            WriteJsonString(*m_writer, m_table);
+        }
+        else if (m_mode == MODE_CSV)
+        {
+            WriteCsvField(*m_writer, m_file);
+            m_writer->Put(',');
+            WriteCsvField(*m_writer, m_table);
+        }
+    }
+
+    void EndRow()
+    {
+        if (m_mode == MODE_JSONL)
+        {
+            m_writer->Write("}\n");
+        }
+        else if (m_mode == MODE_CSV)
+        {
+            m_writer->Put('\n');
+        }
+    }
+
+    void U(uint64_t v)
+    {
+        if (this->BeginField())
+        {
+            if (m_mode == MODE_COLUMN) m_writer->WriteRaw(v);
+            else m_writer->WriteUInt(v);
+        }
+        m_column++;
+    }
+
+    void I(int64_t v)
+    {
+        if (this->BeginField())
+        {
+            if (m_mode == MODE_COLUMN) m_writer->WriteRaw(v);
+            else m_writer->WriteInt(v);
+        }
+        m_column++;
+    }
+
+    void S(std::string_view v)
+    {
+        switch (m_mode)
+        {
+            case MODE_JSONL:
+                this->BeginField();
+                WriteJsonString(*m_writer, v);
+                break;
+
+            case MODE_CSV:
+                this->BeginField();
+                WriteCsvField(*m_writer, v);
+                break;
+
+            case MODE_MEASURE:
+                m_str_sizes[m_column] += v.size() + 1;
+                break;
+
+            case MODE_COLUMN:
+                if (m_column == m_target)
+                {
+                    m_writer->WriteRaw(m_heap_pos);
+                    m_heap_pos += v.size() + 1;
+                }
+                break;
+
+            case MODE_HEAP:
+                if (m_column == m_target)
+                {
+                    m_writer->Write(v.data(), v.size());
+                    m_writer->Put('\0');
+                }
+                break;
+        }
+        m_column++;
+    }
+
+    // 仅 MODE_MEASURE：第 column 列字符串的总长度（含 '\0'）
+    uint64_t GetStrSize(std::size_t column) const
+    {
+        return column < m_str_sizes.size() ? m_str_sizes[column] : 0;
+    }
+
+private:
+    // 文本格式写出字段前缀，返回本字段是否需要写值
+    bool BeginField()
+    {
+        switch (m_mode)
+        {
+            case MODE_JSONL:
+                m_writer->Write(",\"");
+                m_writer->Write(m_schema->columns[m_column].name);
+                m_writer->Write("\":");
+                return true;
+
+            case MODE_CSV:
+                m_writer->Put(',');
+                return true;
+
+            case MODE_COLUMN:
+                return m_column == m_target;
+
+            default:
+                return false;
+        }
+    }
+
+private:
+    Mode m_mode;
+    FdWriter *m_writer;
+    const Schema *m_schema;
+    std::string_view m_file;
+    std::string_view m_table;
+    std::size_t m_column = 0;
+    std::size_t m_target = 0;
+    uint64_t m_heap_pos = 0;
+    std::vector<uint64_t> m_str_sizes;
+};
+
+bool StructuredPrinter::ParseFormat(const std::string &name, Format &format)
+{
+    if (name == "jsonl") format = FORMAT_JSONL;
+    else if (name == "csv") format = FORMAT_CSV;
+    else if (name == "columnar") format = FORMAT_COLUMNAR;
+    else return false;
+    return true;
+}
+
+void StructuredPrinter::WriteCsvHeader(const std::string &opt, FdWriter &writer)
+{
+    const ColumnarColumn *columns = nullptr;
+    std::size_t column_num = 0;
+    if (opt == "-S") { columns = SECTION_COLUMNS; column_num = sizeof(SECTION_COLUMNS) / sizeof(SECTION_COLUMNS[0]); }
+    else if (opt == "-s") { columns = SYMBOL_COLUMNS; column_num = sizeof(SYMBOL_COLUMNS) / sizeof(SYMBOL_COLUMNS[0]); }
+    else if (opt == "-r") { columns = RELOCATION_COLUMNS; column_num = sizeof(RELOCATION_COLUMNS) / sizeof(RELOCATION_COLUMNS[0]); }
+    else if (opt == "-d") { columns = DYNAMIC_COLUMNS; column_num = sizeof(DYNAMIC_COLUMNS) / sizeof(DYNAMIC_COLUMNS[0]); }
+
+    writer.Write("file,table");
+    for (std::size_t i = 0; i < column_num; i++)
+    {
+        writer.Put(',');
+        writer.Write(columns[i].name);
+    }
+    writer.Put('\n');
+}
+
+void StructuredPrinter::WriteTable(const Schema &schema, std::string_view table, std::size_t row_num, const RowFunc &row) const
+{
+    if (m_format == FORMAT_COLUMNAR)
+    {
+        this->WriteColumnar(schema, table, row_num, row);
+        return;
+    }
+
+    RowSink sink(m_format == FORMAT_JSONL ? RowSink::MODE_JSONL : RowSink::MODE_CSV, *m_writer, schema, m_file_name, table);
+    for (std::size_t i = 0; i < row_num; i++)
+    {
+        sink.BeginRow();
+        row(i, sink);
+        sink.EndRow();
+    }
+}
+
+void StructuredPrinter::WriteColumnar(const Schema &schema, std::string_view table, std::size_t row_num, const RowFunc &row) const
+{
+    // 列式布局需要先写完一列再写下一列：先统计字符串堆大小写出块头，再对每列各遍历一次表。
+    // 各行的值都直接取自 reader 的表，不额外保存整张表
+    auto run = [&row, row_num](RowSink &sink)
+    {
+        for (std::size_t i = 0; i < row_num; i++)
+        {
+            sink.BeginRow();
+            row(i, sink);
+            sink.EndRow();
+        }
+    };
+
+    RowSink measure(RowSink::MODE_MEASURE, *m_writer, schema, m_file_name, table);
+    run(measure);
+
+    // 字符串堆：路径、表名，之后按列依次存放各字符串列
+    const uint64_t table_offset = m_file_name.size() + 1;
+    uint64_t heap_used = table_offset + table.size() + 1;
+    std::vector<uint64_t> column_heap_pos(schema.column_num, 0);
+    for (std::size_t k = 0; k < schema.column_num; k++)
+    {
+        if (schema.columns[k].type == COLUMN_STR)
+        {
+            column_heap_pos[k] = heap_used;
+            heap_used += measure.GetStrSize(k);
+        }
+    }
+
+    ColumnarBlockHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, COLUMNAR_MAGIC, sizeof(header.magic));
+    header.kind = schema.kind;
+    header.column_num = static_cast<uint32_t>(schema.column_num);
+    header.row_num = row_num;
+    header.path_offset = 0;
+    header.table_offset = table_offset;
+    header.heap_size = Align8(heap_used);
+    header.block_size = sizeof(ColumnarBlockHeader) + schema.column_num * sizeof(ColumnarColumn) +
+        schema.column_num * row_num * sizeof(uint64_t) + header.heap_size;
+
+    m_writer->WriteRaw(header);
+    for (std::size_t k = 0; k < schema.column_num; k++)
+    {
+        m_writer->WriteRaw(schema.columns[k]);
+    }
+
+    RowSink column(RowSink::MODE_COLUMN, *m_writer, schema, m_file_name, table);
+    for (std::size_t k = 0; k < schema.column_num; k++)
+    {
+        column.SetTarget(k, column_heap_pos[k]);
+        run(column);
+    }
+
+    m_writer->Write(m_file_name.data(), m_file_name.size());
+    m_writer->Put('\0');
+    m_writer->Write(table.data(), table.size());
+    m_writer->Put('\0');
+
+    RowSink heap(RowSink::MODE_HEAP, *m_writer, schema, m_file_name, table);
+    for (std::size_t k = 0; k < schema.column_num; k++)
+    {
+        if (schema.columns[k].type == COLUMN_STR)
+        {
+            heap.SetTarget(k, 0);
+            run(heap);
+        }
+    }
+    m_writer->WriteZeros(header.heap_size - heap_used);
+}
+
+std::string_view StructuredPrinter::GetSymbolName(std::string_view name) const
+{
+    return m_demangler != nullptr ? m_demangler->Demangle(name) : name;
+}
+
+void StructuredPrinter::PrintAll() const
+{
+    this->PrintSections();
+    this->PrintSymbols();
+    this->PrintRelocations();
+    this->PrintDynamics();
+}
+
+void StructuredPrinter::PrintSections() const
+{
+    static const Schema schema = MakeSchema(KIND_SECTION, "section", SECTION_COLUMNS);
+
+    const TableView<ELFReader::Section> &sections = m_elf_reader->GetSections();
+    this->WriteTable(schema, ".shdr", sections.size(), [this, &sections](std::size_t i, RowSink &sink)
+    {
+        const Elf64_Shdr &header = sections[i].section_header;
+        sink.U(i);
+        sink.S(sections[i].get_name(*m_elf_reader));
+        sink.U(header.sh_type);
+        sink.U(header.sh_flags);
+        sink.U(header.sh_addr);
+        sink.U(header.sh_offset);
+        sink.U(header.sh_size);
+        sink.U(header.sh_entsize);
+        sink.U(header.sh_link);
+        sink.U(header.sh_info);
+    });
+}
+
+void StructuredPrinter::PrintSymbols() const
+{
+    static const Schema schema = MakeSchema(KIND_SYMBOL, "symbol", SYMBOL_COLUMNS);
+
+    SymbolStore store;
+    std::vector<uint32_t> indexes;
+
+    auto print = [&](const TableView<ELFReader::Symbol> &symbols, const char *table, bool is_dyn)
+    {
+        if (m_symbol_filter != nullptr)
+        {
+            store.Build(*m_elf_reader, is_dyn);
+            store.Select(*m_symbol_filter, indexes);
+        }
+        if (m_demangler != nullptr)
+        {
+            m_demangler->Prepare(*m_elf_reader, symbols, is_dyn);
+        }
+
+        const bool filtered = m_symbol_filter != nullptr;
+        std::size_t row_num = filtered ? indexes.size() : symbols.size();
+        this->WriteTable(schema, table, row_num, [&](std::size_t row, RowSink &sink)
+        {
+            std::size_t i = filtered ? indexes[row] : row;
+            const ELFReader::Symbol &symbol = symbols[i];
+            sink.U(i);
+            sink.S(this->GetSymbolName(is_dyn ? symbol.get_dynsym_name(*m_elf_reader) : symbol.get_sym_name(*m_elf_reader)));
+            sink.U(symbol.get_sym_type());
+            sink.U(symbol.get_sym_bind());
+            sink.U(symbol.sym.st_shndx);
+            sink.S(symbol.get_sym_section_desc(*m_elf_reader));
+            sink.U(symbol.sym.st_value);
+            sink.U(symbol.sym.st_size);
+        });
+    };
+
+    print(m_elf_reader->GetSymbols(), ".symtab", false);
+    print(m_elf_reader->GetDynSyms(), ".dynsym", true);
+}
+
+void StructuredPrinter::PrintRelocations() const
+{
+    static const Schema schema = MakeSchema(KIND_RELOCATION, "relocation", RELOCATION_COLUMNS);
+
+    for (const ELFReader::RelocationTable &table : m_elf_reader->GetRelocations())
+    {
+        this->WriteTable(schema, table.get_name(*m_elf_reader), table.relocations.size(), [this, &table](std::size_t i, RowSink &sink)
+        {
+            const ELFReader::Relocation &rel = table.relocations[i];
+            sink.U(i);
+            sink.U(rel.rel.r_offset);
+            sink.U(rel.get_type());
+            sink.U(ELF64_R_SYM(rel.rel.r_info));
+            sink.S(this->GetSymbolName(table.get_symbol_name(*m_elf_reader, i)));
+            sink.I(rel.rel.r_addend);
+        });
+    }
+}
+
+void StructuredPrinter::PrintDynamics() const
+{
+    static const Schema schema = MakeSchema(KIND_DYNAMIC, "dynamic", DYNAMIC_COLUMNS);
+
+    const TableView<ELFReader::Dynamic> &dynamics = m_elf_reader->GetDynamics();
+    this->WriteTable(schema, ".dynamic", dynamics.size(), [&dynamics](std::size_t i, RowSink &sink)
+    {
+        sink.U(i);
+        sink.I(dynamics[i].dyn.d_tag);
+        sink.U(dynamics[i].dyn.d_un.d_val);
+    });
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+class ELFReader;
+class FdWriter;
+class Demangler;
+struct SymbolFilter;
+
+// 机器可读的输出：段、符号、重定位、dynamic 各表逐行直接写入 FdWriter，不在内存中拼整张表。
+//
+// jsonl    : 每行一个 JSON 对象，带 kind、file、table 字段
+// csv      : 首行为表头（WriteCsvHeader），每行以 file、table 开头；一次只能输出一种表
+// columnar : 每张表一个块，块内各列定长（8 字节）连续存放，可直接 mmap 后整列读取，布局见 ColumnarBlockHeader
+class StructuredPrinter
+{
+public:
+    enum Format
+    {
+        FORMAT_JSONL,
+        FORMAT_CSV,
+        FORMAT_COLUMNAR,
+    };
+
+    enum Kind
+    {
+        KIND_SECTION = 1,
+        KIND_SYMBOL = 2,
+        KIND_RELOCATION = 3,
+        KIND_DYNAMIC = 4,
+    };
+
+    // columnar 块头，其后依次为：column_num 个 ColumnarColumn、各列数据（每列 row_num 个 8 字节值）、字符串堆。
+    // 块大小为 8 的倍数，多个块（多张表、多个文件）直接首尾相接
+    struct ColumnarBlockHeader
+    {
+        char magic[8];          // "ELFRCOL1"
+        uint32_t kind;          // Kind
+        uint32_t column_num;
+        uint64_t row_num;
+        uint64_t path_offset;   // 文件路径在字符串堆中的偏移
+        uint64_t table_offset;  // 表名（如 .dynsym、.rela.plt）在字符串堆中的偏移
+        uint64_t heap_size;     // 字符串堆大小（含对齐填充）
+        uint64_t block_size;    // 整个块的大小
+        uint64_t reserved;
+    };
+
+    enum ColumnType
+    {
+        COLUMN_U64 = 1,
+        COLUMN_I64 = 2,
+        COLUMN_STR = 3, // 值为字符串在堆中的偏移，字符串以 '\0' 结尾
+    };
+
+    struct ColumnarColumn
+    {
+        char name[24];
+        uint64_t type;  // ColumnType
+    };
+
+    struct Schema; // 一种表的列定义
+
+    StructuredPrinter(const ELFReader *elf_reader, Format format, FdWriter &writer) :
+        m_elf_reader(elf_reader), m_format(format), m_writer(&writer)
+    {
+
+    }
+
+    static bool ParseFormat(const std::string &name, Format &format);
+
+    // csv 的表头，opt 为 -S -s -r -d 之一
+    static void WriteCsvHeader(const std::string &opt, FdWriter &writer);
+
+    void SetFileName(std::string_view file_name) { m_file_name = file_name; }
+    void SetSymbolFilter(const SymbolFilter *symbol_filter) { m_symbol_filter = symbol_filter; }
+    void SetDemangler(Demangler *demangler) { m_demangler = demangler; }
+
+    void PrintAll() const;
+    void PrintSections() const;
+    void PrintSymbols() const;
+    void PrintRelocations() const;
+    void PrintDynamics() const;
+
+private:
+    class RowSink;
+    using RowFunc = std::function<void(std::size_t row, RowSink &sink)>;
+
+    // 按格式写出一张表，row 依次输出第 row 行的各字段
+    void WriteTable(const Schema &schema, std::string_view table, std::size_t row_num, const RowFunc &row) const;
+    void WriteColumnar(const Schema &schema, std::string_view table, std::size_t row_num, const RowFunc &row) const;
+
+    std::string_view GetSymbolName(std::string_view name) const;
+
+    const ELFReader *m_elf_reader;
+    Format m_format;
+    FdWriter *m_writer;
+    std::string_view m_file_name;
+    const SymbolFilter *m_symbol_filter = nullptr;
+    Demangler *m_demangler = nullptr;
+};
@@ -0,0 +1,310 @@
+#include "SymbolIndex.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    struct Candidate
+    {
+        uint64_t start;
+        uint64_t size;
+        uint64_t section_end; // 所在段的结束地址
+        uint32_t symbol;
+        int rank; // 越小越优先
+    };
+
+    int BindRank(int bind)
+    {
+        switch (bind)
+        {
+            case STB_GLOBAL:
+                return 0;
+            case STB_WEAK:
+                return 1;
+            default:
+                return 2;
+        }
+    }
+
+    // 序列化格式的头部，其后依次为 entries、eytzinger、eytzinger_rank，均按 8 字节对齐
+    struct IndexHeader
+    {
+        char magic[8];
+        uint64_t entry_num;
+    };
+
+    const char INDEX_MAGIC[8] = { 'S', 'Y', 'M', 'I', 'D', 'X', '0', '2' };
+
+    std::size_t Align8(std::size_t n)
+    {
+        return (n + 7) & ~static_cast<std::size_t>(7);
+    }
+}
+
+void SymbolIndex::Build(const ELFReader &reader)
+{
+    std::vector<Candidate> candidates;
+
+    const TableView<ELFReader::Section> &sections = reader.GetSections();
+    auto collect = [&candidates, &sections](const TableView<ELFReader::Symbol> &symbols, bool is_dyn)
+    {
+        for (std::size_t i = 0; i < symbols.size(); i++)
+        {
+            const ELFReader::Symbol &symbol = symbols[i];
+            int type = symbol.get_sym_type();
+            // SHN_ABS 的符号（如 libstdc++ 的 CXXABI_1.3.11 版本标记）和值为 0 的符号不是代码或数据
+            if ((type != STT_FUNC && type != STT_OBJECT) || symbol.sym.st_shndx == SHN_UNDEF ||
+                symbol.sym.st_shndx == SHN_ABS || symbol.sym.st_value == 0)
+            {
+                continue;
+            }
+
+            Candidate candidate;
+            candidate.start = symbol.sym.st_value;
+            candidate.size = symbol.sym.st_size;
+            candidate.section_end = UINT64_MAX;
+            if (symbol.sym.st_shndx < sections.size())
+            {
+                const Elf64_Shdr &header = sections[symbol.sym.st_shndx].section_header;
+                if (header.sh_addr <= candidate.start && candidate.start < header.sh_addr + header.sh_size)
+                {
+                    candidate.section_end = header.sh_addr + header.sh_size;
+                }
+            }
+            candidate.symbol = static_cast<uint32_t>(i) | (is_dyn ? DYNSYM_FLAG : 0);
+            candidate.rank = BindRank(symbol.get_sym_bind()) * 2 + (is_dyn ? 1 : 0);
+            candidates.push_back(candidate);
+        }
+    };
+
+    m_reader = &reader;
+    collect(reader.GetSymbols(), false);
+    collect(reader.GetDynSyms(), true);
+
+    // 同一起始地址时大的（外层）在前，这样前驱查找先落到最内层
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b)
+    {
+        if (a.start != b.start) return a.start < b.start;
+        if (a.size != b.size) return a.size > b.size;
+        return a.rank < b.rank;
+    });
+
+    std::vector<Entry> &entries = m_entry_storage;
+    std::vector<uint64_t> section_ends;
+    entries.clear();
+    entries.reserve(candidates.size());
+    section_ends.reserve(candidates.size());
+    for (const Candidate &candidate : candidates)
+    {
+        // 别名：排序后首个即为最优先的名字
+        if (!entries.empty() && entries.back().start == candidate.start &&
+            entries.back().end - entries.back().start == candidate.size)
+        {
+            continue;
+        }
+
+        Entry entry;
+        entry.start = candidate.start;
+        entry.end = candidate.start + candidate.size;
+        entry.symbol = candidate.symbol;
+        entry.parent = NO_PARENT;
+        entries.push_back(entry);
+        section_ends.push_back(candidate.section_end);
+    }
+
+    // 大小为 0 的符号延伸到下一个起始地址更大的符号，但不越过所在段的末尾
+    for (std::size_t i = 0; i < entries.size(); i++)
+    {
+        Entry &entry = entries[i];
+        if (entry.end != entry.start)
+        {
+            continue;
+        }
+
+        std::size_t next = i + 1;
+        while (next < entries.size() && entries[next].start == entry.start)
+        {
+            next++;
+        }
+        uint64_t end = next < entries.size() ? entries[next].start : section_ends[i];
+        end = std::min(end, section_ends[i]);
+        entry.end = end != UINT64_MAX ? end : entry.start + 1;
+    }
+
+    // 用栈求每个符号的外层符号
+    std::vector<uint32_t> stack;
+    for (std::size_t i = 0; i < entries.size(); i++)
+    {
+        while (!stack.empty() && entries[stack.back()].end <= entries[i].start)
+        {
+            stack.pop_back();
+        }
+        entries[i].parent = stack.empty() ? NO_PARENT : stack.back();
+        stack.push_back(static_cast<uint32_t>(i));
+    }
+
+    m_entries = TableView<Entry>(entries.data(), entries.size());
+
+    m_eytzinger_storage.assign(entries.size() + 1, 0);
+    m_eytzinger_rank_storage.assign(entries.size() + 1, 0);
+    std::size_t sorted_i = 0;
+    this->BuildEytzinger(sorted_i, 1);
+
+    m_eytzinger = TableView<uint64_t>(m_eytzinger_storage.data(), m_eytzinger_storage.size());
+    m_eytzinger_rank = TableView<uint32_t>(m_eytzinger_rank_storage.data(), m_eytzinger_rank_storage.size());
+}
+
+void SymbolIndex::BuildEytzinger(std::size_t &sorted_i, std::size_t k)
+{
+    // 中序遍历隐式完全二叉树，依次填入排好序的起始地址
+    if (k < m_eytzinger_storage.size())
+    {
+        this->BuildEytzinger(sorted_i, 2 * k);
+        m_eytzinger_storage[k] = m_entry_storage[sorted_i].start;
+        m_eytzinger_rank_storage[k] = static_cast<uint32_t>(sorted_i);
+        sorted_i++;
+        this->BuildEytzinger(sorted_i, 2 * k + 1);
+    }
+}
+
+void SymbolIndex::Serialize(std::string &out) const
+{
+    out.resize(Align8(out.size()), '\0');
+
+    IndexHeader header;
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.entry_num = m_entries.size();
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    out.append(reinterpret_cast<const char*>(m_entries.data()), m_entries.size() * sizeof(Entry));
+    out.resize(Align8(out.size()), '\0');
+    out.append(reinterpret_cast<const char*>(m_eytzinger.data()), m_eytzinger.size() * sizeof(uint64_t));
+    out.append(reinterpret_cast<const char*>(m_eytzinger_rank.data()), m_eytzinger_rank.size() * sizeof(uint32_t));
+    out.resize(Align8(out.size()), '\0');
+}
+
+bool SymbolIndex::Attach(const ELFReader &reader, const char *data, std::size_t size)
+{
+    if (data == nullptr || reinterpret_cast<uintptr_t>(data) % alignof(uint64_t) != 0 || size < sizeof(IndexHeader))
+    {
+        return false;
+    }
+
+    IndexHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) != 0 || header.entry_num >= NO_PARENT)
+    {
+        return false;
+    }
+
+    const std::size_t n = header.entry_num;
+    const std::size_t entries_offset = sizeof(IndexHeader);
+    const std::size_t eytzinger_offset = Align8(entries_offset + n * sizeof(Entry));
+    const std::size_t rank_offset = eytzinger_offset + (n + 1) * sizeof(uint64_t);
+    if (rank_offset + (n + 1) * sizeof(uint32_t) > size)
+    {
+        return false;
+    }
+
+    m_reader = &reader;
+    m_entry_storage.clear();
+    m_eytzinger_storage.clear();
+    m_eytzinger_rank_storage.clear();
+    m_entries = TableView<Entry>(reinterpret_cast<const Entry*>(data + entries_offset), n);
+    m_eytzinger = TableView<uint64_t>(reinterpret_cast<const uint64_t*>(data + eytzinger_offset), n + 1);
+    m_eytzinger_rank = TableView<uint32_t>(reinterpret_cast<const uint32_t*>(data + rank_offset), n + 1);
+    return true;
+}
+
+std::size_t SymbolIndex::FindPredecessor(uint64_t addr) const
+{
+    const std::size_t n = m_entries.size();
+    const uint64_t *tree = m_eytzinger.data();
+
+    // 无分支下降，每步预取 4 层之后的节点（16 个 uint64_t 正好两条 cache line）
+    std::size_t k = 1;
+    while (k <= n)
+    {
+        __builtin_prefetch(tree + std::min(16 * k, n));
+        k = 2 * k + (tree[k] <= addr);
+    }
+
+    // 去掉末尾连续的 1 及其后一个 0，得到第一个大于 addr 的节点，0 表示不存在
+    k >>= __builtin_ffsl(~k);
+
+    std::size_t upper = (k == 0) ? n : m_eytzinger_rank[k];
+    return upper == 0 ? n : upper - 1;
+}
+
+const char *SymbolIndex::GetName(const Entry &entry) const
+{
+    uint32_t index = entry.symbol & ~DYNSYM_FLAG;
+    if (entry.symbol & DYNSYM_FLAG)
+    {
+        return m_reader->GetDynSyms().at(index).get_dynsym_name(*m_reader).data();
+    }
+    return m_reader->GetSymbols().at(index).get_sym_name(*m_reader).data();
+}
+
+SymbolIndex::Match SymbolIndex::LookupAddress(uint64_t addr) const
+{
+    std::size_t i = this->FindPredecessor(addr);
+    if (i >= m_entries.size())
+    {
+        return Match();
+    }
+    return this->Resolve(i, addr);
+}
+
+void SymbolIndex::LookupSorted(const uint64_t *addrs, std::size_t n, Match *matches) const
+{
+    const std::size_t entry_num = m_entries.size();
+    std::size_t next = 0; // 第一个起始地址 > 当前地址的符号
+
+    for (std::size_t k = 0; k < n; k++)
+    {
+        const uint64_t addr = addrs[k];
+
+        if (next < entry_num && m_entries[next].start <= addr)
+        {
+            // 先倍增跳过，再在最后一步的区间内二分，地址稀疏时不必逐个走过中间的符号
+            std::size_t step = 1;
+            std::size_t low = next;
+            while (next + step < entry_num && m_entries[next + step].start <= addr)
+            {
+                low = next + step;
+                step *= 2;
+            }
+            std::size_t high = std::min(next + step, entry_num);
+            next = std::upper_bound(m_entries.begin() + low, m_entries.begin() + high, addr,
+                [](uint64_t value, const Entry &entry) { return value < entry.start; }) - m_entries.begin();
+        }
+
+        matches[k] = next == 0 ? Match() : this->Resolve(next - 1, addr);
+    }
+}
+
+SymbolIndex::Match SymbolIndex::Resolve(std::size_t i, uint64_t addr) const
+{
+    Match match;
+
+    uint32_t cur = static_cast<uint32_t>(i);
+    while (cur != NO_PARENT && addr >= m_entries[cur].end)
+    {
+        // 外层符号下标总是更小，不满足说明数据已损坏
+        uint32_t parent = m_entries[cur].parent;
+        cur = parent < cur ? parent : NO_PARENT;
+    }
+    if (cur == NO_PARENT || cur >= m_entries.size())
+    {
+        return match;
+    }
+
+    const Entry &entry = m_entries[cur];
+    match.name = this->GetName(entry);
+    match.start = entry.start;
+    match.size = entry.end - entry.start;
+    match.offset = addr - entry.start;
+    return match;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ELFReader.h"
+
+// 地址 -> 符号的区间索引，用于快速符号化。
+// 收集 .symtab 与 .dynsym 中已定义的 STT_FUNC / STT_OBJECT 符号，按 st_value 排序，
+// 起始地址再按 Eytzinger（BFS 堆序）布局存放，查找时前几层总在同几条 cache line 里，且可预取。
+//
+// 区间规则：
+// - st_size > 0 时覆盖 [st_value, st_value + st_size)
+// - st_size == 0 时延伸到下一个符号的起始地址（汇编函数常不填大小），但不越过所在段的末尾
+// - 跳过 SHN_ABS 的符号（版本标记等）和值为 0 的符号
+// - 起始地址与大小相同的别名只保留一个，优先 GLOBAL > WEAK > LOCAL，同级优先 .symtab
+// - 允许区间嵌套，查找时返回包含该地址的最内层符号
+class SymbolIndex
+{
+public:
+    struct Match
+    {
+        const char *name = nullptr; // 指向 reader 的字符串表，reader 存活期间有效
+        uint64_t start = 0;
+        uint64_t size = 0;
+        uint64_t offset = 0; // addr - start
+
+        bool found() const { return name != nullptr; }
+    };
+
+    SymbolIndex() {}
+    SymbolIndex(const SymbolIndex&) = delete;
+    SymbolIndex &operator=(const SymbolIndex&) = delete;
+    SymbolIndex(SymbolIndex&&) = default;
+    SymbolIndex &operator=(SymbolIndex&&) = default;
+    explicit SymbolIndex(const ELFReader &reader) { this->Build(reader); }
+
+    void Build(const ELFReader &reader);
+
+    // 序列化为可直接映射使用的二进制形式（追加到 out），以 8 字节对齐
+    void Serialize(std::string &out) const;
+
+    // 在 data 上原地使用序列化后的索引，不做拷贝；data 与 reader 需在本对象使用期间有效，
+    // 且 reader 须与建立索引时是同一个文件
+    bool Attach(const ELFReader &reader, const char *data, std::size_t size);
+
+    Match LookupAddress(uint64_t addr) const;
+
+    // 批量查找：addrs 须按升序排列，与按起始地址排序的符号区间做一次归并（相距较远时倍增跳过），
+    // 代替逐个查找；结果写入 matches[0, n)
+    void LookupSorted(const uint64_t *addrs, std::size_t n, Match *matches) const;
+
+    std::size_t GetSymbolNum() const { return m_entries.size(); }
+
+private:
+    struct Entry
+    {
+        uint64_t start;
+        uint64_t end;       // 不含
+        uint32_t symbol;    // 符号下标，最高位为 1 表示在 .dynsym 中
+        uint32_t parent;    // 包含本符号的外层符号下标，没有时为 NO_PARENT
+    };
+
+    static const uint32_t NO_PARENT = 0xFFFFFFFFu;
+    static const uint32_t DYNSYM_FLAG = 0x80000000u;
+
+    void BuildEytzinger(std::size_t &sorted_i, std::size_t k);
+
+    // 返回起始地址 <= addr 的最后一个符号下标，没有时返回 m_entries.size()
+    std::size_t FindPredecessor(uint64_t addr) const;
+
+    // m_entries[i] 为起始地址 <= addr 的最后一个符号，沿外层符号找到包含 addr 的那个
+    Match Resolve(std::size_t i, uint64_t addr) const;
+
+    const char *GetName(const Entry &entry) const;
+
+private:
+    const ELFReader *m_reader = nullptr;
+    TableView<Entry> m_entries;             // 按 start 排序
+    TableView<uint64_t> m_eytzinger;        // 下标从 1 开始的 Eytzinger 布局起始地址
+    TableView<uint32_t> m_eytzinger_rank;   // m_eytzinger[k] 在 m_entries 中的下标
+
+    // Build 时自己持有数据，Attach 时为空
+    std::vector<Entry> m_entry_storage;
+    std::vector<uint64_t> m_eytzinger_storage;
+    std::vector<uint32_t> m_eytzinger_rank_storage;
+};
@@ -0,0 +1,304 @@
+#include "SymbolStore.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SYMBOL_STORE_X86 1
+#endif
+
+namespace
+{
+    using Columns = SymbolStore::Columns;
+    using Predicate = SymbolStore::Predicate;
+    using Kernel = void (*)(const Columns &columns, const Predicate &pred, std::vector<uint32_t> &indexes);
+
+    bool MatchOne(const Columns &columns, const Predicate &pred, std::size_t i)
+    {
+        return (columns.infos[i] & pred.info_mask) == pred.info_value &&
+            (!pred.check_shndx || columns.shndxs[i] == pred.shndx) &&
+            columns.sizes[i] >= pred.min_size;
+    }
+
+    void SelectScalar(const Columns &columns, const Predicate &pred, std::size_t begin, std::vector<uint32_t> &indexes)
+    {
+        for (std::size_t i = begin; i < columns.num; i++)
+        {
+            if (MatchOne(columns, pred, i))
+            {
+                indexes.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+
+    void SelectScalarKernel(const Columns &columns, const Predicate &pred, std::vector<uint32_t> &indexes)
+    {
+        SelectScalar(columns, pred, 0, indexes);
+    }
+
+    // 把块内掩码的置位下标追加到 indexes
+    inline void AppendMask(uint32_t mask, std::size_t base, std::vector<uint32_t> &indexes)
+    {
+        while (mask != 0)
+        {
+            indexes.push_back(static_cast<uint32_t>(base + __builtin_ctz(mask)));
+            mask &= mask - 1;
+        }
+    }
+
+#ifdef SYMBOL_STORE_X86
+    // 每块 32 个符号，各列比较结果压成 32 位掩码
+    __attribute__((target("avx2")))
+    void SelectAVX2(const Columns &columns, const Predicate &pred, std::vector<uint32_t> &indexes)
+    {
+        const __m256i info_mask = _mm256_set1_epi8(static_cast<char>(pred.info_mask));
+        const __m256i info_value = _mm256_set1_epi8(static_cast<char>(pred.info_value));
+        const __m256i shndx = _mm256_set1_epi16(static_cast<short>(pred.shndx));
+
+        // 无符号 64 位比较：两边翻转符号位后做有符号比较，size >= min 即 size > min - 1
+        const __m256i sign = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ull));
+        const __m256i size_bound = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(pred.min_size - 1)), sign);
+        const bool check_size = pred.min_size != 0;
+
+        std::size_t i = 0;
+        for (; i + 32 <= columns.num; i += 32)
+        {
+            __m256i infos = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns.infos + i));
+            uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(_mm256_and_si256(infos, info_mask), info_value)));
+
+            if (mask != 0 && pred.check_shndx)
+            {
+                __m256i lo = _mm256_cmpeq_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns.shndxs + i)), shndx);
+                __m256i hi = _mm256_cmpeq_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns.shndxs + i + 16)), shndx);
+                // packs 按 128 位分道交错，重排回原顺序
+                __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(lo, hi), 0xD8);
+                mask &= static_cast<uint32_t>(_mm256_movemask_epi8(packed));
+            }
+
+            if (mask != 0 && check_size)
+            {
+                uint32_t size_mask = 0;
+                for (int k = 0; k < 8; k++)
+                {
+                    __m256i sizes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns.sizes + i + k * 4));
+                    __m256i gt = _mm256_cmpgt_epi64(_mm256_xor_si256(sizes, sign), size_bound);
+                    size_mask |= static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(gt))) << (k * 4);
+                }
+                mask &= size_mask;
+            }
+
+            AppendMask(mask, i, indexes);
+        }
+
+        SelectScalar(columns, pred, i, indexes);
+    }
+
+    // 每块 16 个符号
+    __attribute__((target("sse4.2")))
+    void SelectSSE42(const Columns &columns, const Predicate &pred, std::vector<uint32_t> &indexes)
+    {
+        const __m128i info_mask = _mm_set1_epi8(static_cast<char>(pred.info_mask));
+        const __m128i info_value = _mm_set1_epi8(static_cast<char>(pred.info_value));
+        const __m128i shndx = _mm_set1_epi16(static_cast<short>(pred.shndx));
+
+        const __m128i sign = _mm_set1_epi64x(static_cast<long long>(0x8000000000000000ull));
+        const __m128i size_bound = _mm_xor_si128(_mm_set1_epi64x(static_cast<long long>(pred.min_size - 1)), sign);
+        const bool check_size = pred.min_size != 0;
+
+        std::size_t i = 0;
+        for (; i + 16 <= columns.num; i += 16)
+        {
+            __m128i infos = _mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.infos + i));
+            uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_and_si128(infos, info_mask), info_value)));
+
+            if (mask != 0 && pred.check_shndx)
+            {
+                __m128i lo = _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.shndxs + i)), shndx);
+                __m128i hi = _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.shndxs + i + 8)), shndx);
+                mask &= static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(lo, hi)));
+            }
+
+            if (mask != 0 && check_size)
+            {
+                uint32_t size_mask = 0;
+                for (int k = 0; k < 8; k++)
+                {
+                    __m128i sizes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.sizes + i + k * 2));
+                    __m128i gt = _mm_cmpgt_epi64(_mm_xor_si128(sizes, sign), size_bound);
+                    size_mask |= static_cast<uint32_t>(_mm_movemask_pd(_mm_castsi128_pd(gt))) << (k * 2);
+                }
+                mask &= size_mask;
+            }
+
+            AppendMask(mask, i, indexes);
+        }
+
+        SelectScalar(columns, pred, i, indexes);
+    }
+#endif
+
+    struct KernelChoice
+    {
+        Kernel kernel;
+        const char *name;
+    };
+
+    // 启动时选定一次；设置环境变量 ELFREADER_SIMD=scalar/sse4.2 可强制使用较低的实现
+    KernelChoice ChooseKernel()
+    {
+        const char *env = getenv("ELFREADER_SIMD");
+        std::string limit = env != nullptr ? env : "";
+        (void)limit;
+
+#ifdef SYMBOL_STORE_X86
+        __builtin_cpu_init();
+        if (limit != "scalar" && limit != "sse4.2" && __builtin_cpu_supports("avx2"))
+        {
+            return { SelectAVX2, "avx2" };
+        }
+        if (limit != "scalar" && __builtin_cpu_supports("sse4.2"))
+        {
+            return { SelectSSE42, "sse4.2" };
+        }
+#endif
+        return { SelectScalarKernel, "scalar" };
+    }
+
+    const KernelChoice &GetKernel()
+    {
+        static const KernelChoice choice = ChooseKernel();
+        return choice;
+    }
+
+    // 去掉可选前缀后按名字或数字解析
+    bool ParseEnum(const std::string &arg, const char *prefix, const std::initializer_list<std::pair<const char*, int>> &names, int &value)
+    {
+        std::string name = arg;
+        if (strncasecmp(name.c_str(), prefix, strlen(prefix)) == 0)
+        {
+            name = name.substr(strlen(prefix));
+        }
+
+        for (const auto &item : names)
+        {
+            if (strcasecmp(name.c_str(), item.first) == 0)
+            {
+                value = item.second;
+                return true;
+            }
+        }
+
+        char *end = nullptr;
+        long number = strtol(arg.c_str(), &end, 0);
+        if (arg.empty() || *end != '\0' || number < 0 || number > 15)
+        {
+            return false;
+        }
+        value = static_cast<int>(number);
+        return true;
+    }
+}
+
+bool SymbolFilter::ParseType(const std::string &arg, int &type)
+{
+    return ParseEnum(arg, "STT_", { { "NOTYPE", STT_NOTYPE }, { "OBJECT", STT_OBJECT }, { "FUNC", STT_FUNC },
+        { "SECTION", STT_SECTION }, { "FILE", STT_FILE }, { "COMMON", STT_COMMON }, { "TLS", STT_TLS },
+        { "GNU_IFUNC", STT_GNU_IFUNC } }, type);
+}
+
+bool SymbolFilter::ParseBind(const std::string &arg, int &bind)
+{
+    return ParseEnum(arg, "STB_", { { "LOCAL", STB_LOCAL }, { "GLOBAL", STB_GLOBAL }, { "WEAK", STB_WEAK },
+        { "GNU_UNIQUE", STB_GNU_UNIQUE } }, bind);
+}
+
+void SymbolStore::Build(const ELFReader &reader, bool is_dyn)
+{
+    const TableView<ELFReader::Symbol> &symbols = is_dyn ? reader.GetDynSyms() : reader.GetSymbols();
+
+    m_reader = &reader;
+    m_strs = is_dyn ? reader.GetDynamicStrs() : reader.GetSymbolStrs();
+
+    const std::size_t n = symbols.size();
+    m_values.resize(n);
+    m_sizes.resize(n);
+    m_shndxs.resize(n);
+    m_infos.resize(n);
+    m_names.resize(n);
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const Elf64_Sym &sym = symbols[i].sym;
+        m_values[i] = sym.st_value;
+        m_sizes[i] = sym.st_size;
+        m_shndxs[i] = sym.st_shndx;
+        m_infos[i] = sym.st_info;
+        m_names[i] = sym.st_name;
+    }
+}
+
+bool SymbolStore::ResolveSection(const std::string &name, uint16_t &shndx) const
+{
+    // 与打印时 Section 列的写法一致
+    if (name == "SHN_UNDEF") { shndx = SHN_UNDEF; return true; }
+    if (name == "SHN_ABS") { shndx = SHN_ABS; return true; }
+    if (name == "SHN_COMMON") { shndx = SHN_COMMON; return true; }
+
+    const TableView<ELFReader::Section> &sections = m_reader->GetSections();
+    for (std::size_t i = 0; i < sections.size(); i++)
+    {
+        if (sections[i].get_name(*m_reader) == name)
+        {
+            shndx = static_cast<uint16_t>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void SymbolStore::Select(const SymbolFilter &filter, std::vector<uint32_t> &indexes) const
+{
+    indexes.clear();
+    if (m_infos.empty())
+    {
+        return;
+    }
+
+    Predicate pred;
+    if (filter.type >= 0)
+    {
+        pred.info_mask |= 0x0f;
+        pred.info_value |= static_cast<uint8_t>(filter.type & 0x0f);
+    }
+    if (filter.bind >= 0)
+    {
+        pred.info_mask |= 0xf0;
+        pred.info_value |= static_cast<uint8_t>((filter.bind & 0x0f) << 4);
+    }
+    if (!filter.section.empty())
+    {
+        pred.check_shndx = true;
+        if (!this->ResolveSection(filter.section, pred.shndx))
+        {
+            return;
+        }
+    }
+    pred.min_size = filter.min_size;
+
+    Columns columns;
+    columns.sizes = m_sizes.data();
+    columns.shndxs = m_shndxs.data();
+    columns.infos = m_infos.data();
+    columns.num = m_infos.size();
+
+    GetKernel().kernel(columns, pred, indexes);
+}
+
+const char *SymbolStore::GetKernelName()
+{
+    return GetKernel().name;
+}
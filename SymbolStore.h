@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ELFReader.h"
+
+// 符号筛选条件，各项为默认值时表示不限
+struct SymbolFilter
+{
+    int type = -1;          // STT_*
+    int bind = -1;          // STB_*
+    std::string section;    // 段名，或 SHN_UNDEF / SHN_ABS / SHN_COMMON
+    uint64_t min_size = 0;  // st_size 下限（含）
+
+    bool empty() const { return type < 0 && bind < 0 && section.empty() && min_size == 0; }
+
+    // 解析命令行取值，如 FUNC / STT_FUNC / 2，GLOBAL / STB_GLOBAL / 1
+    static bool ParseType(const std::string &arg, int &type);
+    static bool ParseBind(const std::string &arg, int &bind);
+};
+
+// 列式（struct-of-arrays）符号表：st_value、st_size、st_shndx、st_info、st_name 各自连续存放。
+// 筛选时每个条件只扫描自己那一列，按块用 AVX2 / SSE4.2 比较得到位掩码再相与，
+// 运行时按 CPU 支持情况选择实现，非 x86 平台使用标量实现。
+class SymbolStore
+{
+public:
+    SymbolStore() {}
+    SymbolStore(const SymbolStore&) = delete;
+    SymbolStore &operator=(const SymbolStore&) = delete;
+    SymbolStore(SymbolStore&&) = default;
+    SymbolStore &operator=(SymbolStore&&) = default;
+
+    // 从 .symtab（is_dyn 为 false）或 .dynsym 建立，重复调用时复用已有容量
+    void Build(const ELFReader &reader, bool is_dyn);
+
+    // 满足 filter 的符号下标按升序写入 indexes
+    void Select(const SymbolFilter &filter, std::vector<uint32_t> &indexes) const;
+
+    std::size_t GetSymbolNum() const { return m_infos.size(); }
+
+    uint64_t GetValue(std::size_t i) const { return m_values[i]; }
+    uint64_t GetSize(std::size_t i) const { return m_sizes[i]; }
+    uint16_t GetSectionIndex(std::size_t i) const { return m_shndxs[i]; }
+    uint8_t GetInfo(std::size_t i) const { return m_infos[i]; }
+
+    // 按 st_name 取名字，STT_SECTION 符号一般为空串
+    std::string_view GetName(std::size_t i) const { return m_strs.view(m_names[i]); }
+
+    // 当前使用的筛选实现：avx2 / sse4.2 / scalar
+    static const char *GetKernelName();
+
+    // 筛选所用的各列，供各实现直接访问
+    struct Columns
+    {
+        const uint64_t *sizes;
+        const uint16_t *shndxs;
+        const uint8_t *infos;
+        std::size_t num;
+    };
+
+    // 解析后的条件：(st_info & info_mask) == info_value，st_shndx == shndx，st_size >= min_size
+    struct Predicate
+    {
+        uint8_t info_mask = 0;
+        uint8_t info_value = 0;
+        bool check_shndx = false;
+        uint16_t shndx = 0;
+        uint64_t min_size = 0;
+    };
+
+private:
+    // 段名解析为段下标，不存在时返回 false
+    bool ResolveSection(const std::string &name, uint16_t &shndx) const;
+
+private:
+    const ELFReader *m_reader = nullptr;
+    StrTable m_strs;
+
+    std::vector<uint64_t> m_values;
+    std::vector<uint64_t> m_sizes;
+    std::vector<uint16_t> m_shndxs;
+    std::vector<uint8_t> m_infos;
+    std::vector<uint32_t> m_names;
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <vector>
+
+// 固定大小的线程池，任务带上执行它的工作线程编号（0 ~ GetThreadNum()-1），
+// 调用方可据此为每个工作线程准备一份可复用的状态（如 ELFReader）
+class ThreadPool
+{
+public:
+    using Task = std::function<void(int worker_id)>;
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool &operator=(const ThreadPool&) = delete;
+
+    explicit ThreadPool(int thread_num)
+    {
+        if (thread_num < 1) thread_num = 1;
+
+        for (int i = 0; i < thread_num; i++)
+        {
+            m_threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_task_cv.notify_all();
+
+        for (std::thread &t : m_threads)
+        {
+            t.join();
+        }
+    }
+
+    // 默认线程数：CPU 核数
+    static int DefaultThreadNum()
+    {
+        unsigned n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : static_cast<int>(n);
+    }
+
+    int GetThreadNum() const
+    {
+        return static_cast<int>(m_threads.size());
+    }
+
+    void Submit(Task task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+            m_pending++;
+        }
+        m_task_cv.notify_one();
+    }
+
+    // 等待所有已提交的任务执行完
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle_cv.wait(lock, [this] { return m_pending == 0; });
+    }
+
+private:
+    void WorkerLoop(int worker_id)
+    {
+        for (;;)
+        {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_task_cv.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+                if (m_tasks.empty())
+                {
+                    return; // m_stop
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+
+            task(worker_id);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_pending--;
+                if (m_pending == 0)
+                {
+                    m_idle_cv.notify_all();
+                }
+            }
+        }
+    }
+
+private:
+    std::vector<std::thread> m_threads;
+    std::deque<Task> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_task_cv;
+    std::condition_variable m_idle_cv;
+    int m_pending = 0;
+    bool m_stop = false;
+};
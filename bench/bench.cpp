@@ -0,0 +1,523 @@
+// ELFReader 的基准测试：逐个计时各解析阶段、各打印函数以及端到端的 -a，
+// 输出 ns/op、bytes/s、每次操作的内存分配次数（只计被测部分）与各用例的峰值 RSS。
+//
+// 用法：elfbench [--save FILE] [--baseline FILE] [--threshold PCT] [--min-time MS] [name=path ...]
+//   --save      把本次结果写成基线文件（每行：用例名 ns/op allocs/op）
+//   --baseline  与基线比较，任一用例 ns/op 变慢或 allocs/op 增加超过阈值（默认 25%）时返回非 0
+//   name=path   输入文件，默认 small/medium/huge 三个系统文件
+//
+// 另外用同一个 ELFReader 把所有输入读两遍并加载全部表，第二遍有任何内存分配即返回非 0（读取器应复用第一遍申请的内存）；
+// 按名字查找每个已定义的动态符号，结果与符号表对不上时同样返回非 0
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+
+#include "ELFReader.h"
+#include "ELFPrinter.h"
+#include "SymbolIndex.h"
+#include "SymbolStore.h"
+#include "FdWriter.h"
+#include "StructuredPrinter.h"
+#include "formattedtable.hpp"
+
+// 替换全局 operator new 以统计分配次数
+static std::atomic<long> g_alloc_num(0);
+
+void *operator new(std::size_t size)
+{
+    g_alloc_num++;
+    void *p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    free(p);
+}
+
+struct BenchInput
+{
+    std::string name;
+    std::string path;
+    uint64_t size;
+};
+
+struct BenchResult
+{
+    std::string name;
+    double ns_per_op;
+    double bytes_per_sec;
+    double allocs_per_op;
+    long peak_rss_kb;
+};
+
+// 一次操作：返回本次计时的纳秒数，并把计时部分的内存分配次数累加到 alloc_num，函数内部自行决定哪部分计入
+using BenchOp = std::function<int64_t(long &alloc_num)>;
+
+static int64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 清零进程的峰值 RSS（VmHWM），内核不支持时返回 false，此时 PeakRssKb 得到的是整个进程的峰值
+static bool ResetPeakRss()
+{
+    int fd = open("/proc/self/clear_refs", O_WRONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool ok = write(fd, "5", 1) == 1;
+    close(fd);
+    return ok;
+}
+
+static long PeakRssKb()
+{
+    std::ifstream ifs("/proc/self/status");
+    std::string line;
+    while (std::getline(ifs, line))
+    {
+        if (line.compare(0, 6, "VmHWM:") == 0)
+        {
+            return atol(line.c_str() + 6);
+        }
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+static bool g_peak_rss_per_case = true; // 各用例前都能清零峰值 RSS
+
+// 先标定迭代次数使每轮不少于 min_time_ns，再跑 5 轮取中位数
+static BenchResult RunBench(const std::string &name, uint64_t bytes, int64_t min_time_ns, const BenchOp &op)
+{
+    // 按墙上时间标定（不计时的 setup 也算在内），避免 setup 远比被测部分慢时跑太久
+    if (!ResetPeakRss())
+    {
+        g_peak_rss_per_case = false;
+    }
+
+    long iterations = 1;
+    long unused_alloc_num = 0;
+    for (;;)
+    {
+        int64_t begin = NowNs();
+        for (long i = 0; i < iterations; i++) op(unused_alloc_num);
+        if (NowNs() - begin >= min_time_ns || iterations >= (1L << 24)) break;
+        iterations *= 2;
+    }
+
+    std::vector<double> samples;
+    long alloc_num = 0;
+    for (int round = 0; round < 5; round++)
+    {
+        int64_t total = 0;
+        for (long i = 0; i < iterations; i++) total += op(alloc_num);
+        samples.push_back(static_cast<double>(total) / iterations);
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    BenchResult result;
+    result.name = name;
+    result.ns_per_op = samples[samples.size() / 2];
+    result.bytes_per_sec = result.ns_per_op > 0 ? bytes * 1e9 / result.ns_per_op : 0;
+    result.allocs_per_op = static_cast<double>(alloc_num) / (iterations * 5);
+    result.peak_rss_kb = PeakRssKb();
+    return result;
+}
+
+// 计时 body 并统计其中的内存分配，setup 都不计
+static BenchOp Timed(const std::function<void()> &setup, const std::function<void()> &body)
+{
+    return [setup, body](long &alloc_num)
+    {
+        setup();
+        long alloc_begin = g_alloc_num;
+        int64_t begin = NowNs();
+        body();
+        int64_t ns = NowNs() - begin;
+        alloc_num += g_alloc_num - alloc_begin;
+        return ns;
+    };
+}
+
+// 用 FindDynamicSymbol 查找每个有名字的已定义动态符号，返回结果不对的个数：没找到、名字不同，
+// 或者存在非隐藏的同名版本却返回了隐藏版本
+static long CheckDynsymLookup(const ELFReader &reader, const char *path, const std::vector<uint32_t> &indexes)
+{
+    const TableView<ELFReader::Symbol> &dynsyms = reader.GetDynSyms();
+    const StrTable &dynstrs = reader.GetDynamicStrs();
+    long mismatch_num = 0;
+    for (uint32_t index : indexes)
+    {
+        std::string_view name = dynstrs.view(dynsyms[index].sym.st_name);
+        const ELFReader::Symbol *found = reader.FindDynamicSymbol(std::string(name).c_str());
+        bool ok = found != nullptr && dynstrs.view(found->sym.st_name) == name;
+        if (ok && !(reader.GetDynSymVersion(index) & ELFReader::VERSYM_HIDDEN))
+        {
+            ok = !(reader.GetDynSymVersion(found - dynsyms.data()) & ELFReader::VERSYM_HIDDEN);
+        }
+        if (!ok)
+        {
+            std::cerr << "elfbench: FindDynamicSymbol(\"" << name << "\") in " << path
+                << " returned " << (found == nullptr ? "nothing" : "a different symbol") << std::endl;
+            mismatch_num++;
+        }
+    }
+    return mismatch_num;
+}
+
+// 返回动态符号查找结果不对的个数，见 CheckDynsymLookup
+static long AddInputBenches(const BenchInput &input, int64_t min_time_ns, std::vector<BenchResult> &results)
+{
+    const std::string prefix = input.name + "/";
+    const char *path = input.path.c_str();
+    const uint64_t bytes = input.size;
+
+    ELFReader reader;
+    std::ostringstream oss;
+    ELFPrinter printer(&reader, oss);
+    auto open = [&reader, path]()
+    {
+        if (!reader.ReadELFFile(path)) exit(-1);
+    };
+    auto nothing = []() {};
+    auto clear_output = [&oss]() { oss.str(""); oss.clear(); };
+
+    // 解析阶段：每次重新打开文件，只计该阶段
+    results.push_back(RunBench(prefix + "parse/open", bytes, min_time_ns, Timed(nothing, open)));
+    results.push_back(RunBench(prefix + "parse/symtab", bytes, min_time_ns, Timed(open, [&reader]() { reader.GetSymbols(); })));
+    results.push_back(RunBench(prefix + "parse/dynsym", bytes, min_time_ns, Timed(open, [&reader]() { reader.GetDynSyms(); })));
+    results.push_back(RunBench(prefix + "parse/relocations", bytes, min_time_ns, Timed(open, [&reader]() { reader.GetRelocations(); })));
+    results.push_back(RunBench(prefix + "parse/dynamics", bytes, min_time_ns, Timed(open, [&reader]() { reader.GetDynamics(); })));
+    results.push_back(RunBench(prefix + "parse/all", bytes, min_time_ns, Timed(nothing, [&reader, &open]() { open(); reader.LoadAllTables(); })));
+    results.push_back(RunBench(prefix + "index/build", bytes, min_time_ns, Timed(nothing, [&reader]()
+    {
+        SymbolIndex index(reader);
+    })));
+
+    // 列式符号表上的筛选：全局函数且不小于 64 字节
+    reader.LoadAllTables();
+    SymbolStore store;
+    store.Build(reader, false);
+    SymbolFilter filter;
+    filter.type = STT_FUNC;
+    filter.bind = STB_GLOBAL;
+    filter.min_size = 64;
+    std::vector<uint32_t> selected;
+    results.push_back(RunBench(prefix + "query/select", bytes, min_time_ns, Timed(nothing, [&store, &filter, &selected]()
+    {
+        store.Select(filter, selected);
+    })));
+
+    // 按名字查找每个有名字的已定义动态符号（.gnu.hash/.hash），名字先拷出来，只计查找。
+    // 直接取字符串表，get_dynsym_name 对 IFUNC、TLS 等类型不返回名字
+    const TableView<ELFReader::Symbol> &dynsyms = reader.GetDynSyms();
+    const StrTable &dynstrs = reader.GetDynamicStrs();
+    std::vector<uint32_t> defined;
+    std::vector<std::string> names;
+    for (uint32_t index = 0; index < dynsyms.size(); index++)
+    {
+        const ELFReader::Symbol &symbol = dynsyms[index];
+        if (symbol.sym.st_shndx != SHN_UNDEF && symbol.sym.st_name != 0)
+        {
+            defined.push_back(index);
+            names.emplace_back(dynstrs.view(symbol.sym.st_name));
+        }
+    }
+    long lookup_mismatch_num = CheckDynsymLookup(reader, path, defined);
+    results.push_back(RunBench(prefix + "query/dynsym", bytes, min_time_ns, Timed(nothing, [&reader, &names]()
+    {
+        for (const std::string &name : names)
+        {
+            reader.FindDynamicSymbol(name.c_str());
+        }
+    })));
+
+    // 打印：表已加载，只计格式化与输出
+    results.push_back(RunBench(prefix + "print/sections", bytes, min_time_ns, Timed(clear_output, [&printer]() { printer.PrintSections(); })));
+    results.push_back(RunBench(prefix + "print/symbols", bytes, min_time_ns, Timed(clear_output, [&printer]() { printer.PrintSymbols(); })));
+    results.push_back(RunBench(prefix + "print/relocations", bytes, min_time_ns, Timed(clear_output, [&printer]() { printer.PrintRelocations(); })));
+    results.push_back(RunBench(prefix + "print/dynamics", bytes, min_time_ns, Timed(clear_output, [&printer]() { printer.PrintDynamics(); })));
+
+    // 结构化输出：全部表写入内存缓冲
+    FdWriter writer;
+    auto clear_writer = [&writer]() { writer.TakeBuffer(); };
+    for (StructuredPrinter::Format format : { StructuredPrinter::FORMAT_JSONL, StructuredPrinter::FORMAT_COLUMNAR })
+    {
+        StructuredPrinter structured(&reader, format, writer);
+        structured.SetFileName(input.path);
+        std::string name = format == StructuredPrinter::FORMAT_JSONL ? "jsonl" : "columnar";
+        results.push_back(RunBench(prefix + "format/" + name, bytes, min_time_ns, Timed(clear_writer, [&structured]() { structured.PrintAll(); })));
+    }
+
+    // 端到端 -a：打开 + 全部打印
+    results.push_back(RunBench(prefix + "e2e/-a", bytes, min_time_ns, Timed(clear_output, [&printer, &open]()
+    {
+        open();
+        printer.PrintAll();
+    })));
+    return lookup_mismatch_num;
+}
+
+// 用一个读取器依次读完所有输入两遍，第一遍让各块内存、容器容量长到最大，返回第二遍的分配次数；
+// 第二遍的耗时与每个文件的分配次数作为 reuse/reread 用例记入 results
+static long CheckReuse(const std::vector<BenchInput> &inputs, std::vector<BenchResult> &results)
+{
+    ELFReader reader;
+    auto read_all = [&reader, &inputs]()
+    {
+        for (const BenchInput &input : inputs)
+        {
+            if (!reader.ReadELFFile(input.path.c_str())) exit(-1);
+            reader.LoadAllTables();
+        }
+    };
+
+    read_all();
+
+    long alloc_begin = g_alloc_num;
+    int64_t begin = NowNs();
+    read_all();
+    int64_t ns = NowNs() - begin;
+    long alloc_num = g_alloc_num - alloc_begin;
+
+    uint64_t bytes = 0;
+    for (const BenchInput &input : inputs) bytes += input.size;
+
+    BenchResult result;
+    result.name = "reuse/reread";
+    result.ns_per_op = static_cast<double>(ns) / inputs.size();
+    result.bytes_per_sec = ns > 0 ? bytes * 1e9 / ns : 0;
+    result.allocs_per_op = static_cast<double>(alloc_num) / inputs.size();
+    result.peak_rss_kb = PeakRssKb();
+    results.push_back(result);
+    return alloc_num;
+}
+
+static std::string FormatNum(double value)
+{
+    char buffer[64] {};
+    snprintf(buffer, sizeof(buffer), "%.1f", value);
+    return buffer;
+}
+
+static std::string FormatRate(double bytes_per_sec)
+{
+    char buffer[64] {};
+    if (bytes_per_sec >= 1e9) snprintf(buffer, sizeof(buffer), "%.2f GB/s", bytes_per_sec / 1e9);
+    else if (bytes_per_sec >= 1e6) snprintf(buffer, sizeof(buffer), "%.2f MB/s", bytes_per_sec / 1e6);
+    else snprintf(buffer, sizeof(buffer), "%.2f KB/s", bytes_per_sec / 1e3);
+    return buffer;
+}
+
+struct BaselineItem
+{
+    double ns_per_op = 0;
+    double allocs_per_op = -1; // 旧基线没有这一列时为 -1，不比较
+};
+
+static bool LoadBaseline(const std::string &path, std::map<std::string, BaselineItem> &baseline)
+{
+    std::ifstream ifs(path);
+    if (!ifs)
+    {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(ifs, line))
+    {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream iss(line);
+        std::string name;
+        BaselineItem item;
+        if (iss >> name >> item.ns_per_op)
+        {
+            if (!(iss >> item.allocs_per_op))
+            {
+                item.allocs_per_op = -1;
+            }
+            baseline[name] = item;
+        }
+    }
+    return true;
+}
+
+static bool SaveBaseline(const std::string &path, const std::vector<BenchResult> &results)
+{
+    std::ofstream ofs(path);
+    if (!ofs)
+    {
+        return false;
+    }
+
+    ofs << "# name ns_per_op allocs_per_op bytes_per_sec peak_rss_kb\n";
+    for (const BenchResult &result : results)
+    {
+        ofs << result.name << " " << result.ns_per_op << " " << result.allocs_per_op << " "
+            << result.bytes_per_sec << " " << result.peak_rss_kb << "\n";
+    }
+    return static_cast<bool>(ofs);
+}
+
+static uint64_t FileSize(const std::string &path)
+{
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? st.st_size : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string save_path;
+    std::string baseline_path;
+    double threshold_pct = 25;
+    int64_t min_time_ns = 100 * 1000 * 1000;
+    std::vector<BenchInput> inputs;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--save" && i + 1 < argc) save_path = argv[++i];
+        else if (arg == "--baseline" && i + 1 < argc) baseline_path = argv[++i];
+        else if (arg == "--threshold" && i + 1 < argc) threshold_pct = atof(argv[++i]);
+        else if (arg == "--min-time" && i + 1 < argc) min_time_ns = atol(argv[++i]) * 1000 * 1000;
+        else if (arg.find('=') != std::string::npos)
+        {
+            BenchInput input;
+            input.name = arg.substr(0, arg.find('='));
+            input.path = arg.substr(arg.find('=') + 1);
+            inputs.push_back(input);
+        }
+        else
+        {
+            std::cerr << "usage: " << argv[0] << " [--save FILE] [--baseline FILE] [--threshold PCT] [--min-time MS] [name=path ...]" << std::endl;
+            return -1;
+        }
+    }
+
+    if (inputs.empty())
+    {
+        inputs.push_back({ "small", "/bin/true", 0 });
+        inputs.push_back({ "medium", "/usr/lib/x86_64-linux-gnu/libc.so.6", 0 });
+        inputs.push_back({ "huge", "/usr/lib/x86_64-linux-gnu/libstdc++.so.6", 0 });
+    }
+
+    std::vector<BenchResult> results;
+    std::vector<BenchInput> read_inputs;
+    long lookup_mismatch_num = 0;
+    for (BenchInput &input : inputs)
+    {
+        input.size = FileSize(input.path);
+        if (input.size == 0)
+        {
+            std::cerr << "elfbench: skip " << input.name << ", can not stat " << input.path << std::endl;
+            continue;
+        }
+        std::cerr << "elfbench: " << input.name << " = " << input.path << " (" << input.size << " bytes)" << std::endl;
+        lookup_mismatch_num += AddInputBenches(input, min_time_ns, results);
+        read_inputs.push_back(input);
+    }
+
+    long reuse_alloc_num = read_inputs.empty() ? 0 : CheckReuse(read_inputs, results);
+
+    std::map<std::string, BaselineItem> baseline;
+    bool has_baseline = !baseline_path.empty() && LoadBaseline(baseline_path, baseline);
+    if (!baseline_path.empty() && !has_baseline)
+    {
+        std::cerr << "elfbench: no baseline at " << baseline_path << ", run make bench-baseline first to enable the gate" << std::endl;
+    }
+
+    int regression_num = 0;
+    FormattedTable ftable;
+    ftable.SetFieldList({ "Case", "ns/op", "Throughput", "Allocs/op",
+        g_peak_rss_per_case ? "Case Peak RSS (KB)" : "Process Peak RSS (KB)", "vs Baseline" });
+    for (const BenchResult &result : results)
+    {
+        std::string delta;
+        auto it = baseline.find(result.name);
+        if (has_baseline && it != baseline.end() && it->second.ns_per_op > 0)
+        {
+            const BaselineItem &item = it->second;
+            double pct = (result.ns_per_op - item.ns_per_op) * 100 / item.ns_per_op;
+            delta = (pct >= 0 ? "+" : "") + FormatNum(pct) + "%";
+            bool regressed = pct > threshold_pct;
+
+            // 分配次数基本是确定的，超过阈值且至少多出半次才算退化（基线为 0 时多一次即失败）
+            if (item.allocs_per_op >= 0 &&
+                result.allocs_per_op > item.allocs_per_op * (1 + threshold_pct / 100) + 0.5)
+            {
+                delta += ", allocs " + FormatNum(item.allocs_per_op) + " -> " + FormatNum(result.allocs_per_op);
+                regressed = true;
+            }
+            if (regressed)
+            {
+                delta += " REGRESSION";
+                regression_num++;
+            }
+        }
+        ftable.AddRow(result.name, FormatNum(result.ns_per_op), FormatRate(result.bytes_per_sec),
+            FormatNum(result.allocs_per_op), result.peak_rss_kb, delta);
+    }
+    std::cout << ftable.GetFormattedTable() << std::endl;
+
+    if (!save_path.empty())
+    {
+        if (!SaveBaseline(save_path, results))
+        {
+            std::cerr << "elfbench: can not write " << save_path << std::endl;
+            return -1;
+        }
+        std::cerr << "elfbench: results saved to " << save_path << std::endl;
+    }
+
+    if (reuse_alloc_num > 0)
+    {
+        std::cerr << "elfbench: reading the inputs again with the same ELFReader made " << reuse_alloc_num
+            << " allocation(s), expected 0" << std::endl;
+        return 1;
+    }
+
+    if (lookup_mismatch_num > 0)
+    {
+        std::cerr << "elfbench: " << lookup_mismatch_num << " dynamic symbol lookup(s) returned a wrong result" << std::endl;
+        return 1;
+    }
+
+    if (regression_num > 0)
+    {
+        std::cerr << "elfbench: " << regression_num << " case(s) regressed more than " << threshold_pct << "% in ns/op or allocs/op" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -1,12 +1,14 @@
 #pragma once
 
-#include <set>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
-#include <cstdio>
 #include <sstream>
 #include <iostream>
 
+#include "NumberFormat.h"
+
 /*
     可打印的表，打印结果如：
 
@@ -28,24 +30,24 @@
     field: value
     ...
 
-    要求打印的类型已重载 std::ostream& operator<<(std::ostream &os, const T &v) 运算符
-    内置类型天然满足
+    大表用 Stream 输出：第一遍只量各列宽度，第二遍逐行写到输出流，内存占用与行数无关
+
+    整数、Hex、字符串直接写入表内的缓冲，不产生临时 std::string；
+    其余类型要求已重载 std::ostream& operator<<(std::ostream &os, const T &v) 运算符（如浮点数）
 */
 
 class FormattedTable
 {
 private:
-    using Row = std::vector<std::string>;
-
     struct Field
     {
         Field(const std::string &_name) :
             name(_name), hint_len(0)
         {
-            hint_len = static_cast<int>(name.length());
+            hint_len = name.length();
         }
         std::string name;
-        int hint_len;   // 字段长度，根据插入的值进行动态调整（取最长内容的长度）
+        std::size_t hint_len;   // 字段长度，根据插入的值进行动态调整（取最长内容的长度）
     };
 
 public:
@@ -55,7 +57,10 @@ public:
     void SetFieldList(const std::initializer_list<std::string> &field_list)
     {
         m_field_list.clear();
-        m_row_list.clear();
+        this->ClearCells();
+        m_row_num = 0;
+        m_mode = MODE_BUFFER;
+        m_os = nullptr;
 
         for (const auto &field : field_list)
         {
@@ -67,62 +72,108 @@ public:
     template <typename... Args>
     void AddRow(const Args& ... rest)
     {
-        m_row_list.resize(m_row_list.size() + 1);
-        Row &row = m_row_list.back();
-        this->DoAddRow(row, rest...);
+        this->BeginRow();
+        (this->AddCell(rest), ...);
+    }
+
+    // 逐个单元格添加一行：BeginRow 后依次 AddCell
+    void BeginRow()
+    {
+        if (m_mode != MODE_BUFFER)
+        {
+            // 流式模式下只保留当前行
+            this->FlushRow();
+            this->ClearCells();
+        }
+        m_row_begin.push_back(m_cell_end.size());
+        m_row_num++;
+    }
+
+    template <typename T>
+    void AddCell(const T &value)
+    {
+        if (m_cell_end.size() - m_row_begin.back() >= m_field_list.size())
+        {
+            return;
+        }
+
+        std::size_t begin = m_cells.size();
+        this->AppendValue(value);
+
+        Field &field = m_field_list[m_cell_end.size() - m_row_begin.back()];
+        if (m_cells.size() - begin > field.hint_len)
+        {
+            field.hint_len = m_cells.size() - begin;
+        }
+        m_cell_end.push_back(m_cells.size());
     }
 
     int GetRowNum() const
     {
-        return static_cast<int>(m_row_list.size());
+        return static_cast<int>(m_row_num);
     }
 
     // 得到格式化的表格
     std::string GetFormattedTable()
     {
         this->MakeBar();
-        this->MakeBarFrame();
 
         std::string table;
+        table.reserve((m_row_begin.size() + 4) * (m_bar.size() + 1));
 
-        table += m_bar_frame;
-        table += '\n';
-        table += m_bar;
-        table += '\n';
-        table += m_bar_frame;
-        table += '\n';
-        for (const auto &row : m_row_list)
+        this->AppendHead(table);
+        for (std::size_t row = 0; row < m_row_begin.size(); row++)
         {
-            table += '|';
-            for (std::size_t i = 0; i < m_field_list.size(); i++)
-            {
-                if (i < row.size())
-                {
-                    table += this->FixValue(row[i], m_field_list[i].hint_len);
-                }
-                
-                table += '|';
-            }
-            table += '\n';
+            this->AppendRow(table, row);
         }
         table += m_bar_frame;
 
         return table;
     }
 
+    // 流式输出格式化的表格，结果与 GetFormattedTable 相同。
+    // add_rows 负责 AddRow 所有记录，会被调用两次：第一次只量列宽，第二次每行写完即输出到 os
+    template <typename F>
+    void Stream(std::ostream &os, const F &add_rows)
+    {
+        m_mode = MODE_MEASURE;
+        add_rows();
+        this->ClearCells();
+
+        this->MakeBar();
+        m_line.clear();
+        this->AppendHead(m_line);
+        os.write(m_line.data(), m_line.size());
+
+        m_mode = MODE_STREAM;
+        m_os = &os;
+        m_row_num = 0;
+        add_rows();
+        this->FlushRow();
+        os.write(m_bar_frame.data(), m_bar_frame.size());
+
+        m_mode = MODE_BUFFER;
+        m_os = nullptr;
+        this->ClearCells();
+    }
+
     // 得到listed表格
     std::string GetListedTable()
     {
         std::string table;
 
-        for (std::size_t row = 0; row < m_row_list.size(); row++)
+        for (std::size_t row = 0; row < m_row_begin.size(); row++)
         {
-            table += ("*************************** " + std::to_string(row + 1) + ". row ***************************\n");
-            
-            for (std::size_t i = 0; i < m_field_list.size() && i < m_row_list[row].size(); i++)
+            table += "*************************** ";
+            AppendValue(table, row + 1);
+            table += ". row ***************************\n";
+
+            std::size_t cell_num = this->GetCellNum(row);
+            for (std::size_t i = 0; i < m_field_list.size() && i < cell_num; i++)
             {
-                table += (m_field_list[i].name + ": ");
-                table += m_row_list[row][i];
+                table += m_field_list[i].name;
+                table += ": ";
+                table += this->GetCell(m_row_begin[row] + i);
                 table += '\n';
             }
         }
@@ -133,123 +184,150 @@ public:
 private:
     // IMPLS
 
-    template <typename T>
-    void DoAddRowHelper(Row &raw, const T &t)
+    enum Mode
     {
-        auto add_index = raw.size();
-        if (add_index < m_field_list.size())
-        {
-            std::string value = ToString(t);
-            int value_len = static_cast<int>(value.length());
-            if (value_len > m_field_list[add_index].hint_len)
-            {
-                m_field_list[add_index].hint_len = value_len;
-            }
-            raw.emplace_back(value);
-        }
+        MODE_BUFFER,    // 保存所有行，由 GetFormattedTable/GetListedTable 输出
+        MODE_MEASURE,   // Stream 第一遍：只更新列宽
+        MODE_STREAM,    // Stream 第二遍：每行写完即输出
+    };
+
+    void ClearCells()
+    {
+        m_cells.clear();
+        m_cell_end.clear();
+        m_row_begin.clear();
     }
 
-    template <typename T>
-    void DoAddRow(Row &raw, const T &t)
+    // 流式模式下输出缓冲中的当前行
+    void FlushRow()
     {
-        this->DoAddRowHelper(raw, t);
+        if (m_mode == MODE_STREAM && !m_row_begin.empty())
+        {
+            m_line.clear();
+            this->AppendRow(m_line, 0);
+            m_os->write(m_line.data(), m_line.size());
+        }
     }
 
-    template <typename T, typename... Args>
-    void DoAddRow(Row &raw, const T &t, const Args& ... rest)
+    // 表框、表头、表框
+    void AppendHead(std::string &out) const
     {
-        this->DoAddRowHelper(raw, t);
-        DoAddRow(raw, rest...);
+        out += m_bar_frame;
+        out += '\n';
+        out += m_bar;
+        out += '\n';
+        out += m_bar_frame;
+        out += '\n';
     }
 
-    void MakeBar()
+    void AppendRow(std::string &out, std::size_t row) const
     {
-        m_bar_plus_index.clear();
-        m_bar = "|";
-        m_bar_plus_index.insert(0);
+        std::size_t cell_num = this->GetCellNum(row);
 
+        out += '|';
         for (std::size_t i = 0; i < m_field_list.size(); i++)
         {
-            const auto &field = m_field_list[i];
-
-            m_bar += this->FixValue(field.name, field.hint_len);
+            if (i < cell_num)
+            {
+                AppendFixed(out, this->GetCell(m_row_begin[row] + i), m_field_list[i].hint_len);
+            }
 
-            m_bar_plus_index.insert(m_bar.size());
-            m_bar += '|';
+            out += '|';
         }
+        out += '\n';
     }
 
-    void MakeBarFrame()
+    std::size_t GetCellNum(std::size_t row) const
     {
-        m_bar_frame = "";
-
-        for (std::size_t i = 0; i < m_bar.length(); i++)
-        {
-            if (m_bar_plus_index.find(i) != m_bar_plus_index.end())
-            {
-                m_bar_frame += '+';
-            }
-            else
-            {
-                m_bar_frame += '-';
-            }
-        }
+        std::size_t end = row + 1 < m_row_begin.size() ? m_row_begin[row + 1] : m_cell_end.size();
+        return end - m_row_begin[row];
     }
 
-    template<typename T>
-    static std::string ToString(T &val)
+    std::string_view GetCell(std::size_t cell) const
     {
-        std::ostringstream oss;
-        if (oss << val) {
-            return oss.str();
-        }
-        return "";
+        std::size_t begin = cell == 0 ? 0 : m_cell_end[cell - 1];
+        return std::string_view(m_cells).substr(begin, m_cell_end[cell] - begin);
     }
 
-    static bool IsAsc(char c)
+    template <typename T>
+    void AppendValue(const T &value)
     {
-        return (c & (1 << 8)) == 0;
+        AppendValue(m_cells, value);
     }
 
-    static int GetMBCount(const char *value, int len)
+    template <typename T>
+    static void AppendValue(std::string &out, const T &value)
     {
-        // 获得 value 的多字节字符个数（认为多字节字符占据3个字节）
-        const char *p = value;
-        int count = 0;
-        while (p < value + len)
+        // char 类按字符输出，bool 按 0/1 输出，与 operator<< 一致，走下面的通用分支
+        constexpr bool is_number = std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+            !std::is_same_v<T, char> && !std::is_same_v<T, signed char> && !std::is_same_v<T, unsigned char>;
+
+        char buffer[NUMBER_MAX_LEN];
+        if constexpr (std::is_same_v<T, Hex>)
         {
-            if (!IsAsc(*p))
-            {
-                p += 3;
-                count++;
-            }
-            else
+            out.append(buffer, NumberFormat::FormatHex(buffer, value.value));
+        }
+        else if constexpr (is_number && std::is_signed_v<T>)
+        {
+            out.append(buffer, NumberFormat::FormatInt(buffer, value));
+        }
+        else if constexpr (is_number)
+        {
+            out.append(buffer, NumberFormat::FormatUInt(buffer, value));
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        {
+            out += std::string_view(value);
+        }
+        else
+        {
+            std::ostringstream oss;
+            if (oss << value)
             {
-                p++;
+                out += oss.str();
             }
         }
-        return count;
     }
 
-    static std::string FixValue(const std::string &value, int hint_len)
+    // 追加 " value " 并用空格补齐到 hint_len
+    static void AppendFixed(std::string &out, std::string_view value, std::size_t hint_len)
     {
-        char buffer[1024] {};   // 不可能一个字段有这么长的
+        out += ' ';
+        out += value;
+        if (hint_len > value.length())
+        {
+            out.append(hint_len - value.length(), ' ');
+        }
+        out += ' ';
+    }
 
-        int more_len = hint_len - static_cast<int>(value.length());
+    // 表头与表框一起生成：表框在每个 | 的位置为 +，其余为 -
+    void MakeBar()
+    {
+        m_bar = "|";
+        m_bar_frame = "+";
 
-        int mb_count = GetMBCount(value.c_str(), static_cast<int>(value.length()));
-        more_len += mb_count; // trick, 目的是中英文对齐（且要求中文是3字节字符编码（UTF-8满足），先这样）
+        for (std::size_t i = 0; i < m_field_list.size(); i++)
+        {
+            const auto &field = m_field_list[i];
+
+            AppendFixed(m_bar, field.name, field.hint_len);
+            m_bar += '|';
 
-        if (more_len < 0) more_len = 0;
-        std::string v = value + std::string(more_len, ' ');
-        snprintf(buffer, sizeof(buffer), " %-s ", v.c_str());
-        return buffer;
+            m_bar_frame.append(m_bar.size() - m_bar_frame.size() - 1, '-');
+            m_bar_frame += '+';
+        }
     }
 
 private:
     std::vector<Field> m_field_list;                        // 字段列表
     std::string m_bar;                                      // 表头
-    std::set<int> m_bar_plus_index;                         // 表框+号所在下标
     std::string m_bar_frame;                                // 表框
-    std::vector<Row> m_row_list;                            // 所有记录
+    std::string m_cells;                                    // 所有单元格内容，首尾相接
+    std::vector<std::size_t> m_cell_end;                    // 每个单元格在 m_cells 中的结束位置
+    std::vector<std::size_t> m_row_begin;                   // 每行第一个单元格在 m_cell_end 中的下标
+    std::size_t m_row_num = 0;                              // 已添加的行数（流式模式下不保留各行）
+    Mode m_mode = MODE_BUFFER;
+    std::ostream *m_os = nullptr;                           // 流式输出的目标
+    std::string m_line;                                     // 流式输出时复用的行缓冲
 };
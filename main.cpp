@@ -1,8 +1,37 @@
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <tuple>
+#include <map>
+
+#include <fcntl.h>
+#include <unistd.h>
 
 #include "ELFReader.h"
 #include "ELFPrinter.h"
+#include "ThreadPool.h"
+#include "ELFCrawler.h"
+#include "ELFCache.h"
+#include "SymbolIndex.h"
+#include "SymbolStore.h"
+#include "Demangler.h"
+#include "FdWriter.h"
+#include "StructuredPrinter.h"
+#include "AsyncLoader.h"
+#include "ProcessSymbolizer.h"
+#include "BatchSymbolizer.h"
+#include "LineIndex.h"
+#include "DependencyResolver.h"
+#include "ELFDiff.h"
+#include "NumberFormat.h"
+#include "formattedtable.hpp"
 
 static bool read_elf(const char *elf_file, ELFReader &elf_reader)
 {
@@ -12,54 +41,101 @@ static bool read_elf(const char *elf_file, ELFReader &elf_reader)
         return false;
     }
 
-    FILE *fp = fopen(elf_file, "r");
-    if (fp == nullptr)
-    {
-        perror("read_elf fopen");
-        return false;
-    }
-
-    if (!elf_reader.ReadELFFile(fp))
-    {
-        fclose(fp);
-        return false;
-    }
-
-    fclose(fp);
-    
-    return true;
+    // 按路径 mmap 读取，符号、重定位等表直接在映射内存上访问
+    return elf_reader.ReadELFFile(elf_file);
 }
 
 static void print_help(char *argv[])
 {
-    std::cerr << "usage: " << argv[0] << " <option> <elf_file>" << std::endl;
+    std::cerr << "usage: " << argv[0] << " [-j N] [--cache-dir DIR] <option> <elf_file|@listfile> ..." << std::endl;
     std::cerr << "options:" << std::endl;
     std::cerr << "\t-a : all info" << std::endl;
     std::cerr << "\t-S : section info" << std::endl;
     std::cerr << "\t-s : symbol info" << std::endl;
     std::cerr << "\t-r : relocation info" << std::endl;
     std::cerr << "\t-d : dynamic info" << std::endl;
+    std::cerr << "\t-A <addr>[,<addr>...] : look up the function/object symbol containing each address" << std::endl;
+    std::cerr << "\t-H : .gnu.hash/.hash bucket occupancy and chain length distribution" << std::endl;
+    std::cerr << "\t--startup : dynamic-linking startup cost: relocations by kind, symbolic relocations that could be relative,"
+        " exported symbols, BIND_NOW/DT_FLAGS, constructors and an estimated cost score" << std::endl;
+    std::cerr << "\t--format=jsonl|csv|columnar : with -S/-s/-r/-d/-a, write machine-readable rows instead of tables"
+        " (csv takes one of -S/-s/-r/-d)" << std::endl;
+    std::cerr << "\t-C : with -s/-r/-A/-a, demangle C++ symbol names" << std::endl;
+    std::cerr << "\t--type T, --bind B, --section S, --min-size N : with -s/-a, only print symbols of type T (e.g. FUNC),"
+        " bind B (e.g. GLOBAL), in section S (e.g. .text) and at least N bytes large" << std::endl;
+    std::cerr << "\t--crawl : recursively find elf files under the given directories and classify them" << std::endl;
+    std::cerr << "\t-j N : parse files with N worker threads (default: core count)" << std::endl;
+    std::cerr << "\t--cache-dir DIR : keep parsed tables and indexes in DIR and reuse them on later runs" << std::endl;
+    std::cerr << "\t--async-io : read the tables of many files at once with io_uring (a pread thread pool when io_uring"
+        " is unavailable or ELFREADER_IO=pread), overlapping reads with parsing; ignored with --cache-dir" << std::endl;
+    std::cerr << "\t--pid PID [-A <addr>[,<addr>...]] : symbolize absolute addresses of a running process as module!symbol+offset;"
+        " without -A, addresses are read from stdin and every hex word inside a file mapping is replaced, punctuation around it is kept" << std::endl;
+    std::cerr << "\t--addr2sym [--input FILE] <elf_file> : symbolize one hex address per line from stdin (or FILE) in chunks,"
+        " writing \"addr symbol+offset\" lines in input order and the throughput on stderr" << std::endl;
+    std::cerr << "\t--deps [--graph=dot|json] : resolve the transitive DT_NEEDED dependencies of each file like ld.so"
+        " (RPATH, LD_LIBRARY_PATH, RUNPATH, ld.so.conf, default dirs) and print the load order, or the graph in DOT/JSON" << std::endl;
+    std::cerr << "\t--diff [--top N] <old_elf> <new_elf> : compare sections, symbols, relocation counts per type and"
+        " dynamic entries, listing the N (default 20) largest size increases first" << std::endl;
+    std::cerr << "\t@listfile : read elf file paths from listfile, one per line" << std::endl;
 }
 
-int main(int argc, char *argv[])
+// 命令行参数
+struct Options
 {
-    if (argc != 3)
-    {
-        print_help(argv);
-        exit(-1);
-    }
-    
-    const char *elf_file = argv[2];
+    std::string opt;                // 输出选项，如 -a -S
+    int jobs = ThreadPool::DefaultThreadNum();
+    std::vector<std::string> files;
+    std::vector<uint64_t> addrs;    // -A 要查询的地址
+    std::string cache_dir;          // --cache-dir，为空时不使用缓存
+    SymbolFilter symbol_filter;     // --type --bind --section --min-size
+    bool demangle = false;          // -C
+    bool async_io = false;          // --async-io
+    int pid = 0;                    // --pid，不为 0 时符号化该进程的地址
+    std::string input;              // --addr2sym 的输入文件，为空时读标准输入
+    std::string graph;              // --deps 的 --graph，为空时输出装载顺序
+    size_t top = 20;                // --diff 的 --top，段与符号各列出的条数
+    bool structured = false;        // 指定了 --format
+    StructuredPrinter::Format format = StructuredPrinter::FORMAT_JSONL;
+};
 
-    ELFReader elf_reader;
-    if (!read_elf(elf_file, elf_reader))
+static bool is_print_option(const std::string &opt)
+{
+    return opt == "-a" || opt == "-S" || opt == "-s" || opt == "-r" || opt == "-d" || opt == "-A" || opt == "-H" ||
+        opt == "--startup";
+}
+
+// 解析逗号分隔的地址列表，支持 0x 前缀
+static bool parse_addrs(const char *arg, std::vector<uint64_t> &addrs)
+{
+    std::istringstream iss(arg);
+    std::string item;
+    while (std::getline(iss, item, ','))
     {
-        exit(-1);
+        char *end = nullptr;
+        uint64_t addr = strtoull(item.c_str(), &end, 0);
+        if (item.empty() || *end != '\0')
+        {
+            std::cerr << "parse_addrs: invalid address " << item << std::endl;
+            return false;
+        }
+        addrs.push_back(addr);
     }
+    return !addrs.empty();
+}
 
-    ELFPrinter elf_printer(&elf_reader);
+static void print_structured(const StructuredPrinter &printer, const Options &options)
+{
+    const std::string &opt = options.opt;
+    if (opt == "-a") printer.PrintAll();
+    else if (opt == "-S") printer.PrintSections();
+    else if (opt == "-s") printer.PrintSymbols();
+    else if (opt == "-r") printer.PrintRelocations();
+    else if (opt == "-d") printer.PrintDynamics();
+}
 
-    std::string opt = argv[1];
+static void print_elf(const ELFPrinter &elf_printer, const Options &options)
+{
+    const std::string &opt = options.opt;
     if (opt == "-a")
     {
         elf_printer.PrintAll();
@@ -80,9 +156,710 @@ int main(int argc, char *argv[])
     {
         elf_printer.PrintDynamics();
     }
+    else if (opt == "-A")
+    {
+        elf_printer.PrintAddresses(options.addrs);
+    }
+    else if (opt == "-H")
+    {
+        elf_printer.PrintHashTables();
+    }
+    else if (opt == "--startup")
+    {
+        elf_printer.PrintStartupCost();
+    }
+}
+
+// 收集文件参数，@listfile 展开为其中的每一行
+static bool collect_files(const std::string &arg, std::vector<std::string> &files)
+{
+    if (arg.size() < 2 || arg[0] != '@')
+    {
+        files.push_back(arg);
+        return true;
+    }
+
+    std::ifstream ifs(arg.substr(1));
+    if (!ifs)
+    {
+        std::cerr << "collect_files: can not open list file " << arg.substr(1) << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(ifs, line))
+    {
+        if (!line.empty())
+        {
+            files.push_back(line);
+        }
+    }
+    return true;
+}
+
+// 每个工作线程复用的状态
+struct BatchWorker
+{
+    ELFReader reader;
+    SymbolIndex symbol_index;
+    std::ostringstream oss;
+    ELFPrinter printer { &reader, oss };
+    std::unique_ptr<Demangler> demangler;   // -C 时才有
+    FdWriter writer;                        // --format 时的输出缓冲
+};
+
+struct BatchResult
+{
+    bool done = false;
+    bool ok = false;
+    std::string output;
+};
+
+// 在线程池上并行解析、打印所有文件，按输入顺序输出，返回失败的文件数
+static int run_batch(const Options &options)
+{
+    const std::vector<std::string> &files = options.files;
+    int jobs = options.jobs;
+    if (jobs > static_cast<int>(files.size())) jobs = static_cast<int>(files.size());
+
+    ThreadPool pool(jobs);
+
+    std::vector<std::unique_ptr<BatchWorker>> workers;
+    for (int i = 0; i < pool.GetThreadNum(); i++)
+    {
+        workers.emplace_back(new BatchWorker);
+        workers.back()->printer.SetSymbolFilter(options.symbol_filter.empty() ? nullptr : &options.symbol_filter);
+        if (options.demangle)
+        {
+            // 多文件时已按文件并行，单个文件时才在文件内并行解码
+            workers.back()->demangler.reset(new Demangler(files.size() == 1 ? options.jobs : 1));
+            workers.back()->printer.SetDemangler(workers.back()->demangler.get());
+        }
+    }
+
+    std::unique_ptr<ELFCache> cache;
+    if (!options.cache_dir.empty())
+    {
+        cache.reset(new ELFCache(options.cache_dir));
+    }
+    const bool need_index = options.opt == "-A";
+
+    const bool print_file_name = files.size() > 1 && !options.structured;
+
+    // --format 时绕过 iostream 直接写 fd；只有一个工作线程时各行直接流式写出，否则先写到工作线程自己的缓冲
+    FdWriter out(STDOUT_FILENO);
+    const bool stream_directly = pool.GetThreadNum() == 1;
+    if (stream_directly)
+    {
+        workers[0]->printer.SetOutput(std::cout);
+    }
+    if (options.structured && options.format == StructuredPrinter::FORMAT_CSV)
+    {
+        StructuredPrinter::WriteCsvHeader(options.opt, out);
+    }
+    std::vector<BatchResult> results(files.size());
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    // image 非空时为 AsyncLoader 读好的数据，否则（或没读成时）在这里同步读取
+    auto task = [&](size_t index, int worker_id, const AsyncLoader::Image *image)
+    {
+        BatchWorker &worker = *workers[worker_id];
+        worker.oss.str("");
+        worker.oss.clear();
+        if (worker.demangler)
+        {
+            worker.demangler->Clear(); // 缓存的键指向上一个文件的映像
+        }
+
+        bool ok = false;
+        try
+        {
+            if (cache)
+            {
+                ok = cache->Open(files[index].c_str(), worker.reader, need_index ? &worker.symbol_index : nullptr);
+                worker.printer.SetSymbolIndex(need_index ? &worker.symbol_index : nullptr);
+            }
+            else if (image != nullptr && image->data != nullptr)
+            {
+                ok = worker.reader.ReadELFBuffer(image->data, image->size, image->holder);
+            }
+            else
+            {
+                ok = read_elf(files[index].c_str(), worker.reader);
+            }
+
+            if (ok && options.structured)
+            {
+                StructuredPrinter printer(&worker.reader, options.format, stream_directly ? out : worker.writer);
+                printer.SetFileName(files[index]);
+                printer.SetSymbolFilter(options.symbol_filter.empty() ? nullptr : &options.symbol_filter);
+                printer.SetDemangler(worker.demangler.get());
+                print_structured(printer, options);
+            }
+            else if (ok)
+            {
+                if (print_file_name)
+                {
+                    (stream_directly ? std::cout : worker.oss) << "File: " << files[index] << "\n";
+                }
+                print_elf(worker.printer, options);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            ok = false;
+            std::cerr << "run_batch: " << files[index] << ": " << e.what() << std::endl;
+        }
+
+        if (stream_directly)
+        {
+            // 只有一个工作线程时由它独占 out 与 std::cout，每个文件结束时自己刷出，主线程不再写这两者
+            out.Flush();
+            std::cout.flush();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        results[index].ok = ok;
+        results[index].output = options.structured ? worker.writer.TakeBuffer() : worker.oss.str();
+        results[index].done = true;
+        cv.notify_all();
+    };
+
+    // --async-io 时先由 AsyncLoader 读入，读完一个文件就交给线程池解析
+    std::unique_ptr<AsyncLoader> loader;
+    if (options.async_io && !cache)
+    {
+        // -A 输出源码行，要把 DWARF 行号相关的段也读进来
+        loader.reset(new AsyncLoader([&pool, &task](AsyncLoader::Image &image)
+        {
+            pool.Submit([&task, image](int worker_id) { task(image.index, worker_id, &image); });
+        }, options.opt == "-A"));
+    }
+
+    // 输出必须按输入顺序，只让有限个文件处于“已提交未输出”状态，避免结果堆积在内存里；
+    // 异步读取时放宽窗口，让更多文件的读请求同时在途
+    size_t window = static_cast<size_t>(pool.GetThreadNum()) * 4;
+    if (loader && window < 64)
+    {
+        window = 64;
+    }
+    size_t next_submit = 0;
+    int failed_num = 0;
+
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        while (next_submit < files.size() && next_submit < i + window)
+        {
+            size_t index = next_submit++;
+            if (loader)
+            {
+                loader->Submit(index, files[index]);
+            }
+            else
+            {
+                pool.Submit([&task, index](int worker_id) { task(index, worker_id, nullptr); });
+            }
+        }
+
+        BatchResult result;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&results, i] { return results[i].done; });
+            result = std::move(results[i]);
+        }
+
+        // 直接流式写出时输出已由工作线程写完，这里只报错
+        if (result.ok && !stream_directly)
+        {
+            if (options.structured)
+            {
+                out.Write(result.output);
+            }
+            else
+            {
+                std::cout << result.output;
+            }
+        }
+        else if (!result.ok)
+        {
+            if (!stream_directly)
+            {
+                std::cout.flush();
+                out.Flush();
+            }
+            std::cerr << "elfreader: " << files[i] << ": read elf failed" << std::endl;
+            failed_num++;
+        }
+    }
+    pool.Wait();
+
+    return failed_num;
+}
+
+// 递归查找 ELF 文件，逐个输出分类信息，最后输出汇总；有根无法访问时返回非 0
+static int run_crawl(const std::vector<std::string> &roots, int jobs)
+{
+    auto begin = std::chrono::steady_clock::now();
+
+    ELFCrawler crawler(jobs);
+    int failed_root_num = crawler.Crawl(roots);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    // key: class, type, machine  value: 文件数, 总大小
+    std::map<std::tuple<unsigned char, uint16_t, uint16_t>, std::pair<long, uint64_t>> summary;
+
+    for (const ELFCrawler::Entry &entry : crawler.GetEntries())
+    {
+        const ELFReader::TriageInfo &info = entry.info;
+        std::cout << ELFReader::GetClassName(info.elf_class) << "\t" << ELFReader::GetTypeName(info.type) << "\t"
+            << ELFReader::GetMachineName(info.machine) << "\t" << info.file_size << "\t" << entry.path << "\n";
+
+        auto &item = summary[std::make_tuple(info.elf_class, info.type, info.machine)];
+        item.first++;
+        item.second += info.file_size;
+    }
+
+    FormattedTable ftable;
+    ftable.SetFieldList({ "Class", "Type", "Machine", "Files", "Total Size" });
+    for (const auto &item : summary)
+    {
+        uint16_t machine = std::get<2>(item.first);
+        std::string machine_name = ELFReader::GetMachineName(machine);
+        if (machine_name == "Unknown")
+        {
+            machine_name = std::to_string(machine);
+        }
+        ftable.AddRow(ELFReader::GetClassName(std::get<0>(item.first)), ELFReader::GetTypeName(std::get<1>(item.first)),
+            machine_name, item.second.first, item.second.second);
+    }
+
+    std::cout << "\nsummary:\n" << ftable.GetFormattedTable() << "\n";
+    std::cout << "scanned " << crawler.GetScannedDirNum() << " dirs, " << crawler.GetScannedFileNum() << " files, found "
+        << crawler.GetEntries().size() << " elf files in " << seconds << " s" << std::endl;
+    return failed_root_num > 0 ? -1 : 0;
+}
+
+// 符号化进程中的地址：给了 -A 时逐个输出，否则把标准输入每一行中落在文件映射内的十六进制地址替换为符号化结果（如逐行的调用栈），
+// 地址前后的标点（逗号、括号等）原样保留。
+// 模块在第一次用到时解析，之后所有地址共用
+static int run_symbolize(const Options &options)
+{
+    ProcessSymbolizer symbolizer;
+    if (!symbolizer.LoadMaps(options.pid))
+    {
+        return -1;
+    }
+
+    std::unique_ptr<Demangler> demangler;
+    if (options.demangle)
+    {
+        demangler.reset(new Demangler);
+        symbolizer.SetDemangler(demangler.get());
+    }
+
+    std::string out;
+    size_t addr_num = 0;
+    if (!options.addrs.empty())
+    {
+        char buffer[NUMBER_MAX_LEN];
+        for (uint64_t addr : options.addrs)
+        {
+            out.append(buffer, NumberFormat::FormatHex(buffer, addr));
+            out += ' ';
+            symbolizer.Format(symbolizer.Symbolize(addr), out);
+            out += '\n';
+            addr_num++;
+        }
+        std::cout << out;
+    }
+    else
+    {
+        std::string line;
+        while (std::getline(std::cin, line))
+        {
+            out.clear();
+            // 按词扫描：词是字母、数字、下划线组成的连续串，整个词是十六进制数（可带 0x）时才尝试符号化，
+            // 这样 "0x7f...,"、"[0x7f...]" 中的地址也能替换，标点原样保留，而 "abc123" 这样的词不会被拆开
+            auto is_word_char = [](char c) { return isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+            size_t pos = 0;
+            while (pos < line.size())
+            {
+                size_t begin = pos;
+                while (pos < line.size() && !is_word_char(line[pos]))
+                {
+                    pos++;
+                }
+                out.append(line, begin, pos - begin);
+
+                begin = pos;
+                while (pos < line.size() && is_word_char(line[pos]))
+                {
+                    pos++;
+                }
+                if (begin == pos)
+                {
+                    break;
+                }
+
+                size_t digits = begin;
+                if (pos - begin > 2 && line[begin] == '0' && (line[begin + 1] == 'x' || line[begin + 1] == 'X'))
+                {
+                    digits += 2;
+                }
+                bool is_hex = pos - digits <= 16;
+                for (size_t i = digits; is_hex && i < pos; i++)
+                {
+                    is_hex = isxdigit(static_cast<unsigned char>(line[i]));
+                }
+
+                // 只替换落在某个文件映射中的地址，其余的词（普通数字、日志文本等）原样保留
+                ProcessSymbolizer::Frame frame;
+                if (is_hex)
+                {
+                    frame = symbolizer.Symbolize(strtoull(line.c_str() + digits, nullptr, 16));
+                }
+                if (!frame.module.empty())
+                {
+                    symbolizer.Format(frame, out);
+                    addr_num++;
+                }
+                else
+                {
+                    out.append(line, begin, pos - begin);
+                }
+            }
+            out += '\n';
+            std::cout << out;
+        }
+    }
+
+    std::cout.flush();
+    std::cerr << "symbolized " << addr_num << " addresses in " << symbolizer.GetMappingNum() << " mappings, parsed "
+        << symbolizer.GetParsedModuleNum() << " of " << symbolizer.GetModuleNum() << " modules" << std::endl;
+    return 0;
+}
+
+// 批量符号化一个文件中的地址，按块处理，最后在 stderr 输出吞吐
+static int run_addr2sym(const Options &options)
+{
+    const char *path = options.files[0].c_str();
+    ELFReader reader;
+    SymbolIndex index;
+    if (!options.cache_dir.empty())
+    {
+        ELFCache cache(options.cache_dir);
+        if (!cache.Open(path, reader, &index))
+        {
+            return -1;
+        }
+    }
     else
+    {
+        if (!read_elf(path, reader))
+        {
+            return -1;
+        }
+        index.Build(reader);
+    }
+
+    int fd = STDIN_FILENO;
+    if (!options.input.empty())
+    {
+        fd = open(options.input.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            std::cerr << "run_addr2sym: can not open " << options.input << std::endl;
+            return -1;
+        }
+    }
+
+    std::unique_ptr<Demangler> demangler;
+    LineIndex line_index(reader);
+    FdWriter out(STDOUT_FILENO);
+    BatchSymbolizer symbolizer(index, out);
+    if (line_index.HasLineInfo())
+    {
+        symbolizer.SetLineIndex(&line_index);
+    }
+    if (options.demangle)
+    {
+        demangler.reset(new Demangler);
+        symbolizer.SetDemangler(demangler.get());
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    bool ok = symbolizer.Run(fd);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    if (fd != STDIN_FILENO)
+    {
+        close(fd);
+    }
+
+    std::cerr << "symbolized " << symbolizer.GetAddressNum() << " addresses (" << symbolizer.GetUniqueNum()
+        << " unique within " << symbolizer.GetChunkNum() << " chunks) in " << seconds << " s, "
+        << static_cast<uint64_t>(seconds > 0 ? symbolizer.GetAddressNum() / seconds : 0) << " addresses/s";
+    if (line_index.HasLineInfo())
+    {
+        std::cerr << ", decoded " << line_index.GetDecodedUnitNum() << " of " << line_index.GetUnitNum()
+            << " line programs (" << line_index.GetRowNum() << " rows)";
+    }
+    std::cerr << std::endl;
+    return ok && !out.Failed() ? 0 : -1;
+}
+
+// 解析各文件的传递依赖，输出装载顺序或 DOT/JSON 图，统计信息输出到 stderr
+static int run_deps(const Options &options)
+{
+    auto begin = std::chrono::steady_clock::now();
+
+    DependencyResolver resolver(options.jobs);
+    resolver.Resolve(options.files);
+
+    std::string out;
+    if (options.graph == "dot")
+    {
+        resolver.FormatDot(out);
+    }
+    else if (options.graph == "json")
+    {
+        resolver.FormatJson(out);
+    }
+    else
+    {
+        resolver.FormatText(out);
+    }
+    std::cout << out;
+    std::cout.flush();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    int failed_num = 0;
+    for (const DependencyResolver::Root &root : resolver.GetRoots())
+    {
+        if (!root.ok)
+        {
+            std::cerr << "elfreader: " << root.path << ": not an ELF object" << std::endl;
+            failed_num++;
+        }
+    }
+    std::cerr << "resolved " << resolver.GetRoots().size() << " files, " << resolver.GetLibraryNum()
+        << " distinct libraries (read " << resolver.GetParsedFileNum() << " elf files, probed "
+        << resolver.GetProbedPathNum() << " paths) in " << seconds << " s" << std::endl;
+    return failed_num;
+}
+
+// 比较两个文件的结构，输出按增长排序的摘要
+static int run_diff(const Options &options)
+{
+    ELFReader old_reader, new_reader;
+    if (!read_elf(options.files[0].c_str(), old_reader) || !read_elf(options.files[1].c_str(), new_reader))
+    {
+        return -1;
+    }
+
+    std::unique_ptr<Demangler> demangler;
+    ELFDiff diff(old_reader, new_reader);
+    if (options.demangle)
+    {
+        demangler.reset(new Demangler);
+        diff.SetDemangler(demangler.get());
+    }
+
+    std::cout << "--- " << options.files[0] << "\n+++ " << options.files[1] << "\n\n";
+    diff.Print(std::cout, options.top);
+    return 0;
+}
+
+static bool parse_args(int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc)
+        {
+            options.jobs = atoi(argv[++i]);
+        }
+        else if (arg.compare(0, 2, "-j") == 0 && arg.size() > 2)
+        {
+            options.jobs = atoi(arg.c_str() + 2);
+        }
+        else if (arg == "--cache-dir" && i + 1 < argc)
+        {
+            options.cache_dir = argv[++i];
+        }
+        else if (arg.compare(0, 9, "--format=") == 0 || (arg == "--format" && i + 1 < argc))
+        {
+            std::string name = arg == "--format" ? argv[++i] : arg.substr(9);
+            if (!StructuredPrinter::ParseFormat(name, options.format))
+            {
+                std::cerr << "parse_args: unknown format " << name << std::endl;
+                return false;
+            }
+            options.structured = true;
+        }
+        else if (arg == "-C")
+        {
+            options.demangle = true;
+        }
+        else if (arg == "--async-io")
+        {
+            options.async_io = true;
+        }
+        else if (arg.compare(0, 8, "--graph=") == 0 || (arg == "--graph" && i + 1 < argc))
+        {
+            options.graph = arg == "--graph" ? argv[++i] : arg.substr(8);
+            if (options.graph != "dot" && options.graph != "json")
+            {
+                std::cerr << "parse_args: unknown graph format " << options.graph << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--top" && i + 1 < argc)
+        {
+            options.top = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--input" && i + 1 < argc)
+        {
+            options.input = argv[++i];
+        }
+        else if (arg == "--pid" && i + 1 < argc)
+        {
+            options.pid = atoi(argv[++i]);
+            if (options.pid <= 0)
+            {
+                std::cerr << "parse_args: invalid pid " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--type" && i + 1 < argc)
+        {
+            if (!SymbolFilter::ParseType(argv[++i], options.symbol_filter.type))
+            {
+                std::cerr << "parse_args: invalid symbol type " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--bind" && i + 1 < argc)
+        {
+            if (!SymbolFilter::ParseBind(argv[++i], options.symbol_filter.bind))
+            {
+                std::cerr << "parse_args: invalid symbol bind " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--section" && i + 1 < argc)
+        {
+            options.symbol_filter.section = argv[++i];
+        }
+        else if (arg == "--min-size" && i + 1 < argc)
+        {
+            options.symbol_filter.min_size = strtoull(argv[++i], nullptr, 0);
+        }
+        else if (options.opt.empty())
+        {
+            options.opt = arg;
+            if (arg == "-A" && (i + 1 >= argc || !parse_addrs(argv[++i], options.addrs)))
+            {
+                return false;
+            }
+        }
+        else if (!collect_files(arg, options.files))
+        {
+            return false;
+        }
+    }
+
+    if (options.pid > 0)
+    {
+        // 符号化进程地址时不接受文件参数
+        return options.files.empty() && (options.opt.empty() || options.opt == "-A");
+    }
+    return !options.files.empty() && options.jobs >= 1;
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parse_args(argc, argv, options))
+    {
+        print_help(argv);
+        exit(-1);
+    }
+
+    if (options.pid > 0)
+    {
+        if (run_symbolize(options) != 0)
+        {
+            exit(-1);
+        }
+        return 0;
+    }
+
+    if (options.opt == "--addr2sym")
+    {
+        if (options.files.size() != 1)
+        {
+            print_help(argv);
+            exit(-1);
+        }
+        if (run_addr2sym(options) != 0)
+        {
+            exit(-1);
+        }
+        return 0;
+    }
+
+    if (options.opt == "--diff")
+    {
+        if (options.files.size() != 2)
+        {
+            print_help(argv);
+            exit(-1);
+        }
+        if (run_diff(options) != 0)
+        {
+            exit(-1);
+        }
+        return 0;
+    }
+
+    if (options.opt == "--deps")
+    {
+        if (run_deps(options) != 0)
+        {
+            exit(-1);
+        }
+        return 0;
+    }
+
+    if (options.opt == "--crawl")
+    {
+        if (run_crawl(options.files, options.jobs) != 0)
+        {
+            exit(-1);
+        }
+        return 0;
+    }
+
+    if (!is_print_option(options.opt))
     {
         print_help(argv);
+        exit(-1);
+    }
+
+    // 结构化输出只支持各表；csv 每行列数固定，一次只能输出一种表
+    if (options.structured && (options.opt == "-A" || options.opt == "-H" || options.opt == "--startup" ||
+        (options.format == StructuredPrinter::FORMAT_CSV && options.opt == "-a")))
+    {
+        std::cerr << "elfreader: --format does not support " << options.opt << std::endl;
+        exit(-1);
+    }
+
+    if (run_batch(options) != 0)
+    {
+        exit(-1);
     }
 
     return 0;
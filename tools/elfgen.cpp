@@ -0,0 +1,491 @@
+// 生成合成的 x86_64 ELF64 共享库，用于扩展性测试与基准测试。
+// 各类表的规模可配置，生成的文件可以被 ELFReader 正常解析。代码段内容为空洞（稀疏文件），不占磁盘空间。
+//
+// 用法：elfgen [options] -o <output>
+//   --sections N      .text 段个数（N>1 时命名为 .text.0 .text.1 ...，类似 -ffunction-sections）
+//   --symbols N       .symtab 中的函数符号数（其中约 1/4 为 LOCAL）
+//   --dynsyms N       .dynsym 中导出的函数符号数（同时生成 .hash）
+//   --name-len N      符号名长度
+//   --mangled         符号名使用 C++ 修饰名（_ZN3gen...Ev）
+//   --relocs N        .rela.dyn 条目数（RELATIVE / GLOB_DAT / 64 各占一部分）
+//   --plt-relocs N    .rela.plt 条目数（JUMP_SLOT）
+//   --text-relocs N   .rela.text* 条目数，每个 .text 段一个重定位段，引用 .symtab
+//   --needed N        DT_NEEDED 个数
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+
+#include <elf.h>
+
+struct GenOptions
+{
+    long sections = 1;
+    long symbols = 1000;
+    long dynsyms = 100;
+    long name_len = 16;
+    bool mangled = false;
+    long relocs = 1000;
+    long plt_relocs = 100;
+    long text_relocs = 0;
+    long needed = 2;
+    std::string output;
+};
+
+// 构建中的段
+struct GenSection
+{
+    std::string name;
+    Elf64_Shdr header {};
+    std::string data;       // 文件内容，NOBITS 或空洞段为空
+    uint64_t hole_size = 0; // 不写内容、只占地址与文件偏移的大小（稀疏）
+};
+
+class StrTab
+{
+public:
+    StrTab() : m_data(1, '\0') {}
+
+    uint32_t Add(const std::string &s)
+    {
+        uint32_t offset = static_cast<uint32_t>(m_data.size());
+        m_data += s;
+        m_data += '\0';
+        return offset;
+    }
+
+    const std::string &Data() const { return m_data; }
+
+private:
+    std::string m_data;
+};
+
+static std::string MakeName(const char *prefix, long index, const GenOptions &options)
+{
+    std::string id = prefix + std::to_string(index);
+    if (options.mangled)
+    {
+        // _ZN3gen<len><id>Ev，用 id 的填充达到指定长度
+        long pad = options.name_len - static_cast<long>(id.size()) - 11;
+        if (pad > 0) id += std::string(pad, 'x');
+        return "_ZN3gen" + std::to_string(id.size()) + id + "Ev";
+    }
+
+    if (static_cast<long>(id.size()) < options.name_len)
+    {
+        id += std::string(options.name_len - id.size(), 'x');
+    }
+    return id;
+}
+
+template <typename T>
+static void Append(std::string &data, const T &value)
+{
+    data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static uint32_t SysvHash(const char *name)
+{
+    uint32_t h = 0;
+    for (const unsigned char *p = reinterpret_cast<const unsigned char*>(name); *p != '\0'; p++)
+    {
+        h = (h << 4) + *p;
+        uint32_t g = h & 0xf0000000;
+        if (g != 0) h ^= g >> 24;
+        h &= ~g;
+    }
+    return h;
+}
+
+static bool ParseArgs(int argc, char *argv[], GenOptions &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        auto next_num = [&](long &value)
+        {
+            if (i + 1 >= argc) return false;
+            value = atol(argv[++i]);
+            return value >= 0;
+        };
+
+        bool ok = true;
+        if (arg == "--sections") ok = next_num(options.sections) && options.sections >= 1;
+        else if (arg == "--symbols") ok = next_num(options.symbols);
+        else if (arg == "--dynsyms") ok = next_num(options.dynsyms);
+        else if (arg == "--name-len") ok = next_num(options.name_len);
+        else if (arg == "--mangled") options.mangled = true;
+        else if (arg == "--relocs") ok = next_num(options.relocs);
+        else if (arg == "--plt-relocs") ok = next_num(options.plt_relocs);
+        else if (arg == "--text-relocs") ok = next_num(options.text_relocs);
+        else if (arg == "--needed") ok = next_num(options.needed);
+        else if (arg == "-o" && i + 1 < argc) options.output = argv[++i];
+        else ok = false;
+
+        if (!ok)
+        {
+            return false;
+        }
+    }
+    return !options.output.empty();
+}
+
+int main(int argc, char *argv[])
+{
+    GenOptions options;
+    if (!ParseArgs(argc, argv, options))
+    {
+        std::cerr << "usage: " << argv[0] << " [--sections N] [--symbols N] [--dynsyms N] [--name-len N] [--mangled]"
+            " [--relocs N] [--plt-relocs N] [--text-relocs N] [--needed N] -o <output>" << std::endl;
+        return -1;
+    }
+
+    const uint64_t FUNC_SIZE = 16;
+    const long text_num = options.sections;
+
+    // 段的下标固定如下，.text 段放在最后
+    enum
+    {
+        SEC_NULL, SEC_DYNSYM, SEC_DYNSTR, SEC_HASH, SEC_RELA_DYN, SEC_RELA_PLT, SEC_DYNAMIC,
+        SEC_SYMTAB, SEC_STRTAB, SEC_SHSTRTAB, SEC_TEXT_BEGIN
+    };
+    const long rela_text_begin = SEC_TEXT_BEGIN + text_num;
+    const long section_num = rela_text_begin + (options.text_relocs > 0 ? text_num : 0);
+
+    std::vector<GenSection> sections(section_num);
+    sections[SEC_DYNSYM].name = ".dynsym";
+    sections[SEC_DYNSTR].name = ".dynstr";
+    sections[SEC_HASH].name = ".hash";
+    sections[SEC_RELA_DYN].name = ".rela.dyn";
+    sections[SEC_RELA_PLT].name = ".rela.plt";
+    sections[SEC_DYNAMIC].name = ".dynamic";
+    sections[SEC_SYMTAB].name = ".symtab";
+    sections[SEC_STRTAB].name = ".strtab";
+    sections[SEC_SHSTRTAB].name = ".shstrtab";
+
+    // 每个 .text 段容纳若干个函数
+    const long symbols_per_text = (std::max(options.symbols, options.dynsyms) + text_num - 1) / text_num + 1;
+    for (long i = 0; i < text_num; i++)
+    {
+        GenSection &text = sections[SEC_TEXT_BEGIN + i];
+        text.name = text_num == 1 ? std::string(".text") : ".text." + std::to_string(i);
+        text.header.sh_type = SHT_PROGBITS;
+        text.header.sh_flags = SHF_ALLOC | SHF_EXECINSTR;
+        text.header.sh_addralign = 16;
+        text.hole_size = symbols_per_text * FUNC_SIZE;
+    }
+
+    // 函数 k 位于第 k % text_num 个 .text 段，段内第 k / text_num 个位置；地址在排布后才确定，先记相对位置
+    auto func_section = [text_num](long k) { return SEC_TEXT_BEGIN + k % text_num; };
+    auto func_offset = [text_num, FUNC_SIZE](long k) { return (k / text_num) * FUNC_SIZE; };
+
+    // .dynsym / .dynstr / .hash
+    StrTab dynstr;
+    std::vector<uint32_t> dynsym_names(options.dynsyms + 1, 0);
+    std::vector<std::string> needed_names;
+    for (long i = 0; i < options.needed; i++)
+    {
+        needed_names.push_back("libgen" + std::to_string(i) + ".so");
+    }
+    std::vector<uint32_t> needed_offsets;
+    for (const std::string &name : needed_names)
+    {
+        needed_offsets.push_back(dynstr.Add(name));
+    }
+    uint32_t soname_offset = dynstr.Add("libsynthetic.so");
+
+    std::vector<std::string> dyn_names(options.dynsyms + 1);
+    for (long i = 1; i <= options.dynsyms; i++)
+    {
+        dyn_names[i] = MakeName("dyn_func_", i, options);
+        dynsym_names[i] = dynstr.Add(dyn_names[i]);
+    }
+
+    // .symtab / .strtab：LOCAL 在前
+    StrTab strtab;
+    const long local_num = options.symbols / 4;
+    std::vector<uint32_t> sym_names(options.symbols + 1, 0);
+    for (long i = 1; i <= options.symbols; i++)
+    {
+        sym_names[i] = strtab.Add(MakeName(i <= local_num ? "local_func_" : "func_", i, options));
+    }
+
+    // 段的偏移与地址：ELF 头、程序头之后依次排布，地址等于文件偏移，整个文件是一个 PT_LOAD
+    const uint64_t phdr_num = 2;
+    uint64_t offset = sizeof(Elf64_Ehdr) + phdr_num * sizeof(Elf64_Phdr);
+
+    auto set_table = [&](long index, Elf64_Word type, uint64_t flags, uint64_t entsize, uint64_t align, uint64_t size)
+    {
+        GenSection &section = sections[index];
+        section.header.sh_type = type;
+        section.header.sh_flags = flags;
+        section.header.sh_entsize = entsize;
+        section.header.sh_addralign = align;
+        section.header.sh_size = size;
+    };
+
+    const long rela_dyn_num = options.relocs;
+    const long rela_plt_num = options.plt_relocs;
+    const long dynamic_num = options.needed + 14;
+    const uint32_t nbucket = static_cast<uint32_t>(options.dynsyms / 2 + 1);
+
+    set_table(SEC_DYNSYM, SHT_DYNSYM, SHF_ALLOC, sizeof(Elf64_Sym), 8, (options.dynsyms + 1) * sizeof(Elf64_Sym));
+    set_table(SEC_DYNSTR, SHT_STRTAB, SHF_ALLOC, 0, 1, dynstr.Data().size());
+    set_table(SEC_HASH, SHT_HASH, SHF_ALLOC, 4, 8, (2 + nbucket + options.dynsyms + 1) * sizeof(uint32_t));
+    set_table(SEC_RELA_DYN, SHT_RELA, SHF_ALLOC, sizeof(Elf64_Rela), 8, rela_dyn_num * sizeof(Elf64_Rela));
+    set_table(SEC_RELA_PLT, SHT_RELA, SHF_ALLOC | SHF_INFO_LINK, sizeof(Elf64_Rela), 8, rela_plt_num * sizeof(Elf64_Rela));
+    set_table(SEC_DYNAMIC, SHT_DYNAMIC, SHF_ALLOC | SHF_WRITE, sizeof(Elf64_Dyn), 8, dynamic_num * sizeof(Elf64_Dyn));
+    set_table(SEC_SYMTAB, SHT_SYMTAB, 0, sizeof(Elf64_Sym), 8, (options.symbols + 1) * sizeof(Elf64_Sym));
+    set_table(SEC_STRTAB, SHT_STRTAB, 0, 0, 1, strtab.Data().size());
+
+    std::vector<long> text_reloc_num(text_num, 0);
+    for (long i = 0; i < options.text_relocs; i++)
+    {
+        text_reloc_num[i % text_num]++;
+    }
+    for (long i = 0; options.text_relocs > 0 && i < text_num; i++)
+    {
+        GenSection &rela = sections[rela_text_begin + i];
+        rela.name = ".rela" + sections[SEC_TEXT_BEGIN + i].name;
+        set_table(rela_text_begin + i, SHT_RELA, SHF_INFO_LINK, sizeof(Elf64_Rela), 8, text_reloc_num[i] * sizeof(Elf64_Rela));
+        rela.header.sh_link = SEC_SYMTAB;
+        rela.header.sh_info = static_cast<Elf64_Word>(SEC_TEXT_BEGIN + i);
+    }
+
+    // .shstrtab 需要在排布前确定大小
+    StrTab shstrtab;
+    for (GenSection &section : sections)
+    {
+        section.header.sh_name = section.name.empty() ? 0 : shstrtab.Add(section.name);
+    }
+    set_table(SEC_SHSTRTAB, SHT_STRTAB, 0, 0, 1, shstrtab.Data().size());
+    sections[SEC_SHSTRTAB].data = shstrtab.Data();
+
+    for (long i = 1; i < section_num; i++)
+    {
+        GenSection &section = sections[i];
+        uint64_t align = section.header.sh_addralign == 0 ? 1 : section.header.sh_addralign;
+        offset = (offset + align - 1) / align * align;
+        section.header.sh_offset = offset;
+        if (section.header.sh_flags & SHF_ALLOC)
+        {
+            section.header.sh_addr = offset;
+        }
+        if (section.hole_size > 0)
+        {
+            section.header.sh_size = section.hole_size;
+        }
+        offset += section.header.sh_size;
+    }
+    const uint64_t shdr_offset = (offset + 7) / 8 * 8;
+    const uint64_t file_size = shdr_offset + section_num * sizeof(Elf64_Shdr);
+
+    auto func_addr = [&](long k) { return sections[func_section(k)].header.sh_addr + func_offset(k); };
+
+    // 填充各表内容
+    {
+        std::string &data = sections[SEC_DYNSYM].data;
+        Append(data, Elf64_Sym {});
+        for (long i = 1; i <= options.dynsyms; i++)
+        {
+            Elf64_Sym sym {};
+            sym.st_name = dynsym_names[i];
+            sym.st_info = ELF64_ST_INFO(STB_GLOBAL, STT_FUNC);
+            sym.st_shndx = static_cast<Elf64_Section>(func_section(i - 1));
+            sym.st_value = func_addr(i - 1);
+            sym.st_size = FUNC_SIZE;
+            Append(data, sym);
+        }
+        sections[SEC_DYNSYM].header.sh_link = SEC_DYNSTR;
+        sections[SEC_DYNSYM].header.sh_info = 1;
+    }
+    sections[SEC_DYNSTR].data = dynstr.Data();
+    {
+        std::vector<uint32_t> buckets(nbucket, 0);
+        std::vector<uint32_t> chains(options.dynsyms + 1, 0);
+        for (long i = options.dynsyms; i >= 1; i--)
+        {
+            uint32_t b = SysvHash(dyn_names[i].c_str()) % nbucket;
+            chains[i] = buckets[b];
+            buckets[b] = static_cast<uint32_t>(i);
+        }
+
+        std::string &data = sections[SEC_HASH].data;
+        Append(data, nbucket);
+        Append(data, static_cast<uint32_t>(chains.size()));
+        data.append(reinterpret_cast<const char*>(buckets.data()), buckets.size() * sizeof(uint32_t));
+        data.append(reinterpret_cast<const char*>(chains.data()), chains.size() * sizeof(uint32_t));
+        sections[SEC_HASH].header.sh_link = SEC_DYNSYM;
+    }
+    {
+        // 重定位的目标放在 .dynamic 之后的区域里无所谓真实性，只要偏移互不相同
+        std::string &data = sections[SEC_RELA_DYN].data;
+        for (long i = 0; i < rela_dyn_num; i++)
+        {
+            Elf64_Rela rela {};
+            rela.r_offset = 0x100000 + i * 8;
+            long kind = i % 4;
+            if (kind < 2 || options.dynsyms == 0)
+            {
+                rela.r_info = ELF64_R_INFO(0, R_X86_64_RELATIVE);
+                rela.r_addend = func_addr(i % std::max(options.symbols, 1L));
+            }
+            else
+            {
+                long sym = i % options.dynsyms + 1;
+                rela.r_info = ELF64_R_INFO(sym, kind == 2 ? R_X86_64_GLOB_DAT : R_X86_64_64);
+            }
+            Append(data, rela);
+        }
+        sections[SEC_RELA_DYN].header.sh_link = SEC_DYNSYM;
+    }
+    {
+        std::string &data = sections[SEC_RELA_PLT].data;
+        for (long i = 0; i < rela_plt_num; i++)
+        {
+            Elf64_Rela rela {};
+            rela.r_offset = 0x200000 + i * 8;
+            rela.r_info = ELF64_R_INFO(options.dynsyms == 0 ? 0 : i % options.dynsyms + 1, R_X86_64_JUMP_SLOT);
+            Append(data, rela);
+        }
+        sections[SEC_RELA_PLT].header.sh_link = SEC_DYNSYM;
+    }
+    {
+        std::string &data = sections[SEC_DYNAMIC].data;
+        auto add = [&data](Elf64_Sxword tag, uint64_t value)
+        {
+            Elf64_Dyn dyn {};
+            dyn.d_tag = tag;
+            dyn.d_un.d_val = value;
+            Append(data, dyn);
+        };
+        for (uint32_t needed : needed_offsets)
+        {
+            add(DT_NEEDED, needed);
+        }
+        add(DT_SONAME, soname_offset);
+        add(DT_HASH, sections[SEC_HASH].header.sh_addr);
+        add(DT_STRTAB, sections[SEC_DYNSTR].header.sh_addr);
+        add(DT_SYMTAB, sections[SEC_DYNSYM].header.sh_addr);
+        add(DT_STRSZ, sections[SEC_DYNSTR].header.sh_size);
+        add(DT_SYMENT, sizeof(Elf64_Sym));
+        add(DT_RELA, sections[SEC_RELA_DYN].header.sh_addr);
+        add(DT_RELASZ, sections[SEC_RELA_DYN].header.sh_size);
+        add(DT_RELAENT, sizeof(Elf64_Rela));
+        add(DT_JMPREL, sections[SEC_RELA_PLT].header.sh_addr);
+        add(DT_PLTRELSZ, sections[SEC_RELA_PLT].header.sh_size);
+        add(DT_PLTREL, DT_RELA);
+        add(DT_NULL, 0);
+        add(DT_NULL, 0);
+        sections[SEC_DYNAMIC].header.sh_link = SEC_DYNSTR;
+    }
+    {
+        std::string &data = sections[SEC_SYMTAB].data;
+        Append(data, Elf64_Sym {});
+        for (long i = 1; i <= options.symbols; i++)
+        {
+            Elf64_Sym sym {};
+            sym.st_name = sym_names[i];
+            sym.st_info = ELF64_ST_INFO(i <= local_num ? STB_LOCAL : STB_GLOBAL, STT_FUNC);
+            sym.st_shndx = static_cast<Elf64_Section>(func_section(i - 1));
+            sym.st_value = func_addr(i - 1);
+            sym.st_size = FUNC_SIZE;
+            Append(data, sym);
+        }
+        sections[SEC_SYMTAB].header.sh_link = SEC_STRTAB;
+        sections[SEC_SYMTAB].header.sh_info = static_cast<Elf64_Word>(local_num + 1);
+    }
+    sections[SEC_STRTAB].data = strtab.Data();
+    for (long i = 0; options.text_relocs > 0 && i < text_num; i++)
+    {
+        std::string &data = sections[rela_text_begin + i].data;
+        for (long j = 0; j < text_reloc_num[i]; j++)
+        {
+            Elf64_Rela rela {};
+            rela.r_offset = (j * 8) % (symbols_per_text * FUNC_SIZE);
+            rela.r_info = ELF64_R_INFO(options.symbols == 0 ? 0 : (i + j * text_num) % options.symbols + 1,
+                j % 2 == 0 ? R_X86_64_PC32 : R_X86_64_64);
+            rela.r_addend = -4;
+            Append(data, rela);
+        }
+    }
+
+    FILE *fp = fopen(options.output.c_str(), "wb");
+    if (fp == nullptr)
+    {
+        perror("elfgen fopen");
+        return -1;
+    }
+
+    Elf64_Ehdr ehdr {};
+    memcpy(ehdr.e_ident, ELFMAG, SELFMAG);
+    ehdr.e_ident[EI_CLASS] = ELFCLASS64;
+    ehdr.e_ident[EI_DATA] = ELFDATA2LSB;
+    ehdr.e_ident[EI_VERSION] = EV_CURRENT;
+    ehdr.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+    ehdr.e_type = ET_DYN;
+    ehdr.e_machine = EM_X86_64;
+    ehdr.e_version = EV_CURRENT;
+    ehdr.e_phoff = sizeof(Elf64_Ehdr);
+    ehdr.e_shoff = shdr_offset;
+    ehdr.e_ehsize = sizeof(Elf64_Ehdr);
+    ehdr.e_phentsize = sizeof(Elf64_Phdr);
+    ehdr.e_phnum = phdr_num;
+    ehdr.e_shentsize = sizeof(Elf64_Shdr);
+    ehdr.e_shnum = static_cast<Elf64_Half>(section_num < SHN_LORESERVE ? section_num : 0);
+    ehdr.e_shstrndx = SEC_SHSTRTAB;
+    if (section_num >= SHN_LORESERVE)
+    {
+        // 段数过多时真实个数放在 0 号段的 sh_size 中
+        sections[0].header.sh_size = section_num;
+        std::cerr << "elfgen: warning: " << section_num << " sections need extended numbering, which ELFReader does not read" << std::endl;
+    }
+
+    Elf64_Phdr phdrs[phdr_num] {};
+    phdrs[0].p_type = PT_LOAD;
+    phdrs[0].p_flags = PF_R | PF_X;
+    phdrs[0].p_offset = 0;
+    phdrs[0].p_vaddr = 0;
+    phdrs[0].p_paddr = 0;
+    phdrs[0].p_filesz = shdr_offset;
+    phdrs[0].p_memsz = shdr_offset;
+    phdrs[0].p_align = 0x1000;
+    phdrs[1].p_type = PT_DYNAMIC;
+    phdrs[1].p_flags = PF_R | PF_W;
+    phdrs[1].p_offset = sections[SEC_DYNAMIC].header.sh_offset;
+    phdrs[1].p_vaddr = sections[SEC_DYNAMIC].header.sh_addr;
+    phdrs[1].p_paddr = sections[SEC_DYNAMIC].header.sh_addr;
+    phdrs[1].p_filesz = sections[SEC_DYNAMIC].header.sh_size;
+    phdrs[1].p_memsz = sections[SEC_DYNAMIC].header.sh_size;
+    phdrs[1].p_align = 8;
+
+    bool ok = fwrite(&ehdr, sizeof(ehdr), 1, fp) == 1 && fwrite(phdrs, sizeof(phdrs), 1, fp) == 1;
+    for (long i = 1; ok && i < section_num; i++)
+    {
+        const GenSection &section = sections[i];
+        // 有内容的段写内容，空洞段只移动文件位置
+        ok = fseek(fp, section.header.sh_offset, SEEK_SET) == 0 &&
+            (section.data.empty() || fwrite(section.data.data(), section.data.size(), 1, fp) == 1);
+    }
+    ok = ok && fseek(fp, shdr_offset, SEEK_SET) == 0;
+    for (long i = 0; ok && i < section_num; i++)
+    {
+        ok = fwrite(&sections[i].header, sizeof(Elf64_Shdr), 1, fp) == 1;
+    }
+
+    if (fclose(fp) != 0 || !ok)
+    {
+        perror("elfgen write");
+        return -1;
+    }
+
+    std::cerr << "elfgen: wrote " << options.output << " (" << file_size << " bytes, " << section_num << " sections, "
+        << options.symbols << " symbols, " << options.dynsyms << " dynsyms, "
+        << options.relocs + options.plt_relocs + options.text_relocs << " relocations)" << std::endl;
+    return 0;
+}